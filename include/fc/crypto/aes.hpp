@@ -4,10 +4,14 @@
 #include <fc/crypto/sha256.hpp>
 #include <fc/uint128_t.hpp>
 #include <fc/fwd.hpp>
+#include <memory>
 #include <vector>
 
 namespace fc {
     class path;
+    class istream;
+    class ostream;
+    class worker_pool;
 
     class aes_encoder {
     public:
@@ -64,4 +68,79 @@ namespace fc {
      */
     std::vector<char> aes_load(const fc::path &file, const fc::sha512 &key);
 
+    /// AES-256 modes of aes_stream_encoder and aes_stream_decoder
+    enum aes_stream_mode {
+        aes_cbc, ///< PKCS#7 padded, as aes_encrypt()
+        aes_ctr,
+        aes_gcm  ///< authenticated, the cipher text is followed by a 16 byte tag
+    };
+
+    /**
+     *  Encrypts streams too large to be held in memory, such as wallet backups.  The input is
+     *  processed buffer_size bytes at a time with two sets of buffers: while one buffer is
+     *  encrypted on a thread of <code>pool</code> (the default fc::worker_pool if null) the calling
+     *  thread writes out the previous one and reads the next.  The cipher context is kept and
+     *  reused by every encode().
+     */
+    class aes_stream_encoder {
+    public:
+        explicit aes_stream_encoder(aes_stream_mode mode = aes_gcm, size_t buffer_size = 1 << 20,
+                                    worker_pool *pool = nullptr);
+
+        ~aes_stream_encoder();
+
+        /**
+         *  Encrypts everything read from in until it ends into out.  With aes_gcm the tag also
+         *  covers aad, the other modes take no aad.  An iv must never be used twice with the same
+         *  key in aes_ctr and aes_gcm mode.
+         *
+         *  @return number of bytes written to out
+         */
+        uint64_t encode(istream &in, ostream &out, const fc::sha256 &key, const fc::uint128_t &iv,
+                        const std::vector<char> &aad = std::vector<char>());
+
+    private:
+        struct impl;
+        std::unique_ptr<impl> my;
+    };
+
+    /**
+     *  Decrypts what aes_stream_encoder wrote, with the same buffering.
+     */
+    class aes_stream_decoder {
+    public:
+        explicit aes_stream_decoder(aes_stream_mode mode = aes_gcm, size_t buffer_size = 1 << 20,
+                                    worker_pool *pool = nullptr);
+
+        ~aes_stream_decoder();
+
+        /**
+         *  Decrypts everything read from in until it ends into out.  With aes_gcm the tag is checked
+         *  once the input has ended and aes_exception is thrown if the cipher text, the key, the iv
+         *  or aad differ from what was encoded; the plain text written to out up to then must be
+         *  discarded.
+         *
+         *  @return number of bytes written to out
+         */
+        uint64_t decode(istream &in, ostream &out, const fc::sha256 &key, const fc::uint128_t &iv,
+                        const std::vector<char> &aad = std::vector<char>());
+
+    private:
+        struct impl;
+        std::unique_ptr<impl> my;
+    };
+
+    /**
+     *  Encrypts everything read from plain_text into file with AES-256-GCM, a buffer at a time.  The
+     *  first 32 bytes of key are the AES key and a random iv is stored in the file header.  Unlike
+     *  aes_save() the whole file is authenticated, so aes_stream_load() detects any change to it.
+     */
+    void aes_stream_save(const fc::path &file, const fc::sha512 &key, istream &plain_text);
+
+    /**
+     *  Decrypts a file written by aes_stream_save() into plain_text.  Throws aes_exception if the
+     *  file was changed or the key is wrong, after the plain text decrypted so far was written.
+     */
+    void aes_stream_load(const fc::path &file, const fc::sha512 &key, ostream &plain_text);
+
 } // namespace fc 
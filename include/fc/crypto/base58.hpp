@@ -8,6 +8,17 @@ namespace fc {
 
     std::string to_base58(const std::vector<char> &data);
 
+    /// upper bound of the length of the base58 encoding of <code>s</code> bytes
+    inline size_t base58_max_size(size_t s) {
+        return s * 138 / 100 + 1;
+    }
+
+    /**
+     *  Encodes into <code>out_data</code> without allocating for inputs of up to 128 bytes.
+     *  @return the number of characters written, the string is not null terminated
+     */
+    size_t to_base58(const char *d, size_t s, char *out_data, size_t out_data_len);
+
     std::vector<char> from_base58(const std::string &base58_str);
 
     size_t from_base58(const std::string &base58_str, char *out_data, size_t out_data_len);
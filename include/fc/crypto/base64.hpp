@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace fc {
@@ -12,4 +13,30 @@ namespace fc {
     std::string base64_encode(const std::string &enc);
 
     std::string base64_decode(const std::string &encoded_string);
+
+    /// length of the padded encoding of in_len bytes
+    inline size_t base64_encoded_size(size_t in_len) {
+        return (in_len + 2) / 3 * 4;
+    }
+
+    /// largest number of bytes in_len characters decode to
+    inline size_t base64_decoded_max_size(size_t in_len) {
+        return in_len / 4 * 3 + in_len % 4 * 3 / 4;
+    }
+
+    /**
+     *  Writes the base64_encoded_size(in_len) characters of the padded encoding to out,
+     *  without a terminating null.
+     *  @return the number of characters written
+     */
+    size_t base64_encode(const char *in, size_t in_len, char *out);
+
+    /**
+     *  Decodes into out, which needs room for base64_decoded_max_size(in_len) bytes.  Like
+     *  base64_decode(const std::string&) it stops at the first '=' or other character outside
+     *  the alphabet; consumed, if given, receives the number of characters decoded, so callers
+     *  can reject anything but padding after them.
+     *  @return the number of bytes written
+     */
+    size_t base64_decode(const char *in, size_t in_len, char *out, size_t *consumed = nullptr);
 }  // namespace fc
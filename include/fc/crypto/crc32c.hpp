@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fc {
+    /**
+     *  CRC-32C (Castagnoli, as used by iSCSI and SCTP) of <code>len</code> bytes.  Passing
+     *  the result of a previous call as <code>crc</code> continues it, so the CRC of a
+     *  message can be computed piecewise.  Runs on the SSE4.2 or ARMv8 CRC instructions
+     *  when the CPU has them, interleaving three streams on large buffers.
+     */
+    uint32_t crc32c(const char *data, size_t len, uint32_t crc = 0);
+
+    /// name of the code path used by crc32c() on this CPU: "sse4.2", "armv8-crc" or "portable"
+    const char *crc32c_implementation();
+}
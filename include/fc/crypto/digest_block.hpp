@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace fc {
+    namespace detail {
+
+        /**
+         *  Fast path shared by the write() and put() of the digest encoders, which keep
+         *  the partial input block and its fill level inline.
+         *
+         *  Integers packed by fc::raw (1, 2, 4 or 8 bytes) are copied into the block
+         *  with a single move when they do not complete it, and true is returned.
+         *  Otherwise nothing is copied and false is returned; the encoder then hands
+         *  the data to its out-of-line write_blocks().  The sizes are dispatched
+         *  explicitly because a variable-length memcpy compiles to "rep movs" here.
+         */
+        template<uint32_t BlockSize>
+        inline bool append_to_digest_block(char (&block)[BlockSize], uint32_t &used, const char *d, uint32_t dlen) {
+            if (dlen >= BlockSize - used) {
+                return false;
+            }
+            char *p = block + used;
+            switch (dlen) {
+                case 1: *p = *d; break;
+                case 2: memcpy(p, d, 2); break;
+                case 4: memcpy(p, d, 4); break;
+                case 8: memcpy(p, d, 8); break;
+                default: return false;
+            }
+            used += dlen;
+            return true;
+        }
+
+    }
+} // fc
@@ -1,19 +1,24 @@
 #pragma once
 
 #include <fc/crypto/bigint.hpp>
+#include <fc/crypto/hmac.hpp>
 #include <fc/crypto/openssl.hpp>
 #include <fc/crypto/sha256.hpp>
 #include <fc/crypto/sha512.hpp>
+#include <fc/exception/exception.hpp>
 #include <fc/fwd.hpp>
 #include <fc/array.hpp>
 #include <fc/io/raw_fwd.hpp>
 
 namespace fc {
+    class worker_pool;
 
     namespace ecc {
         namespace detail {
             class public_key_impl;
 
+            class public_key_point_impl;
+
             class private_key_impl;
         }
 
@@ -99,6 +104,48 @@ namespace fc {
             fc::fwd<detail::public_key_impl, 33> my;
         };
 
+        /**
+         *  @class decompressed_public_key
+         *  @brief a public_key together with its decompressed curve point
+         *
+         *  public_key keeps only the 33 byte compressed key, so add(), child() and
+         *  serialize_ecc_point() decompress it on every call, which costs a field square root
+         *  with libsecp256k1.  Keys used over and over, such as block signing keys, can be kept
+         *  in this form to decompress them once.  With the openssl implementation public_key
+         *  already holds the decoded point and this only forwards to it.
+         */
+        class decompressed_public_key {
+        public:
+            decompressed_public_key();
+
+            explicit decompressed_public_key(const public_key &k);
+
+            decompressed_public_key(const decompressed_public_key &k);
+
+            ~decompressed_public_key();
+
+            decompressed_public_key &operator=(const decompressed_public_key &k);
+
+            const public_key &key() const {
+                return _key;
+            }
+
+            /// the same as key().add(offset)
+            public_key add(const fc::sha256 &offset) const;
+
+            /// the same as key().child(offset)
+            public_key child(const fc::sha256 &offset) const;
+
+            /// the same as key().serialize_ecc_point()
+            public_key_point_data serialize_ecc_point() const;
+
+        private:
+            friend class extended_public_key;
+
+            public_key _key;
+            fc::fwd<detail::public_key_point_impl, 64> _point;
+        };
+
         /**
          *  @class private_key
          *  @brief an elliptic curve private key.
@@ -198,6 +245,11 @@ namespace fc {
             public_key generate_q(int i) const;
 
         private:
+            friend class extended_public_key_deriver;
+
+            extended_public_key derive_rest(const decompressed_public_key &point, const fc::sha512 &hash, int i,
+                                            int fingerprint) const;
+
             sha256 c;
             int child_num, parent_fp;
             uint8_t depth;
@@ -245,8 +297,12 @@ namespace fc {
                                                 const fc::sha256 &hash, int i) const;
 
         private:
+            friend class extended_private_key_deriver;
+
             extended_private_key private_derive_rest(const fc::sha512 &hash, int num) const;
 
+            extended_private_key private_derive_rest(const fc::sha512 &hash, int num, int fingerprint) const;
+
             private_key generate_a(int i) const;
 
             private_key generate_b(int i) const;
@@ -264,6 +320,131 @@ namespace fc {
             uint8_t depth;
         };
 
+        /**
+         *  @brief derives many children of one extended public key, such as the addresses a wallet scans
+         *
+         *  What every child derivation takes from the parent is prepared once: the HMAC-SHA512
+         *  keyed with its chain code, its serialized and decompressed public key and its
+         *  fingerprint.  Each child then costs one HMAC of 37 bytes and one point tweak.  Deriving
+         *  does not change the deriver, so several threads may share one.
+         */
+        class extended_public_key_deriver {
+        public:
+            explicit extended_public_key_deriver(const extended_public_key &parent);
+
+            /// the same as parent.derive_child(i)
+            extended_public_key derive_child(int i) const;
+
+            /**
+             *  Derives the children first, first + 1, ..., first + count - 1, spreading them over
+             *  <code>pool</code> (the default fc::worker_pool if null).  All of them must be normal
+             *  (non-hardened) indexes.
+             *
+             *  @return the children in index order
+             */
+            std::vector<extended_public_key> derive_children(int first, size_t count, worker_pool *pool = nullptr) const;
+
+        private:
+            extended_public_key parent;
+            decompressed_public_key point;
+            public_key_data key;
+            keyed_hmac_sha512 mac;
+            int fingerprint;
+        };
+
+        /**
+         *  @brief derives many children of one extended private key
+         *
+         *  Like extended_public_key_deriver; besides the keyed HMAC the parent's public key, which
+         *  normal children hash and which every child needs for its parent fingerprint, is
+         *  computed once instead of once per child.
+         */
+        class extended_private_key_deriver {
+        public:
+            explicit extended_private_key_deriver(const extended_private_key &parent);
+
+            /// the same as parent.derive_child(i), negative indexes are hardened
+            extended_private_key derive_child(int i) const;
+
+            /**
+             *  Derives the children first, first + 1, ..., first + count - 1, spreading them over
+             *  <code>pool</code> (the default fc::worker_pool if null).
+             *
+             *  @return the children in index order
+             */
+            std::vector<extended_private_key> derive_children(int first, size_t count, worker_pool *pool = nullptr) const;
+
+        private:
+            extended_private_key parent;
+            private_key_secret secret;
+            public_key_data key;
+            keyed_hmac_sha512 mac;
+            int fingerprint;
+        };
+
+        /// a compact signature and the digest it signs
+        typedef std::pair<compact_signature, fc::sha256> signature_digest;
+
+        /**
+         *  @brief outcome of recovering one public key in recover_batch()
+         */
+        struct recovered_key {
+            public_key_data key;
+            fc::exception_ptr error; ///< why recovery failed; key is left empty in that case
+
+            bool valid() const {
+                return !error;
+            }
+        };
+
+        /**
+         *  Recovers the public keys of many compact signatures at once, spreading the work
+         *  over <code>pool</code> (the default fc::worker_pool if null).
+         *
+         *  Each item is checked exactly like public_key(const compact_signature&, const fc::sha256&, bool);
+         *  a failure is reported in the corresponding result and does not affect other items.
+         *
+         *  @return one result per input item, in input order
+         */
+        std::vector<recovered_key> recover_batch(const signature_digest *items, size_t count,
+                                                 bool check_canonical = true, worker_pool *pool = nullptr);
+
+        std::vector<recovered_key> recover_batch(const std::vector<signature_digest> &items,
+                                                 bool check_canonical = true, worker_pool *pool = nullptr);
+
+        /**
+         *  Decompresses many public keys at once, spreading the work over <code>pool</code>
+         *  (the default fc::worker_pool if null).  Throws if a key is not a valid point.
+         *
+         *  @return one key per input, in input order
+         */
+        std::vector<decompressed_public_key> decompress_batch(const public_key_data *keys, size_t count,
+                                                              worker_pool *pool = nullptr);
+
+        std::vector<decompressed_public_key> decompress_batch(const std::vector<public_key_data> &keys,
+                                                              worker_pool *pool = nullptr);
+
+        /**
+         *  Signs <code>digests[i]</code> with <code>keys[i]</code> for every i, spreading the work
+         *  over <code>pool</code> (the default fc::worker_pool if null).  Each signature is what
+         *  private_key::sign_compact() returns for the same key and digest, since signing is
+         *  deterministic, so the output does not depend on the number of threads.  If signing
+         *  fails the first failure in input order is rethrown once all items are done.
+         *
+         *  @return one signature per digest, in input order
+         */
+        std::vector<compact_signature> sign_compact_batch(const private_key *keys, const fc::sha256 *digests,
+                                                          size_t count, bool require_canonical = true,
+                                                          worker_pool *pool = nullptr);
+
+        std::vector<compact_signature> sign_compact_batch(const std::vector<private_key> &keys,
+                                                          const std::vector<fc::sha256> &digests,
+                                                          bool require_canonical = true, worker_pool *pool = nullptr);
+
+        /// signs every digest with the same key, such as a block signing key
+        std::vector<compact_signature> sign_compact_batch(const private_key &key, const std::vector<fc::sha256> &digests,
+                                                          bool require_canonical = true, worker_pool *pool = nullptr);
+
         struct range_proof_info {
             int exp;
             int mantissa;
@@ -291,6 +472,45 @@ namespace fc {
 
         range_proof_info range_get_info(const range_proof_type &proof);
 
+        /// a commitment and the range proof for it
+        typedef std::pair<commitment_type, range_proof_type> commitment_range_proof;
+
+        /// commitments and negated commitments that must add up to zero, see verify_sum()
+        typedef std::pair<std::vector<commitment_type>, std::vector<commitment_type>> commitment_sum;
+
+        /**
+         *  @brief outcome of verifying one range proof in verify_range_batch()
+         */
+        struct range_proof_result {
+            bool valid;
+            uint64_t min_value; ///< the proven range, as verify_range() returns it
+            uint64_t max_value;
+        };
+
+        /**
+         *  Verifies many range proofs at once, spreading them over <code>pool</code> (the default
+         *  fc::worker_pool if null).  Each result is what verify_range() returns for the item, except
+         *  that a malformed commitment makes its proof invalid instead of throwing.
+         *
+         *  @return one result per item, in input order
+         */
+        std::vector<range_proof_result> verify_range_batch(const commitment_range_proof *items, size_t count,
+                                                           worker_pool *pool = nullptr);
+
+        std::vector<range_proof_result> verify_range_batch(const std::vector<commitment_range_proof> &items,
+                                                           worker_pool *pool = nullptr);
+
+        /**
+         *  Checks many commitment sums, such as those of the transactions in a block, over
+         *  <code>pool</code> (the default fc::worker_pool if null).  Each result is what verify_sum()
+         *  returns for the item, or false if one of its commitments is malformed.
+         *
+         *  @return one result per item, in input order
+         */
+        std::vector<bool> verify_sum_batch(const commitment_sum *items, size_t count, worker_pool *pool = nullptr);
+
+        std::vector<bool> verify_sum_batch(const std::vector<commitment_sum> &items, worker_pool *pool = nullptr);
+
 
     } // namespace ecc
     void to_variant(const ecc::private_key &var, variant &vo);
@@ -4,6 +4,8 @@
 #include <fc/vector.hpp>
 
 namespace fc {
+    class worker_pool;
+
     namespace equihash {
 
         struct proof {
@@ -16,9 +18,28 @@ namespace fc {
 
             void canonize_indexes();
 
-            static proof hash(uint32_t n, uint32_t k, sha256 seed);
+            /**
+             *  Finds a proof for seed, the same one the vendored _POW::Equihash solver finds, with
+             *  canonized indexes, or one without inputs if there is none.  The hashing and the
+             *  collision levels run over <code>pool</code> (the default fc::worker_pool if null).
+             */
+            static proof hash(uint32_t n, uint32_t k, sha256 seed, worker_pool *pool = nullptr);
         };
 
+        /**
+         *  Checks many proofs at once, spreading them over <code>pool</code> (the default
+         *  fc::worker_pool if null).  Each result is what proof::is_valid() returns with the same
+         *  flags; with test_intermediate_zeros a proof is rejected at the first pair of indexes
+         *  whose hashes do not collide, without hashing the rest.
+         *
+         *  @return one result per proof, in input order
+         */
+        std::vector<bool> is_valid_batch(const proof *proofs, size_t count, bool test_canonical_order = false,
+                                         bool test_intermediate_zeros = false, worker_pool *pool = nullptr);
+
+        std::vector<bool> is_valid_batch(const std::vector<proof> &proofs, bool test_canonical_order = false,
+                                         bool test_intermediate_zeros = false, worker_pool *pool = nullptr);
+
     }
 } // fc
 
@@ -11,8 +11,18 @@ namespace fc {
 
     std::string to_hex(const std::vector<char> &data);
 
+    /// writes the 2 * s lower case digits of d to out_data, without a terminating null
+    void to_hex(const char *d, size_t s, char *out_data);
+
     /**
      *  @return the number of bytes decoded
      */
     size_t from_hex(const std::string &hex_str, char *out_data, size_t out_data_len);
+
+    /**
+     *  Decodes up to out_data_len bytes from the hex_len digits at hex, an odd last digit
+     *  being the high nibble of the last byte.  Throws on a character that is not a hex digit.
+     *  @return the number of bytes decoded
+     */
+    size_t from_hex(const char *hex, size_t hex_len, char *out_data, size_t out_data_len);
 } 
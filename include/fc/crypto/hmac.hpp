@@ -12,8 +12,13 @@
 #include <fc/crypto/sha256.hpp>
 #include <fc/crypto/sha512.hpp>
 
+#include <vector>
+
 namespace fc {
 
+    template<typename H>
+    class keyed_hmac;
+
     template<typename H>
     class hmac {
     public:
@@ -33,6 +38,8 @@ namespace fc {
         }
 
     private:
+        friend class keyed_hmac<H>;
+
         void add_key(const char *c, const uint32_t c_len, char pad) {
             if (c_len > internal_block_size()) {
                 H hash = H::hash(c, c_len);
@@ -50,9 +57,104 @@ namespace fc {
         typename H::encoder encoder;
     };
 
+    /**
+     *  HMAC with a key fixed at construction, for authenticating many messages with the same key.
+     *  The padded key blocks are hashed once, into the inner and outer hash states; every digest
+     *  continues from copies of those, which saves hashing two blocks per message compared to
+     *  hmac::digest().  A keyed_hmac is not changed by computing digests, so one object can be
+     *  used by several threads at once.
+     */
+    template<typename H>
+    class keyed_hmac {
+    public:
+        keyed_hmac(const char *key, uint32_t key_len) {
+            hmac<H> mac;
+            mac.encoder.reset();
+            mac.add_key(key, key_len, 0x36);
+            inner = mac.encoder;
+            mac.encoder.reset();
+            mac.add_key(key, key_len, 0x5c);
+            outer = mac.encoder;
+        }
+
+        /**
+         *  Computes the HMAC of a message written piece by piece, for instance with fc::raw::pack().
+         */
+        class encoder {
+        public:
+            explicit encoder(const keyed_hmac &mac) : mac(mac), inner(mac.inner) {
+            }
+
+            void write(const char *d, uint32_t dlen) {
+                inner.write(d, dlen);
+            }
+
+            void put(char c) {
+                inner.put(c);
+            }
+
+            H result() {
+                return mac.finish(inner);
+            }
+
+        private:
+            const keyed_hmac &mac;
+            typename H::encoder inner;
+        };
+
+        H digest(const char *d, uint32_t d_len) const {
+            typename H::encoder e(inner);
+            e.write(d, d_len);
+            return finish(e);
+        }
+
+        /**
+         *  Authenticates <code>count</code> messages, writing the HMAC of <code>data[i]</code>
+         *  (<code>sizes[i]</code> bytes) to <code>out[i]</code>.
+         */
+        void digest_many(const char *const *data, const uint32_t *sizes, size_t count, H *out) const {
+            typename H::encoder e(inner);
+            for (size_t i = 0; i < count; ++i) {
+                if (i) {
+                    e = inner;
+                }
+                e.write(data[i], sizes[i]);
+                out[i] = finish(e);
+            }
+        }
+
+        std::vector<H> digest_many(const std::vector<std::vector<char>> &messages) const {
+            std::vector<const char *> data(messages.size());
+            std::vector<uint32_t> sizes(messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                data[i] = messages[i].data();
+                sizes[i] = uint32_t(messages[i].size());
+            }
+            std::vector<H> out(messages.size());
+            digest_many(data.data(), sizes.data(), messages.size(), out.data());
+            return out;
+        }
+
+    private:
+        /// the outer hash of the inner digest, reusing e for it
+        H finish(typename H::encoder &e) const {
+            H intermediate = e.result();
+            e = outer;
+            e.write(intermediate.data(), intermediate.data_size());
+            return e.result();
+        }
+
+        typename H::encoder inner;
+        typename H::encoder outer;
+    };
+
     typedef hmac<fc::sha224> hmac_sha224;
     typedef hmac<fc::sha256> hmac_sha256;
     typedef hmac<fc::sha512> hmac_sha512;
+
+    typedef keyed_hmac<fc::sha224> keyed_hmac_sha224;
+    typedef keyed_hmac<fc::sha256> keyed_hmac_sha256;
+    typedef keyed_hmac<fc::sha512> keyed_hmac_sha512;
 }
 
 #endif    /* HMAC_HPP */
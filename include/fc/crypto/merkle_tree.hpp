@@ -0,0 +1,228 @@
+#pragma once
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace fc {
+    /**
+     *  Inclusion proof of one leaf: the sibling of every node on the path to the
+     *  root, bottom up.  Nodes carried up without a sibling contribute nothing.
+     */
+    template<typename Digest>
+    struct merkle_proof {
+        uint64_t index = 0;        ///< position of the leaf
+        uint64_t leaf_count = 0;   ///< number of leaves of the tree the proof was taken from
+        std::vector<Digest> siblings;
+    };
+
+    namespace detail {
+        /**
+         *  Computes <code>*out[i] = Digest::hash(pairs[i][0] || pairs[i][1])</code> for i in [0, count).
+         *  The fc::sha256 specialization hashes the pairs several at a time with sha256::hash_many().
+         */
+        template<typename Digest>
+        struct merkle_pair_hasher {
+            static void hash_pairs(const Digest *const *pairs, size_t count, Digest *const *out) {
+                for (size_t i = 0; i < count; ++i) {
+                    typename Digest::encoder enc;
+                    enc.write(pairs[i][0].data(), sizeof(Digest));
+                    enc.write(pairs[i][1].data(), sizeof(Digest));
+                    *out[i] = enc.result();
+                }
+            }
+        };
+
+        template<>
+        struct merkle_pair_hasher<fc::sha256> {
+            static void hash_pairs(const fc::sha256 *const *pairs, size_t count, fc::sha256 *const *out);
+        };
+    }
+
+    /**
+     *  @brief binary Merkle tree over digests with incremental updates
+     *
+     *  An inner node is <code>Digest::hash(left || right)</code>, i.e. the hash of the two
+     *  packed children.  A level with an odd number of nodes carries its last node up
+     *  unchanged instead of pairing it with itself, which is how block headers compute
+     *  their transaction merkle root.  The root of a single leaf is the leaf, the root
+     *  of an empty tree is a default constructed Digest.
+     *
+     *  append() and update() only mark leaves; the next call to root() or proof()
+     *  rehashes just the nodes above them.  Levels with many nodes to rehash are split
+     *  over a worker_pool.  The tree is not synchronized: concurrent use of one tree
+     *  needs external locking.
+     */
+    template<typename Digest>
+    class merkle_tree {
+    public:
+        typedef Digest digest_type;
+
+        /// levels with fewer nodes to rehash are computed on the calling thread
+        static const size_t parallel_threshold = 1024;
+
+        /// @param pool pool used for large levels, nullptr selects worker_pool::get_default()
+        explicit merkle_tree(worker_pool *pool = nullptr) : _pool(pool) {
+            _levels.resize(1);
+        }
+
+        explicit merkle_tree(std::vector<Digest> leaves, worker_pool *pool = nullptr) : _pool(pool) {
+            _levels.resize(1);
+            _levels[0] = std::move(leaves);
+            mark_from(0);
+        }
+
+        size_t size() const {
+            return _levels[0].size();
+        }
+
+        const std::vector<Digest> &leaves() const {
+            return _levels[0];
+        }
+
+        void append(const Digest &leaf) {
+            _levels[0].push_back(leaf);
+            _dirty.push_back(_levels[0].size() - 1);
+        }
+
+        void append(const std::vector<Digest> &leaves) {
+            size_t first = _levels[0].size();
+            _levels[0].insert(_levels[0].end(), leaves.begin(), leaves.end());
+            mark_from(first);
+        }
+
+        void update(size_t index, const Digest &leaf) {
+            FC_ASSERT(index < _levels[0].size(), "merkle leaf ${i} out of range", ("i", index));
+            _levels[0][index] = leaf;
+            _dirty.push_back(index);
+        }
+
+        /// brings the changed nodes up to date and returns the root
+        const Digest &root() {
+            refresh();
+            return _levels.back().empty() ? _empty_root : _levels.back()[0];
+        }
+
+        merkle_proof<Digest> proof(size_t index) {
+            FC_ASSERT(index < _levels[0].size(), "merkle leaf ${i} out of range", ("i", index));
+            refresh();
+            merkle_proof<Digest> result;
+            result.index = index;
+            result.leaf_count = _levels[0].size();
+            for (size_t k = 0; k + 1 < _levels.size(); ++k) {
+                size_t sibling = index ^ 1;
+                if (sibling < _levels[k].size()) {
+                    result.siblings.push_back(_levels[k][sibling]);
+                }
+                index /= 2;
+            }
+            return result;
+        }
+
+        /// checks that <code>leaf</code> is at <code>p.index</code> of a tree with root <code>root</code>
+        static bool verify(const Digest &leaf, const merkle_proof<Digest> &p, const Digest &root) {
+            if (p.index >= p.leaf_count) {
+                return false;
+            }
+            Digest h = leaf;
+            uint64_t index = p.index;
+            uint64_t count = p.leaf_count;
+            auto sibling = p.siblings.begin();
+            for (; count > 1; index /= 2, count = (count + 1) / 2) {
+                if (!(index & 1) && index + 1 == count) {
+                    continue;   // carried up without a sibling
+                }
+                if (sibling == p.siblings.end()) {
+                    return false;
+                }
+                h = (index & 1) ? hash_pair(*sibling, h) : hash_pair(h, *sibling);
+                ++sibling;
+            }
+            return sibling == p.siblings.end() && h == root;
+        }
+
+        static Digest hash_pair(const Digest &left, const Digest &right) {
+            Digest pair[2] = {left, right};
+            const Digest *in = pair;
+            Digest result;
+            Digest *out = &result;
+            detail::merkle_pair_hasher<Digest>::hash_pairs(&in, 1, &out);
+            return result;
+        }
+
+    private:
+        void mark_from(size_t first) {
+            for (size_t i = first; i < _levels[0].size(); ++i) {
+                _dirty.push_back(i);
+            }
+        }
+
+        void refresh() {
+            if (_dirty.empty()) {
+                return;
+            }
+            std::sort(_dirty.begin(), _dirty.end());
+            _dirty.erase(std::unique(_dirty.begin(), _dirty.end()), _dirty.end());
+
+            std::vector<size_t> parents;
+            size_t k = 0;
+            for (; _levels[k].size() > 1; ++k) {
+                if (_levels.size() == k + 1) {
+                    _levels.emplace_back();
+                }
+                _levels[k + 1].resize((_levels[k].size() + 1) / 2);
+
+                parents.clear();
+                for (size_t i : _dirty) {
+                    if (parents.empty() || parents.back() != i / 2) {
+                        parents.push_back(i / 2);
+                    }
+                }
+                rehash(k, parents);
+                _dirty.swap(parents);
+            }
+            // the tree only grows, so the top level found here is the highest one
+            _levels.resize(k + 1);
+            _dirty.clear();
+        }
+
+        /// recomputes the given nodes of level k + 1 from level k
+        void rehash(size_t k, const std::vector<size_t> &nodes) {
+            const std::vector<Digest> &children = _levels[k];
+            std::vector<Digest> &parents = _levels[k + 1];
+
+            std::vector<const Digest *> pairs;
+            std::vector<Digest *> out;
+            pairs.reserve(nodes.size());
+            out.reserve(nodes.size());
+            for (size_t p : nodes) {
+                if (2 * p + 1 < children.size()) {
+                    pairs.push_back(&children[2 * p]);
+                    out.push_back(&parents[p]);
+                } else {
+                    parents[p] = children[2 * p];
+                }
+            }
+
+            if (pairs.size() < parallel_threshold) {
+                detail::merkle_pair_hasher<Digest>::hash_pairs(pairs.data(), pairs.size(), out.data());
+                return;
+            }
+            worker_pool &pool = _pool ? *_pool : worker_pool::get_default();
+            pool.for_each_range(pairs.size(), [&](size_t begin, size_t end) {
+                detail::merkle_pair_hasher<Digest>::hash_pairs(pairs.data() + begin, end - begin, out.data() + begin);
+            }, parallel_threshold / 2);
+        }
+
+        worker_pool *_pool;
+        std::vector<std::vector<Digest>> _levels;   ///< leaves first, the root level last
+        std::vector<size_t> _dirty;                 ///< leaves changed since the last refresh
+        Digest _empty_root;
+    };
+} // namespace fc
+
+FC_REFLECT_TEMPLATE((typename Digest), (fc::merkle_proof<Digest>), (index)(leaf_count)(siblings))
@@ -2,7 +2,12 @@
 
 namespace fc {
 
-    /* provides access to the OpenSSL random number generator */
+    /**
+     *  Fills buf with cryptographically secure random bytes.  Each thread draws from its own
+     *  ChaCha20 generator, seeded from the OpenSSL random number generator on first use, every
+     *  megabyte of output and in the child after fork(), so concurrent callers do not contend on
+     *  OpenSSL's lock.
+     */
     void rand_bytes(char *buf, int count);
 
 } // namespace fc 
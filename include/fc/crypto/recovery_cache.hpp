@@ -0,0 +1,49 @@
+#pragma once
+
+#include <fc/crypto/elliptic.hpp>
+
+namespace fc {
+    namespace ecc {
+        /**
+         *  @brief process-wide cache of public keys recovered from compact signatures
+         *
+         *  Nodes recover the same signatures several times: when a transaction enters the
+         *  pending pool, when its block is applied and again on fork switches and replays.
+         *  While the cache is enabled, public_key(const compact_signature&, const fc::sha256&, bool)
+         *  (and therefore recover_batch()) first looks up the (signature, digest) pair and only
+         *  runs the elliptic curve recovery on a miss.
+         *
+         *  The cache is off by default.  It is bounded, evicts with the CLOCK (second chance)
+         *  policy and is split into independently locked shards so concurrent lookups rarely
+         *  contend.  Only successful recoveries are cached; the recovery id and canonicality
+         *  checks run on every call.
+         */
+        class recovery_cache {
+        public:
+            struct stats {
+                uint64_t hits = 0;
+                uint64_t misses = 0;
+                uint64_t evictions = 0;
+                size_t size = 0;      ///< number of cached keys
+                size_t capacity = 0;  ///< maximum number of cached keys, 0 while disabled
+            };
+
+            /**
+             *  Enables the cache, or changes its capacity, dropping all cached keys.
+             *  @param capacity maximum number of cached keys, rounded up to a multiple of the
+             *  shard count; 0 disables the cache
+             */
+            static void enable(size_t capacity);
+
+            /// disables the cache and frees its memory
+            static void disable();
+
+            static bool enabled();
+
+            static stats get_stats();
+
+            /// drops all cached keys and resets the counters, keeping the cache enabled
+            static void clear();
+        };
+    }
+}
@@ -3,6 +3,7 @@
 #include <fc/fwd.hpp>
 #include <fc/io/raw_fwd.hpp>
 #include <fc/reflect/typename.hpp>
+#include <fc/crypto/digest_block.hpp>
 
 #include <string>
 
@@ -35,6 +36,9 @@ namespace fc {
 
         static ripemd160 hash(const std::string &);
 
+        /// name of the code path computing this digest, always "portable" (fc's own, faster than OpenSSL's)
+        static const char *implementation();
+
         template<typename T>
         static ripemd160 hash(const T &t) {
             ripemd160::encoder e;
@@ -48,10 +52,16 @@ namespace fc {
 
             ~encoder();
 
-            void write(const char *d, uint32_t dlen);
+            void write(const char *d, uint32_t dlen) {
+                if (!detail::append_to_digest_block(_block, _used, d, dlen)) {
+                    write_blocks(d, dlen);
+                }
+            }
 
             void put(char c) {
-                write(&c, 1);
+                if (!detail::append_to_digest_block(_block, _used, &c, 1)) {
+                    write_blocks(&c, 1);
+                }
             }
 
             void reset();
@@ -59,8 +69,12 @@ namespace fc {
             ripemd160 result();
 
         private:
+            void write_blocks(const char *d, uint32_t dlen);
+
             struct impl;
-            fc::fwd<impl, 96> my;
+            fc::fwd<impl, 32> my;
+            uint32_t _used;
+            char _block[64];
         };
 
         template<typename T>
@@ -2,6 +2,7 @@
 
 #include <fc/fwd.hpp>
 #include <fc/string.hpp>
+#include <fc/crypto/digest_block.hpp>
 
 #include <string>
 
@@ -27,6 +28,13 @@ namespace fc {
 
         static sha1 hash(const std::string &);
 
+        /**
+         *  Name of the code path computing this digest, picked once for the CPU
+         *  the process runs on: "sha-ni" on x86-64 CPUs with the SHA extensions,
+         *  "openssl" everywhere else.
+         */
+        static const char *implementation();
+
         template<typename T>
         static sha1 hash(const T &t) {
             sha1::encoder e;
@@ -40,10 +48,16 @@ namespace fc {
 
             ~encoder();
 
-            void write(const char *d, uint32_t dlen);
+            void write(const char *d, uint32_t dlen) {
+                if (!detail::append_to_digest_block(_block, _used, d, dlen)) {
+                    write_blocks(d, dlen);
+                }
+            }
 
             void put(char c) {
-                write(&c, 1);
+                if (!detail::append_to_digest_block(_block, _used, &c, 1)) {
+                    write_blocks(&c, 1);
+                }
             }
 
             void reset();
@@ -51,8 +65,12 @@ namespace fc {
             sha1 result();
 
         private:
+            void write_blocks(const char *d, uint32_t dlen);
+
             struct impl;
-            fc::fwd<impl, 96> my;
+            fc::fwd<impl, 32> my;
+            uint32_t _used;
+            char _block[64];
         };
 
         template<typename T>
@@ -4,6 +4,7 @@
 #include <fc/fwd.hpp>
 #include <fc/io/raw_fwd.hpp>
 #include <fc/string.hpp>
+#include <fc/crypto/digest_block.hpp>
 
 namespace fc {
 
@@ -27,6 +28,13 @@ namespace fc {
 
         static sha224 hash(const std::string &);
 
+        /**
+         *  Name of the code path computing this digest, picked once for the CPU
+         *  the process runs on: "sha-ni" on x86-64 CPUs with the SHA extensions,
+         *  "openssl" everywhere else.
+         */
+        static const char *implementation();
+
         template<typename T>
         static sha224 hash(const T &t) {
             sha224::encoder e;
@@ -40,10 +48,21 @@ namespace fc {
 
             ~encoder();
 
-            void write(const char *d, uint32_t dlen);
+            /// copies the state, so a common prefix can be hashed once and continued several ways
+            encoder(const encoder &other);
+
+            encoder &operator=(const encoder &other);
+
+            void write(const char *d, uint32_t dlen) {
+                if (!detail::append_to_digest_block(_block, _used, d, dlen)) {
+                    write_blocks(d, dlen);
+                }
+            }
 
             void put(char c) {
-                write(&c, 1);
+                if (!detail::append_to_digest_block(_block, _used, &c, 1)) {
+                    write_blocks(&c, 1);
+                }
             }
 
             void reset();
@@ -51,8 +70,12 @@ namespace fc {
             sha224 result();
 
         private:
+            void write_blocks(const char *d, uint32_t dlen);
+
             struct impl;
-            fc::fwd<impl, 112> my;
+            fc::fwd<impl, 40> my;
+            uint32_t _used;
+            char _block[64];
         };
 
         template<typename T>
@@ -5,6 +5,9 @@
 #include <fc/fixed_string.hpp>
 #include <fc/platform_independence.hpp>
 #include <fc/io/raw_fwd.hpp>
+#include <fc/crypto/digest_block.hpp>
+
+#include <vector>
 
 namespace fc {
 
@@ -30,8 +33,31 @@ namespace fc {
 
         static sha256 hash(const std::string &);
 
+        /**
+         *  Name of the code path computing this digest, picked once for the CPU
+         *  the process runs on: "sha-ni" on x86-64 CPUs with the SHA extensions,
+         *  "openssl" everywhere else.
+         */
+        static const char *implementation();
+
         static sha256 hash(const sha256 &);
 
+        /**
+         *  Hashes <code>count</code> independent messages, writing the digest of
+         *  <code>data[i]</code> (<code>sizes[i]</code> bytes) to <code>out[i]</code>.
+         *
+         *  Where the CPU has wide SIMD units the messages are hashed several at a time,
+         *  one per vector lane (4 with SSE2, 8 with AVX2, 16 with AVX-512), which is
+         *  much faster than hashing them one by one unless the CPU has SHA extensions.
+         *  The implementation is picked once at run time, see hash_many_implementation().
+         */
+        static void hash_many(const char *const *data, const uint32_t *sizes, size_t count, sha256 *out);
+
+        static std::vector<sha256> hash_many(const std::vector<std::vector<char>> &messages);
+
+        /// name of the code path used by hash_many() on this CPU
+        static const char *hash_many_implementation();
+
         template<typename T>
         static sha256 hash(const T &t) {
             sha256::encoder e;
@@ -45,10 +71,21 @@ namespace fc {
 
             ~encoder();
 
-            void write(const char *d, uint32_t dlen);
+            /// copies the state, so a common prefix can be hashed once and continued several ways
+            encoder(const encoder &other);
+
+            encoder &operator=(const encoder &other);
+
+            void write(const char *d, uint32_t dlen) {
+                if (!detail::append_to_digest_block(_block, _used, d, dlen)) {
+                    write_blocks(d, dlen);
+                }
+            }
 
             void put(char c) {
-                write(&c, 1);
+                if (!detail::append_to_digest_block(_block, _used, &c, 1)) {
+                    write_blocks(&c, 1);
+                }
             }
 
             void reset();
@@ -56,8 +93,12 @@ namespace fc {
             sha256 result();
 
         private:
+            void write_blocks(const char *d, uint32_t dlen);
+
             struct impl;
-            fc::fwd<impl, 112> my;
+            fc::fwd<impl, 40> my;
+            uint32_t _used;
+            char _block[64];
         };
 
         template<typename T>
@@ -3,6 +3,7 @@
 #include <fc/fwd.hpp>
 #include <fc/fixed_string.hpp>
 #include <fc/string.hpp>
+#include <fc/crypto/digest_block.hpp>
 
 namespace fc {
 
@@ -26,6 +27,9 @@ namespace fc {
 
         static sha512 hash(const std::string &);
 
+        /// name of the code path computing this digest, always "openssl"
+        static const char *implementation();
+
         template<typename T>
         static sha512 hash(const T &t) {
             sha512::encoder e;
@@ -39,10 +43,21 @@ namespace fc {
 
             ~encoder();
 
-            void write(const char *d, uint32_t dlen);
+            /// copies the state, so a common prefix can be hashed once and continued several ways
+            encoder(const encoder &other);
+
+            encoder &operator=(const encoder &other);
+
+            void write(const char *d, uint32_t dlen) {
+                if (!detail::append_to_digest_block(_block, _used, d, dlen)) {
+                    write_blocks(d, dlen);
+                }
+            }
 
             void put(char c) {
-                write(&c, 1);
+                if (!detail::append_to_digest_block(_block, _used, &c, 1)) {
+                    write_blocks(&c, 1);
+                }
             }
 
             void reset();
@@ -50,8 +65,12 @@ namespace fc {
             sha512 result();
 
         private:
+            void write_blocks(const char *d, uint32_t dlen);
+
             struct impl;
-            fc::fwd<impl, 216> my;
+            fc::fwd<impl, 72> my;
+            uint32_t _used;
+            char _block[128];
         };
 
         template<typename T>
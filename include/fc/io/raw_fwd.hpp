@@ -36,6 +36,8 @@ namespace fc {
         class endpoint;
     }
 
+    class blocked_bloom_filter;
+
     namespace ecc {
         class public_key;
 
@@ -147,6 +149,12 @@ namespace fc {
         template<typename Stream>
         inline void unpack(Stream &s, ip::address &v, uint32_t depth = 0);
 
+        template<typename Stream>
+        inline void pack(Stream &s, const blocked_bloom_filter &v);
+
+        template<typename Stream>
+        inline void unpack(Stream &s, blocked_bloom_filter &v, uint32_t depth = 0);
+
 
         template<typename Stream, typename T>
         void unpack(Stream &s, fc::optional<T> &v, uint32_t depth = 0);
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <fc/thread/thread.hpp>
+
+/**
+ *  C++20 coroutine support, available when the translation unit is compiled
+ *  with coroutines enabled (-std=c++20); the rest of fc does not depend on it.
+ */
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include <boost/exception/diagnostic_information.hpp>
+
+#include <fc/log/logger.hpp>
+
+namespace fc {
+    template<typename T = void>
+    class task_co;
+
+    namespace detail {
+        template<typename T>
+        struct is_future : std::false_type {
+        };
+        template<typename T>
+        struct is_future<future<T>> : std::true_type {
+        };
+
+        template<typename T>
+        struct is_task_co : std::false_type {
+        };
+        template<typename T>
+        struct is_task_co<task_co<T>> : std::true_type {
+        };
+
+        /**
+         *  Queues the resumption of h on the thread of target.
+         *  @return false if that thread has quit
+         */
+        inline bool post_resume(thread_handle &target, std::coroutine_handle<> h, const char *desc) {
+            auto resume = [h]() { h.resume(); };
+            task_base *t = new posted_task<decltype(resume)>(std::move(resume), desc);
+            if (!target.async_task(t, priority())) {
+                t->release();
+                return false;
+            }
+            return true;
+        }
+
+        /// completion handler resuming a suspended coroutine on the thread it suspended on
+        struct coroutine_resumer {
+            std::shared_ptr<thread_handle> target;
+            std::coroutine_handle<> handle;
+            promise_base *owner;   // promise of a suspended task_co, null for other coroutine types
+
+            template<typename... Args>
+            void operator()(const Args &...) const {
+                if (post_resume(*target, handle, "coroutine resume")) {
+                    return;
+                }
+                // the coroutine can never resume on the thread it suspended on
+                if (owner) {
+                    owner->set_exception(std::make_shared<canceled_exception>(
+                            FC_LOG_MESSAGE(error, "cancellation reason: coroutine thread quit")));
+                    handle.destroy();
+                } else {
+                    elog("coroutine left suspended, the thread it awaits on quit");
+                }
+            }
+        };
+
+        inline void throw_if_canceled(const promise_base &p) {
+            if (p.canceled()) {
+                FC_THROW_EXCEPTION(canceled_exception, "coroutine ${description} canceled",
+                                   ("description", p.get_desc()));
+            }
+        }
+
+        /// awaiter for fc::future<T>; suspends without parking a fiber
+        template<typename T>
+        struct future_awaiter {
+            future<T> _future;
+            promise_base *_owner;   // promise of the awaiting coroutine, checked for cancellation
+
+            bool await_ready() const {
+                return _future.ready();
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                _future.on_complete(coroutine_resumer{thread::current().handle(), h, _owner});
+            }
+
+            decltype(auto) await_resume() {
+                if (_owner) {
+                    throw_if_canceled(*_owner);
+                }
+                // ready by now, so this only returns the value or rethrows
+                return _future.wait();
+            }
+        };
+
+        /// awaiter moving the coroutine onto another fc::thread
+        struct thread_switch_awaiter {
+            std::shared_ptr<thread_handle> _target;
+
+            bool await_ready() const {
+                return _target->is_current();
+            }
+
+            // thrown from here, the exception is raised in the coroutine, which stays where it is
+            void await_suspend(std::coroutine_handle<> h) {
+                if (!post_resume(*_target, h, "coroutine resume_on")) {
+                    FC_THROW_EXCEPTION(canceled_exception, "resume_on: the target thread quit");
+                }
+            }
+
+            void await_resume() const {
+            }
+        };
+
+        template<typename T>
+        struct task_co_promise_base {
+            typename promise<T>::ptr _result{new promise<T>("task_co")};
+
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            // the frame is destroyed as soon as the body finishes, the result lives in _result
+            std::suspend_never final_suspend() noexcept {
+                return {};
+            }
+
+            void unhandled_exception() {
+                try {
+                    throw;
+                } catch (const fc::exception &e) {
+                    _result->set_exception(e.dynamic_copy_exception());
+                } catch (...) {
+                    _result->set_exception(std::make_shared<fc::unhandled_exception>(
+                            FC_LOG_MESSAGE(warn, "unhandled exception: ${diagnostic}",
+                                           ("diagnostic", boost::current_exception_diagnostic_information()))));
+                }
+            }
+
+            template<typename U>
+            future_awaiter<U> await_transform(future<U> f) {
+                return future_awaiter<U>{std::move(f), _result.get()};
+            }
+
+            template<typename U>
+            future_awaiter<U> await_transform(task_co<U> &&t) {
+                return future_awaiter<U>{std::move(t).start(), _result.get()};
+            }
+
+            template<typename Awaitable, typename = typename std::enable_if<
+                    !is_future<typename std::decay<Awaitable>::type>::value &&
+                    !is_task_co<typename std::decay<Awaitable>::type>::value>::type>
+            Awaitable &&await_transform(Awaitable &&a) {
+                return std::forward<Awaitable>(a);
+            }
+        };
+    }
+
+    /**
+     *  @brief a lazily started, stackless task running on fc::thread run queues
+     *
+     *  A coroutine returning task_co<T> does not run until it is either started with
+     *  start(), which returns an fc::future<T>, or awaited with co_await from another
+     *  task_co.  Every resumption is a task posted to the thread the coroutine was
+     *  started on (or moved to with co_await fc::resume_on()), so a suspended
+     *  coroutine costs only its frame instead of a fiber stack.
+     *
+     *  Inside the body:
+     *  - <code>co_await</code> on an fc::future (including the result of fc::async) suspends
+     *    until the future is ready and resumes on the same thread;
+     *  - cancelling the future returned by start() makes the next <code>co_await</code> throw
+     *    fc::canceled_exception;
+     *  - if the thread a coroutine suspended on quits before the awaited future is ready, the
+     *    coroutine is destroyed and the future returned by start() fails with
+     *    fc::canceled_exception;
+     *  - blocking fc calls (fc::mutex::lock, future::wait, fc::usleep) are allowed but park
+     *    the fiber that resumed the coroutine.  An fc::mutex is owned by that fiber, so it
+     *    must be released before the next <code>co_await</code>.
+     *
+     *  @code
+     *    fc::task_co<int> add_remote(fc::thread& t) {
+     *       int a = co_await t.async([]{ return 1; });
+     *       int b = co_await t.async([]{ return 2; });
+     *       co_return a + b;
+     *    }
+     *    fc::future<int> r = add_remote(worker).start();
+     *  @endcode
+     */
+    template<typename T>
+    class task_co {
+    public:
+        struct promise_type : detail::task_co_promise_base<T> {
+            task_co get_return_object() {
+                return task_co(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            template<typename U>
+            void return_value(U &&v) {
+                this->_result->set_value(std::forward<U>(v));
+            }
+        };
+
+        task_co(task_co &&o) noexcept : _handle(o._handle) {
+            o._handle = nullptr;
+        }
+
+        task_co(const task_co &) = delete;
+
+        task_co &operator=(const task_co &) = delete;
+
+        ~task_co() {
+            // never started
+            if (_handle) {
+                _handle.destroy();
+            }
+        }
+
+        /**
+         *  Schedules the coroutine on thread <code>t</code>.
+         *  @return a future for the value passed to co_return
+         */
+        future<T> start(thread &t = thread::current()) && {
+            std::coroutine_handle<promise_type> h = _handle;
+            _handle = nullptr;
+            future<T> r(h.promise()._result);
+            t.post([h]() {
+                // a coroutine canceled before it started never runs its body
+                if (h.promise()._result->canceled()) {
+                    h.promise()._result->set_exception(std::make_shared<canceled_exception>(
+                            FC_LOG_MESSAGE(error, "task_co canceled before starting")));
+                    h.destroy();
+                    return;
+                }
+                h.resume();
+            }, "task_co start");
+            return r;
+        }
+
+    private:
+        explicit task_co(std::coroutine_handle<promise_type> h) : _handle(h) {
+        }
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    template<>
+    struct task_co<void>::promise_type : detail::task_co_promise_base<void> {
+        task_co<void> get_return_object() {
+            return task_co<void>(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        void return_void() {
+            this->_result->set_value();
+        }
+    };
+
+    /**
+     *  Awaitable moving the current coroutine onto thread <code>t</code>; the code after
+     *  <code>co_await fc::resume_on(t)</code> runs there.
+     */
+    inline detail::thread_switch_awaiter resume_on(thread &t) {
+        return detail::thread_switch_awaiter{t.handle()};
+    }
+
+    /**
+     *  Allows <code>co_await</code> on an fc::future from coroutine types other than task_co.
+     *  Such coroutines do not observe fc cancellation.
+     */
+    template<typename T>
+    detail::future_awaiter<T> operator co_await(future<T> f) {
+        return detail::future_awaiter<T>{std::move(f), nullptr};
+    }
+}
+
+#endif
@@ -6,6 +6,12 @@
 #include <fc/exception/exception.hpp>
 #include <fc/thread/spin_yield_lock.hpp>
 #include <fc/optional.hpp>
+#include <fc/thread/priority.hpp>
+
+#include <boost/atomic.hpp>
+#include <iterator>
+#include <memory>
+#include <utility>
 
 //#define FC_TASK_NAMES_ARE_MANDATORY 1
 #ifdef FC_TASK_NAMES_ARE_MANDATORY
@@ -27,17 +33,25 @@ namespace fc {
     struct void_t {
     };
 
-    class priority;
-
     class thread;
 
+    class promise_base;
+
     namespace detail {
         class completion_handler {
         public:
+            completion_handler() : _next(nullptr) {
+            }
+
             virtual ~completion_handler() {
             };
 
             virtual void on_complete(const void *v, const fc::exception_ptr &e) = 0;
+
+        private:
+            friend class fc::promise_base;
+
+            completion_handler *_next;
         };
 
         template<typename Functor, typename T>
@@ -134,7 +148,8 @@ namespace fc {
     private:
 #endif
         const char *_desc;
-        detail::completion_handler *_compl;
+        const void *_value;                   // set together with _ready, passed to late completion handlers
+        detail::completion_handler *_compl;   // handlers to call once ready, most recently added first
     };
 
     template<typename T = void>
@@ -321,12 +336,32 @@ namespace fc {
          * The given completion handler will be called from some
          * arbitrary thread and should not 'block'. Generally
          * it should post an event or start a new async operation.
+         *
+         * Several handlers may be registered, they are called in
+         * registration order.  If the future is already ready the
+         * handler is called right away on the calling thread.
          */
         template<typename CompletionHandler>
         void on_complete(CompletionHandler &&c) {
             m_prom->on_complete(fc::forward<CompletionHandler>(c));
         }
 
+        /**
+         * @pre valid()
+         *
+         * Runs <code>f</code> on thread <code>t</code> once this future is ready,
+         * without blocking a fiber while waiting.  <code>f</code> receives a copy
+         * of this (now ready) future, so it can call wait() to get the value or
+         * the exception without blocking.
+         *
+         * Defined in thread.hpp.
+         *
+         * @return a future for the result of <code>f</code>
+         */
+        template<typename Functor>
+        auto then(thread &t, Functor &&f, const char *desc FC_TASK_NAME_DEFAULT_ARG,
+                  priority prio = priority()) -> future<decltype(f(std::declval<future<T>>()))>;
+
     private:
         friend class thread;
 
@@ -407,10 +442,105 @@ namespace fc {
             m_prom->on_complete(fc::forward<CompletionHandler>(c));
         }
 
+        /// @see future<T>::then()
+        template<typename Functor>
+        auto then(thread &t, Functor &&f, const char *desc FC_TASK_NAME_DEFAULT_ARG,
+                  priority prio = priority()) -> future<decltype(f(std::declval<future<void>>()))>;
+
     private:
         friend class thread;
 
         fc::shared_ptr<promise<void>> m_prom;
     };
+
+    namespace detail {
+        /// completion handler counting down to the last of several futures
+        struct when_all_handler {
+            struct state {
+                state(size_t count, const promise<void>::ptr &p) : remaining(count), result(p) {
+                }
+
+                boost::atomic<size_t> remaining;
+                promise<void>::ptr result;
+            };
+
+            std::shared_ptr<state> _state;
+
+            template<typename... Args>
+            void operator()(const Args &...) const {
+                if (_state->remaining.fetch_sub(1, boost::memory_order_acq_rel) == 1) {
+                    _state->result->set_value();
+                }
+            }
+        };
+
+        /// completion handler reporting the index of the first of several futures to complete
+        struct when_any_handler {
+            struct state {
+                state(const promise<size_t>::ptr &p) : fired(false), result(p) {
+                }
+
+                boost::atomic<bool> fired;
+                promise<size_t>::ptr result;
+            };
+
+            std::shared_ptr<state> _state;
+            size_t _index;
+
+            template<typename... Args>
+            void operator()(const Args &...) const {
+                if (!_state->fired.exchange(true, boost::memory_order_acq_rel)) {
+                    _state->result->set_value(_index);
+                }
+            }
+        };
+    }
+
+    /**
+     *  Returns a future that becomes ready once every future in <code>futures</code>
+     *  is ready, without blocking a fiber meanwhile.  It does not carry the results
+     *  or the errors of the inputs; inspect the input futures (for example from a
+     *  then() continuation) to get at them.
+     *
+     *  @param futures a range of valid fc::future objects
+     */
+    template<typename Range>
+    future<void> when_all(const Range &futures, const char *desc = "when_all") {
+        promise<void>::ptr result(new promise<void>(desc));
+        size_t count = std::distance(std::begin(futures), std::end(futures));
+        if (count == 0) {
+            result->set_value();
+            return future<void>(result);
+        }
+
+        detail::when_all_handler handler;
+        handler._state = std::make_shared<detail::when_all_handler::state>(count, result);
+        for (auto itr = std::begin(futures); itr != std::end(futures); ++itr) {
+            auto f = *itr;
+            f.on_complete(detail::when_all_handler(handler));
+        }
+        return future<void>(result);
+    }
+
+    /**
+     *  Returns a future holding the position in <code>futures</code> of the first
+     *  future to become ready (successfully or not), without blocking a fiber meanwhile.
+     *
+     *  @param futures a non-empty range of valid fc::future objects; an empty one
+     *                 throws, as its result would never become ready
+     */
+    template<typename Range>
+    future<size_t> when_any(const Range &futures, const char *desc = "when_any") {
+        FC_ASSERT(std::begin(futures) != std::end(futures), "when_any needs at least one future");
+        promise<size_t>::ptr result(new promise<size_t>(desc));
+        detail::when_any_handler handler;
+        handler._state = std::make_shared<detail::when_any_handler::state>(result);
+        handler._index = 0;
+        for (auto itr = std::begin(futures); itr != std::end(futures); ++itr, ++handler._index) {
+            auto f = *itr;
+            f.on_complete(detail::when_any_handler(handler));
+        }
+        return future<size_t>(result);
+    }
 } 
 
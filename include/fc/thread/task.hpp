@@ -5,6 +5,8 @@
 #include <fc/aligned.hpp>
 #include <fc/fwd.hpp>
 
+#include <type_traits>
+
 namespace fc {
     struct context;
 
@@ -32,13 +34,18 @@ namespace fc {
     public:
         void run();
 
+        /// task objects are carved out of per-thread size-class pools, see src/thread/task_pool.hpp
+        static void *operator new(std::size_t size);
+
+        static void operator delete(void *p);
+
         virtual void cancel(const char *reason FC_CANCELATION_REASON_DEFAULT_ARG) override;
 
     protected:
         ~task_base();
 
-        /// Task priority looks like unsupported feature.
         uint64_t _posted_num;
+        /// tasks ready to start run highest _prio first, then in the order they were posted
         priority _prio;
         time_point _when;
 
@@ -99,6 +106,14 @@ namespace fc {
                 ((promise<void> *) prom)->set_value();
             }
         };
+
+        /// runs a functor posted without a future, the result (if any) is discarded
+        template<typename T>
+        struct posted_functor_run {
+            static void run(void *functor, void *) {
+                (*((T *) functor))();
+            }
+        };
     }
 
     template<typename R, uint64_t FunctorSize = 64>
@@ -149,4 +164,27 @@ namespace fc {
         }
     };
 
+    /**
+     *  The fire-and-forget task thread::post() queues.  It is only a task_base: there is no
+     *  promise<R> to complete and no future to hold it, and the functor is stored at its own
+     *  size instead of a FunctorSize slot, so the node fits the smallest task pool class for
+     *  the usual lambdas.  Exceptions thrown by the functor are logged.
+     */
+    template<typename Functor>
+    class posted_task : public task_base {
+    public:
+        template<typename F>
+        posted_task(F &&f, const char *desc):promise_base(desc), task_base(&_functor) {
+            new((char *) &_functor) Functor(fc::forward<F>(f));
+            _destroy_functor = &detail::functor_destructor<Functor>::destroy;
+            _run_functor = &detail::posted_functor_run<Functor>::run;
+        }
+
+    private:
+        ~posted_task() {
+        }
+
+        typename std::aligned_storage<sizeof(Functor), alignof(Functor)>::type _functor;
+    };
+
 }
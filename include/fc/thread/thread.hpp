@@ -6,6 +6,11 @@
 #include <fc/vector.hpp>
 #include <fc/string.hpp>
 
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
 namespace fc {
     class time_point;
 
@@ -21,8 +26,53 @@ namespace fc {
         void *get_task_specific_data(unsigned slot);
 
         void set_task_specific_data(unsigned slot, void *new_value, void(*cleanup)(void *));
+
+        /**
+         *  Queues tasks on an fc::thread for code that may run after the thread quit or the
+         *  fc::thread object was destroyed, such as completion handlers fired by whichever
+         *  thread completes a promise.  The thread invalidates its handle when it quits;
+         *  from then on async_task() refuses tasks instead of touching the thread.
+         */
+        class thread_handle {
+        public:
+            explicit thread_handle(thread *t);
+
+            /**
+             *  Queues t like thread::async_task() does.
+             *  @return false if the thread has quit, in which case t is left to the caller
+             */
+            bool async_task(task_base *t, const priority &p);
+
+            /// true if the handle refers to the calling thread
+            bool is_current() const;
+
+        private:
+            friend class fc::thread;
+
+            void invalidate();
+
+            mutable std::mutex _lock;
+            thread *_thread;
+        };
     }
 
+    /**
+     *  Controls what an idle fc::thread does before it parks waiting for work.
+     *
+     *  A parked thread needs a kernel wakeup (futex or condition variable) when a task
+     *  is posted to it.  For latency-sensitive hand-offs it can be cheaper to keep polling
+     *  the incoming queue for a short while: first with a cpu pause between polls, then
+     *  yielding the OS thread between polls, and only then parking.  The default policy
+     *  parks immediately.
+     */
+    struct idle_policy {
+        explicit idle_policy(uint32_t spins = 0, uint32_t yields = 0) : spin_count(spins), yield_count(yields) {
+        }
+
+        uint32_t spin_count;    ///< polls of the incoming queue with a cpu pause in between
+        uint32_t yield_count;   ///< polls of the incoming queue with an OS thread yield in between
+    };
+
     class thread {
     public:
         thread(const std::string &name = "");
@@ -52,6 +102,16 @@ namespace fc {
 
         const char *current_task_desc() const;
 
+        /**
+         *  @brief sets how this thread waits when it runs out of work, see @ref idle_policy
+         *
+         *  May be called from any thread; the policy applies from the next time the thread
+         *  runs out of work.
+         */
+        void set_idle_policy(const idle_policy &p);
+
+        idle_policy get_idle_policy() const;
+
         /**
          *  @brief print debug info about the state of every context / promise.
          *
@@ -83,6 +143,49 @@ namespace fc {
             return r;
         }
 
+        /**
+         *  Calls function <code>f</code> in this thread without creating a future.
+         *
+         *  Use this for handlers whose result nobody waits on; it skips the promise
+         *  bookkeeping that async() performs.  Exceptions thrown by <code>f</code>
+         *  are logged and otherwise discarded.
+         *
+         *  @param f the operation to perform
+         *  @param prio the priority relative to other tasks
+         */
+        template<typename Functor>
+        void post(Functor &&f, const char *desc FC_TASK_NAME_DEFAULT_ARG, priority prio = priority()) {
+            typedef typename fc::deduce<Functor>::type FunctorType;
+            async_task(new fc::posted_task<FunctorType>(fc::forward<Functor>(f), desc), prio);
+        }
+
+        /**
+         *  Calls every functor of <code>functors</code> in this thread, in order.
+         *
+         *  The whole batch is published with a single atomic operation and wakes
+         *  this thread at most once, which makes it cheaper than calling async()
+         *  in a loop when a producer has several tasks ready at the same time.
+         *
+         *  @param functors a range of callables taking no arguments, each is copied
+         *  @param prio the priority of every task of the batch relative to other tasks
+         *  @return one future per functor, in the order of the range
+         */
+        template<typename Range>
+        auto async_batch(const Range &functors, const char *desc FC_TASK_NAME_DEFAULT_ARG,
+                         priority prio = priority()) -> std::vector<fc::future<decltype((*std::begin(functors))())>> {
+            typedef decltype((*std::begin(functors))()) Result;
+            typedef typename std::decay<decltype(*std::begin(functors))>::type FunctorType;
+            std::vector<fc::future<Result>> results;
+            std::vector<task_base *> tasks;
+            for (auto itr = std::begin(functors); itr != std::end(functors); ++itr) {
+                fc::task<Result, sizeof(FunctorType)> *tsk = new fc::task<Result, sizeof(FunctorType)>(*itr, desc);
+                results.push_back(fc::future<Result>(fc::shared_ptr<fc::promise<Result> >(tsk, true)));
+                tasks.push_back(tsk);
+            }
+            async_tasks(tasks, prio);
+            return results;
+        }
+
         void poke();
 
 
@@ -127,6 +230,12 @@ namespace fc {
 
         bool is_current() const;
 
+        /**
+         *  @return the handle through which deferred work reaches this thread, see
+         *  detail::thread_handle
+         */
+        const std::shared_ptr<detail::thread_handle> &handle() const;
+
         priority current_priority() const;
 
         ~thread();
@@ -151,6 +260,8 @@ namespace fc {
 
         friend class mutex;
 
+        friend class detail::thread_handle;
+
         friend void *detail::get_thread_specific_data(unsigned slot);
 
         friend void detail::set_thread_specific_data(unsigned slot, void *new_value, void(*cleanup)(void *));
@@ -195,6 +306,10 @@ namespace fc {
 
         void async_task(task_base *t, const priority &p, const time_point &tp);
 
+        void async_tasks(const std::vector<task_base *> &tasks, const priority &p);
+
+        void push_tasks(task_base *head, task_base *tail);
+
         void notify_task_has_been_canceled();
 
         void unblock(fc::context *c);
@@ -243,12 +358,87 @@ namespace fc {
         return fc::thread::current().async(fc::forward<Functor>(f), desc, prio);
     }
 
+    template<typename Functor>
+    void post(Functor &&f, const char *desc FC_TASK_NAME_DEFAULT_ARG, priority prio = priority()) {
+        fc::thread::current().post(fc::forward<Functor>(f), desc, prio);
+    }
+
     template<typename Functor>
     auto schedule(Functor &&f, const fc::time_point &t, const char *desc FC_TASK_NAME_DEFAULT_ARG,
                   priority prio = priority()) -> fc::future<decltype(f())> {
         return fc::thread::current().schedule(fc::forward<Functor>(f), t, desc, prio);
     }
 
+    namespace detail {
+        /**
+         *  Completion handler behind future::then(): once the source promise is ready it
+         *  hands the source to the continuation and queues the continuation task on the
+         *  target thread.  The continuation task is created up front so that the future
+         *  returned by then() can be canceled before the source completes.  If the target
+         *  thread has quit by then, the continuation fails with canceled_exception.
+         */
+        template<typename T>
+        struct continuation_trigger {
+            promise<T> *source;
+            std::shared_ptr<fc::shared_ptr<promise<T>>> ready_source;
+            fc::shared_ptr<task_base> pending;
+            std::shared_ptr<thread_handle> target;
+            priority prio;
+
+            template<typename... Args>
+            void operator()(const Args &...) const {
+                // the source is alive while its completion handlers run
+                *ready_source = fc::shared_ptr<promise<T>>(source, true);
+                // async_task() takes over one reference, released once the task ran
+                pending->retain();
+                if (!target->async_task(pending.get(), prio)) {
+                    pending->release();
+                    pending->set_exception(std::make_shared<canceled_exception>(
+                            FC_LOG_MESSAGE(error, "cancellation reason: continuation target thread quit")));
+                }
+            }
+        };
+
+        template<typename T, typename Functor>
+        auto then(const fc::shared_ptr<promise<T>> &source, thread &t, Functor &&f, const char *desc,
+                  priority prio) -> future<decltype(f(std::declval<future<T>>()))> {
+            typedef decltype(f(std::declval<future<T>>())) Result;
+            typedef typename fc::deduce<Functor>::type FunctorType;
+
+            std::shared_ptr<fc::shared_ptr<promise<T>>> ready_source = std::make_shared<fc::shared_ptr<promise<T>>>();
+            FunctorType func(fc::forward<Functor>(f));
+            auto body = [ready_source, func]() mutable -> Result {
+                return func(future<T>(*ready_source));
+            };
+            typedef decltype(body) BodyType;
+
+            fc::task<Result, sizeof(BodyType)> *tsk = new fc::task<Result, sizeof(BodyType)>(fc::move(body), desc);
+            fc::future<Result> r(fc::shared_ptr<fc::promise<Result> >(tsk, true));
+
+            continuation_trigger<T> trigger;
+            trigger.source = source.get();
+            trigger.ready_source = ready_source;
+            trigger.pending = fc::shared_ptr<task_base>(tsk);
+            trigger.target = t.handle();
+            trigger.prio = prio;
+            source->on_complete(fc::move(trigger));
+            return r;
+        }
+    }
+
+    template<typename T>
+    template<typename Functor>
+    auto future<T>::then(thread &t, Functor &&f, const char *desc,
+                         priority prio) -> future<decltype(f(std::declval<future<T>>()))> {
+        return detail::then(m_prom, t, fc::forward<Functor>(f), desc, prio);
+    }
+
+    template<typename Functor>
+    auto future<void>::then(thread &t, Functor &&f, const char *desc,
+                            priority prio) -> future<decltype(f(std::declval<future<void>>()))> {
+        return detail::then(m_prom, t, fc::forward<Functor>(f), desc, prio);
+    }
+
     /**
      * Call f() in thread t and block the current thread until it returns.
      *
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <fc/thread/thread.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace fc {
+    /**
+     *  @brief a fixed set of fc::threads used to spread CPU-bound work over several cores
+     *
+     *  The pool splits an index range into contiguous chunks, hands all but the first
+     *  chunk to its threads and runs the first one on the calling thread, so a pool of
+     *  N threads keeps N + 1 cores busy.  It is meant for short, independent work items
+     *  such as signature recovery or hashing, not for tasks that block.
+     */
+    class worker_pool {
+    public:
+        /**
+         *  @param threads number of worker threads, 0 picks the number of hardware threads minus one,
+         *                 which leaves a single core without workers: the caller does all the work
+         *  @param name prefix for the names of the worker threads
+         */
+        explicit worker_pool(uint32_t threads = 0, const std::string &name = "worker");
+
+        ~worker_pool();
+
+        /// number of worker threads, not counting the calling thread
+        uint32_t size() const;
+
+        /**
+         *  Calls <code>f(begin, end)</code> for consecutive sub-ranges covering [0, count) and
+         *  returns once every call has finished.  Ranges are never shorter than
+         *  <code>min_chunk</code> items unless they are the last one.
+         *
+         *  If any call throws, the first exception (in range order) is rethrown after all
+         *  calls have finished.
+         */
+        void for_each_range(size_t count, const std::function<void(size_t, size_t)> &f, size_t min_chunk = 1);
+
+        /**
+         *  Returns the process-wide pool used by the batch APIs when no pool is passed
+         *  explicitly.  It is created on first use with set_default_size() threads.
+         */
+        static worker_pool &get_default();
+
+        /**
+         *  Sets the number of threads of the default pool; must be called before the first
+         *  call to get_default().  0 (the default) picks the number of hardware threads minus one,
+         *  none on a single core.
+         */
+        static void set_default_size(uint32_t threads);
+
+    private:
+        worker_pool(const worker_pool &) = delete;
+
+        worker_pool &operator=(const worker_pool &) = delete;
+
+        std::vector<std::unique_ptr<fc::thread>> _threads;
+    };
+} // namespace fc
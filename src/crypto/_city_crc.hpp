@@ -0,0 +1,181 @@
+#pragma once
+
+// Copyright (c) 2011 Google, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// CityHashCrc256 from city.cpp, made a template over the CRC-32C step so it
+// can be compiled once per instruction set: Crc::u64(crc, v) must return the
+// CRC-32C of the 8 bytes of v appended to the 32 bit register crc.  The
+// helpers have internal linkage since each includer builds them for its own
+// target, and nothing here may instantiate library templates (std::swap
+// included): their weak copies would be built for that target too, and the
+// linker is free to keep one of them for every caller.
+
+#include <cstdint>
+#include <cstring>
+
+namespace fc { namespace detail {
+
+namespace {
+
+namespace city_crc {
+
+const uint64_t k0 = 0xc3a5c85c97cb3127ULL;
+
+inline uint64_t Fetch64(const char *p) {
+  uint64_t result;
+  memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+inline uint64_t Rotate(uint64_t val, int shift) {
+  return shift == 0 ? val : ((val >> shift) | (val << (64 - shift)));
+}
+
+inline uint64_t ShiftMix(uint64_t val) {
+  return val ^ (val >> 47);
+}
+
+// Hash128to64 of the fc::uint128_t with high bits u and low bits v, as city.cpp does
+inline uint64_t HashLen16(uint64_t u, uint64_t v) {
+  const uint64_t kMul = 0x9ddfea08eb382d69ULL;
+  uint64_t a = (v ^ u) * kMul;
+  a ^= (a >> 47);
+  uint64_t b = (u ^ a) * kMul;
+  b ^= (b >> 47);
+  b *= kMul;
+  return b;
+}
+
+inline void Swap(uint64_t &a, uint64_t &b) {
+  uint64_t t = a;
+  a = b;
+  b = t;
+}
+
+#define CITY_CRC_PERMUTE3(a, b, c) do { Swap(a, b); Swap(a, c); } while (0)
+
+// Requires len >= 240.
+template<typename Crc>
+void CityHashCrc256Long(const char *s, size_t len, uint32_t seed, uint64_t *result) {
+  uint64_t a = Fetch64(s + 56) + k0;
+  uint64_t b = Fetch64(s + 96) + k0;
+  uint64_t c = result[0] = HashLen16(b, len);
+  uint64_t d = result[1] = Fetch64(s + 120) * k0 + len;
+  uint64_t e = Fetch64(s + 184) + seed;
+  uint64_t f = 0;
+  uint64_t g = 0;
+  uint64_t h = c + d;
+  uint64_t x = seed;
+  uint64_t y = 0;
+  uint64_t z = 0;
+
+  // 240 bytes of input per iter.
+  size_t iters = len / 240;
+  len -= iters * 240;
+  do {
+#define CITY_CRC_CHUNK(r)                       \
+    CITY_CRC_PERMUTE3(x, z, y);                 \
+    b += Fetch64(s);                            \
+    c += Fetch64(s + 8);                        \
+    d += Fetch64(s + 16);                       \
+    e += Fetch64(s + 24);                       \
+    f += Fetch64(s + 32);                       \
+    a += b;                                     \
+    h += f;                                     \
+    b += c;                                     \
+    f += d;                                     \
+    g += e;                                     \
+    e += z;                                     \
+    g += x;                                     \
+    z = Crc::u64(z, b + g);                     \
+    y = Crc::u64(y, e + h);                     \
+    x = Crc::u64(x, f + a);                     \
+    e = Rotate(e, r);                           \
+    c += e;                                     \
+    s += 40
+
+    CITY_CRC_CHUNK(0); CITY_CRC_PERMUTE3(a, h, c);
+    CITY_CRC_CHUNK(33); CITY_CRC_PERMUTE3(a, h, f);
+    CITY_CRC_CHUNK(0); CITY_CRC_PERMUTE3(b, h, f);
+    CITY_CRC_CHUNK(42); CITY_CRC_PERMUTE3(b, h, d);
+    CITY_CRC_CHUNK(0); CITY_CRC_PERMUTE3(b, h, e);
+    CITY_CRC_CHUNK(33); CITY_CRC_PERMUTE3(a, h, e);
+  } while (--iters > 0);
+
+  while (len >= 40) {
+    CITY_CRC_CHUNK(29);
+    e ^= Rotate(a, 20);
+    h += Rotate(b, 30);
+    g ^= Rotate(c, 40);
+    f += Rotate(d, 34);
+    CITY_CRC_PERMUTE3(c, h, g);
+    len -= 40;
+  }
+  if (len > 0) {
+    s = s + len - 40;
+    CITY_CRC_CHUNK(33);
+    e ^= Rotate(a, 43);
+    h += Rotate(b, 42);
+    g ^= Rotate(c, 41);
+    f += Rotate(d, 40);
+  }
+#undef CITY_CRC_CHUNK
+  result[0] ^= h;
+  result[1] ^= g;
+  g += h;
+  a = HashLen16(a, g + z);
+  x += y << 32;
+  b += x;
+  c = HashLen16(c, z) + h;
+  d = HashLen16(d, e + result[0]);
+  g += e;
+  h += HashLen16(x, f);
+  e = HashLen16(a, d) + g;
+  z = HashLen16(b, c) + a;
+  y = HashLen16(g, h) + c;
+  result[0] = e + z + y + x;
+  a = ShiftMix((a + y) * k0) * k0 + b;
+  result[1] += a + result[0];
+  a = ShiftMix(a * k0) * k0 + c;
+  result[2] = a + result[1];
+  a = ShiftMix((a + e) * k0) * k0;
+  result[3] = a + result[2];
+}
+
+#undef CITY_CRC_PERMUTE3
+
+} // city_crc
+
+template<typename Crc>
+void city_hash_crc256(const char *s, size_t len, uint64_t *result) {
+  if (len >= 240) {
+    city_crc::CityHashCrc256Long<Crc>(s, len, 0, result);
+  } else {
+    char buf[240];
+    memcpy(buf, s, len);
+    memset(buf + len, 0, 240 - len);
+    city_crc::CityHashCrc256Long<Crc>(buf, 240, ~static_cast<uint32_t>(len), result);
+  }
+}
+
+} // anonymous
+
+} } // fc::detail
@@ -0,0 +1,25 @@
+#pragma once
+
+/* Instruction set extensions available at run time, used to pick between
+ * the hand-vectorized code paths of the crypto primitives.
+ */
+namespace fc { namespace detail {
+
+struct cpu_features
+{
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool sse42 = false;
+    bool avx2 = false;          ///< also implies the OS saves the ymm registers
+    bool avx512f = false;       ///< also implies the OS saves the zmm registers
+    bool avx512bw = false;
+    bool sha_ni = false;
+    bool arm_crc32 = false;
+    bool arm_sha2 = false;
+};
+
+/** detected once, on first use */
+const cpu_features& get_cpu_features();
+
+}} // fc::detail
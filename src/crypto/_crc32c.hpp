@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* CRC-32C (Castagnoli) in several versions: the slicing-by-8 tables of
+ * crc.cpp and the CRC instructions of SSE4.2 and ARMv8, each in a file
+ * compiled for its instruction set.  get_crc32c_engine() picks one once.
+ * The functions here work on the raw register, without the pre and post
+ * inversion of fc::crc32c(), which is how the CityHashCrc variants use it.
+ */
+
+// software CRC-32C from crc.cpp
+uint32_t crc32cSlicingBy8( uint32_t crc, const void* data, size_t length );
+
+namespace fc { namespace detail {
+
+struct crc32c_engine
+{
+    uint32_t (*update)( uint32_t crc, const uint8_t* data, size_t len );
+    /** CityHashCrc256 built on the same CRC instructions */
+    void (*city_hash_crc256)( const char* s, size_t len, uint64_t* result );
+    const char* name;
+};
+
+uint32_t crc32c_update_portable( uint32_t crc, const uint8_t* data, size_t len );
+void city_hash_crc256_portable( const char* s, size_t len, uint64_t* result );
+#if defined(__x86_64__) || defined(_M_X64)
+uint32_t crc32c_update_sse42( uint32_t crc, const uint8_t* data, size_t len );
+void city_hash_crc256_sse42( const char* s, size_t len, uint64_t* result );
+#endif
+#if defined(__aarch64__)
+uint32_t crc32c_update_armv8( uint32_t crc, const uint8_t* data, size_t len );
+void city_hash_crc256_armv8( const char* s, size_t len, uint64_t* result );
+#endif
+
+const crc32c_engine& get_crc32c_engine();
+
+/** lookup tables appending a fixed number of zero bytes to a CRC, one per byte of the register */
+struct crc32c_zeros
+{
+    uint32_t table[4][256];
+};
+
+/** the hardware loops run three streams of crc32c_long_block or crc32c_short_block bytes */
+const size_t crc32c_long_block = 8192;
+const size_t crc32c_short_block = 256;
+
+const crc32c_zeros& crc32c_zeros_long();
+const crc32c_zeros& crc32c_zeros_short();
+
+namespace {
+
+inline uint32_t crc32c_shift( const crc32c_zeros& zeros, uint32_t crc )
+{
+    return zeros.table[0][crc & 0xff] ^ zeros.table[1][( crc >> 8 ) & 0xff] ^
+           zeros.table[2][( crc >> 16 ) & 0xff] ^ zeros.table[3][crc >> 24];
+}
+
+inline uint64_t crc32c_load64( const uint8_t* p )
+{
+    uint64_t v;
+    memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+/**
+ *  Three interleaved streams of Block bytes, so the CRC instruction, with its latency
+ *  of three cycles and throughput of one, is kept busy.  The CRCs of the second and
+ *  third streams are merged by shifting the running one over the bytes after it.
+ */
+template<typename Crc>
+inline void crc32c_streams( uint32_t& crc0, const uint8_t*& next, size_t& len, size_t block, const crc32c_zeros& zeros )
+{
+    while( len >= 3 * block )
+    {
+        uint64_t c0 = crc0, c1 = 0, c2 = 0;
+        const uint8_t* end = next + block;
+        do
+        {
+            c0 = Crc::u64( c0, crc32c_load64( next ) );
+            c1 = Crc::u64( c1, crc32c_load64( next + block ) );
+            c2 = Crc::u64( c2, crc32c_load64( next + 2 * block ) );
+            next += 8;
+        } while( next < end );
+        crc0 = crc32c_shift( zeros, uint32_t( c0 ) ) ^ uint32_t( c1 );
+        crc0 = crc32c_shift( zeros, crc0 ) ^ uint32_t( c2 );
+        next += 2 * block;
+        len -= 3 * block;
+    }
+}
+
+template<typename Crc>
+inline uint32_t crc32c_hardware( uint32_t crc, const uint8_t* next, size_t len )
+{
+    while( len && ( uintptr_t( next ) & 7 ) )
+    {
+        crc = Crc::u8( crc, *next++ );
+        --len;
+    }
+    if( len >= 3 * crc32c_long_block )
+        crc32c_streams<Crc>( crc, next, len, crc32c_long_block, crc32c_zeros_long() );
+    if( len >= 3 * crc32c_short_block )
+        crc32c_streams<Crc>( crc, next, len, crc32c_short_block, crc32c_zeros_short() );
+    uint64_t c = crc;
+    for( ; len >= 8; len -= 8, next += 8 )
+        c = Crc::u64( c, crc32c_load64( next ) );
+    crc = uint32_t( c );
+    while( len-- )
+        crc = Crc::u8( crc, *next++ );
+    return crc;
+}
+
+} // anonymous
+
+} } // fc::detail
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* fc's own implementation of the Merkle-Damgard digests (SHA-1, SHA-224/256,
+ * SHA-512 and RIPEMD-160).  Buffering and padding live in md_context below;
+ * the block compression comes from get_digest_engine().  It uses OpenSSL's
+ * compression functions unless fc has a measurably faster one for the CPU:
+ * the SHA extensions for SHA-1 and SHA-256 (digest_engine_shani.cpp, compiled
+ * with the matching target flags) and the unrolled RIPEMD-160 below, which
+ * beats OpenSSL's C code.  The helpers here are compiled for different
+ * targets as well, so they have internal linkage.
+ */
+
+namespace fc { namespace detail {
+
+/** compresses <code>blocks</code> consecutive message blocks into state */
+typedef void (*compress32_fn)( uint32_t* state, const uint8_t* data, size_t blocks );
+typedef void (*compress64_fn)( uint64_t* state, const uint8_t* data, size_t blocks );
+
+void sha1_compress_openssl( uint32_t* state, const uint8_t* data, size_t blocks );
+void sha256_compress_openssl( uint32_t* state, const uint8_t* data, size_t blocks );
+void sha512_compress_openssl( uint64_t* state, const uint8_t* data, size_t blocks );
+void ripemd160_compress_portable( uint32_t* state, const uint8_t* data, size_t blocks );
+#if defined(__x86_64__) || defined(_M_X64)
+void sha1_compress_shani( uint32_t* state, const uint8_t* data, size_t blocks );
+void sha256_compress_shani( uint32_t* state, const uint8_t* data, size_t blocks );
+#endif
+
+template<typename Fn>
+struct digest_backend
+{
+    Fn          compress;
+    const char* name;
+};
+
+struct digest_engine
+{
+    digest_backend<compress32_fn> sha1;
+    digest_backend<compress32_fn> sha256;      ///< also used by SHA-224
+    digest_backend<compress64_fn> sha512;
+    digest_backend<compress32_fn> ripemd160;
+};
+
+/** the compression functions used on this CPU, chosen once */
+const digest_engine& get_digest_engine();
+
+namespace {
+
+const uint32_t sha1_h0[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+const uint32_t sha224_h0[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4 };
+
+const uint32_t sha256_h0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+const uint64_t sha512_h0[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL };
+
+const uint32_t ripemd160_h0[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+inline uint32_t load_be32( const uint8_t* p )
+{
+    return ( uint32_t(p[0]) << 24 ) | ( uint32_t(p[1]) << 16 ) | ( uint32_t(p[2]) << 8 ) | uint32_t(p[3]);
+}
+
+inline uint32_t load_le32( const uint8_t* p )
+{
+    return uint32_t(p[0]) | ( uint32_t(p[1]) << 8 ) | ( uint32_t(p[2]) << 16 ) | ( uint32_t(p[3]) << 24 );
+}
+
+inline void store_be32( uint8_t* p, uint32_t v )
+{
+    p[0] = uint8_t( v >> 24 );
+    p[1] = uint8_t( v >> 16 );
+    p[2] = uint8_t( v >> 8 );
+    p[3] = uint8_t( v );
+}
+
+inline void store_le32( uint8_t* p, uint32_t v )
+{
+    p[0] = uint8_t( v );
+    p[1] = uint8_t( v >> 8 );
+    p[2] = uint8_t( v >> 16 );
+    p[3] = uint8_t( v >> 24 );
+}
+
+inline void store_be64( uint8_t* p, uint64_t v )
+{
+    store_be32( p, uint32_t( v >> 32 ) );
+    store_be32( p + 4, uint32_t( v ) );
+}
+
+inline void store_le64( uint8_t* p, uint64_t v )
+{
+    store_le32( p, uint32_t( v ) );
+    store_le32( p + 4, uint32_t( v >> 32 ) );
+}
+
+inline uint32_t rotl32( uint32_t x, int n )
+{
+    return ( x << n ) | ( x >> ( 32 - n ) );
+}
+
+inline uint32_t rotr32( uint32_t x, int n )
+{
+    return ( x >> n ) | ( x << ( 32 - n ) );
+}
+
+/**
+ *  Calls <code>f.template step<I>()</code> for I in [I, End), unrolled at compile time so
+ *  that round constants, message indices and rotation counts become immediates and
+ *  the working variables stay in registers.
+ */
+template<int I, int End>
+struct unrolled
+{
+    template<typename F>
+    static inline void run( F& f )
+    {
+        f.template step<I>();
+        unrolled<I + 1, End>::run( f );
+    }
+};
+
+template<int End>
+struct unrolled<End, End>
+{
+    template<typename F>
+    static inline void run( F& ) {}
+};
+
+template<typename Word>
+struct sha2_words;
+
+template<>
+struct sha2_words<uint32_t>
+{
+    static uint32_t sigma0( uint32_t x ) { return rotr32( x, 7 ) ^ rotr32( x, 18 ) ^ ( x >> 3 ); }
+    static uint32_t sigma1( uint32_t x ) { return rotr32( x, 17 ) ^ rotr32( x, 19 ) ^ ( x >> 10 ); }
+    static uint32_t big_sigma0( uint32_t x ) { return rotr32( x, 2 ) ^ rotr32( x, 13 ) ^ rotr32( x, 22 ); }
+    static uint32_t big_sigma1( uint32_t x ) { return rotr32( x, 6 ) ^ rotr32( x, 11 ) ^ rotr32( x, 25 ); }
+    static uint32_t k( int i ) { return sha256_k[i]; }
+};
+
+/** one round of SHA-256; the caller rotates the roles of the variables */
+template<typename Word>
+inline void sha2_round( Word a, Word b, Word c, Word& d, Word e, Word f, Word g, Word& h, Word kw )
+{
+    typedef sha2_words<Word> words;
+    Word t1 = h + words::big_sigma1( e ) + ( g ^ ( e & ( f ^ g ) ) ) + kw;
+    d += t1;
+    h = t1 + words::big_sigma0( a ) + ( ( a & b ) | ( c & ( a | b ) ) );
+}
+
+/** the rounds of SHA-256; kw holds the message schedule plus the round constants */
+template<typename Word, int Rounds>
+inline void sha2_rounds( Word state[8], const Word* kw )
+{
+    Word a = state[0], b = state[1], c = state[2], d = state[3];
+    Word e = state[4], f = state[5], g = state[6], h = state[7];
+    for( int i = 0; i < Rounds; i += 8 )
+    {
+        sha2_round( a, b, c, d, e, f, g, h, kw[i] );
+        sha2_round( h, a, b, c, d, e, f, g, kw[i + 1] );
+        sha2_round( g, h, a, b, c, d, e, f, kw[i + 2] );
+        sha2_round( f, g, h, a, b, c, d, e, kw[i + 3] );
+        sha2_round( e, f, g, h, a, b, c, d, kw[i + 4] );
+        sha2_round( d, e, f, g, h, a, b, c, kw[i + 5] );
+        sha2_round( c, d, e, f, g, h, a, b, kw[i + 6] );
+        sha2_round( b, c, d, e, f, g, h, a, kw[i + 7] );
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+/** expands the first 16 words of w into the full schedule and compresses it */
+template<typename Word, int Rounds>
+inline void sha2_block( Word state[8], Word w[Rounds] )
+{
+    typedef sha2_words<Word> words;
+    for( int i = 16; i < Rounds; ++i )
+        w[i] = w[i-16] + words::sigma0( w[i-15] ) + w[i-7] + words::sigma1( w[i-2] );
+    for( int i = 0; i < Rounds; ++i )
+        w[i] += words::k( i );
+    sha2_rounds<Word, Rounds>( state, w );
+}
+
+/** one SHA-256 compression of a 64 byte block into state */
+inline void sha256_block( uint32_t state[8], const uint8_t* block )
+{
+    uint32_t w[64];
+    for( int i = 0; i < 16; ++i )
+        w[i] = load_be32( block + 4 * i );
+    sha2_block<uint32_t, 64>( state, w );
+}
+
+const uint8_t ripemd160_rl[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13 };
+const uint8_t ripemd160_rr[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11 };
+const uint8_t ripemd160_sl[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6 };
+const uint8_t ripemd160_sr[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11 };
+
+/** the five boolean functions of RIPEMD-160, the left line uses them in order, the right one in reverse */
+template<int F>
+inline uint32_t ripemd160_f( uint32_t x, uint32_t y, uint32_t z )
+{
+    return F == 0 ? x ^ y ^ z :
+           F == 1 ? ( x & y ) | ( ~x & z ) :
+           F == 2 ? ( x | ~y ) ^ z :
+           F == 3 ? ( x & z ) | ( y & ~z ) :
+                    x ^ ( y | ~z );
+}
+
+/** both lines of RIPEMD-160 side by side, step I of each */
+struct ripemd160_rounds
+{
+    uint32_t l[5];              // a..e of the left line, renamed like sha2_rounds
+    uint32_t r[5];
+    uint32_t x[16];
+
+    template<int I>
+    inline void step()
+    {
+        static const uint32_t kl[5] = { 0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e };
+        static const uint32_t kr[5] = { 0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000 };
+        const int round = I / 16;
+        line<I, round>( l, ripemd160_f<round>, x[ripemd160_rl[I]] + kl[round], ripemd160_sl[I] );
+        line<I, round>( r, ripemd160_f<4 - round>, x[ripemd160_rr[I]] + kr[round], ripemd160_sr[I] );
+    }
+
+    /** variable x of step I lives in v[(x - I) mod 5] */
+    template<int I, int Round, typename F>
+    static inline void line( uint32_t v[5], F f, uint32_t xk, int s )
+    {
+        uint32_t& a = v[( 500 - I ) % 5];
+        uint32_t& b = v[( 501 - I ) % 5];
+        uint32_t& c = v[( 502 - I ) % 5];
+        uint32_t& d = v[( 503 - I ) % 5];
+        uint32_t& e = v[( 504 - I ) % 5];
+        a = rotl32( a + f( b, c, d ) + xk, s ) + e;
+        c = rotl32( c, 10 );
+    }
+};
+
+/** one RIPEMD-160 compression of a 64 byte block into state */
+inline void ripemd160_block( uint32_t state[5], const uint8_t* block )
+{
+    ripemd160_rounds rounds;
+    for( int i = 0; i < 16; ++i )
+        rounds.x[i] = load_le32( block + 4 * i );
+    for( int i = 0; i < 5; ++i )
+        rounds.l[i] = rounds.r[i] = state[i];
+    unrolled<0, 80>::run( rounds );
+
+    // after 80 steps the renaming is back at its start (80 is a multiple of 5)
+    const uint32_t* l = rounds.l;
+    const uint32_t* r = rounds.r;
+    uint32_t t = state[1] + l[2] + r[3];
+    state[1] = state[2] + l[3] + r[4];
+    state[2] = state[3] + l[4] + r[0];
+    state[3] = state[4] + l[0] + r[1];
+    state[4] = state[0] + l[1] + r[2];
+    state[0] = t;
+}
+
+inline void store_word( uint8_t* p, uint32_t v, bool big_endian )
+{
+    if( big_endian )
+        store_be32( p, v );
+    else
+        store_le32( p, v );
+}
+
+inline void store_word( uint8_t* p, uint64_t v, bool )
+{
+    store_be64( p, v );
+}
+
+/**
+ *  Streaming state of a Merkle-Damgard hash: the chaining value and the number of
+ *  bytes compressed into it.  The partial block lives in the encoder, which fills
+ *  it inline and only calls write() once a block is complete.  BigEndian selects
+ *  the SHA conventions, otherwise the length and the digest are little endian as
+ *  in RIPEMD-160.  Blocks of 128 bytes (SHA-512) carry a 128 bit length, of which
+ *  only the low 67 bits can be set here.
+ */
+template<typename Word, unsigned StateWords, unsigned BlockSize, bool BigEndian>
+struct md_context
+{
+    typedef void (*compress_fn)( Word* state, const uint8_t* data, size_t blocks );
+
+    uint64_t length;                 ///< bytes compressed so far
+    Word     state[StateWords];
+
+    void init( const Word* iv )
+    {
+        length = 0;
+        memcpy( state, iv, sizeof(state) );
+    }
+
+    /** appends n bytes to a message whose last <code>used</code> bytes wait in block */
+    void write( compress_fn compress, char* block, uint32_t& used, const char* d, size_t n )
+    {
+        const uint8_t* p = (const uint8_t*)d;
+        if( used )
+        {
+            size_t take = BlockSize - used < n ? BlockSize - used : n;
+            memcpy( block + used, p, take );
+            used += take;
+            p += take;
+            n -= take;
+            if( used < BlockSize )
+                return;
+            compress( state, (const uint8_t*)block, 1 );
+            length += BlockSize;
+            used = 0;
+        }
+        if( n >= BlockSize )
+        {
+            size_t blocks = n / BlockSize;
+            compress( state, p, blocks );
+            length += blocks * BlockSize;
+            p += blocks * BlockSize;
+            n -= blocks * BlockSize;
+        }
+        if( n )
+        {
+            memcpy( block, p, n );
+            used = n;
+        }
+    }
+
+    /** pads the message and writes the first <code>out_words</code> words of the digest */
+    void finish( compress_fn compress, char* block, uint32_t used, char* out, unsigned out_words )
+    {
+        const unsigned length_size = BlockSize / 8;
+        uint8_t* buffer = (uint8_t*)block;
+        const uint64_t total = length + used;
+        buffer[used++] = 0x80;
+        if( used > BlockSize - length_size )
+        {
+            memset( buffer + used, 0, BlockSize - used );
+            compress( state, buffer, 1 );
+            used = 0;
+        }
+        memset( buffer + used, 0, BlockSize - used );
+        if( BigEndian )
+        {
+            store_be64( buffer + BlockSize - 8, total << 3 );
+            if( length_size == 16 )
+                store_be64( buffer + BlockSize - 16, total >> 61 );
+        }
+        else
+            store_le64( buffer + BlockSize - 8, total << 3 );
+        compress( state, buffer, 1 );
+
+        for( unsigned i = 0; i < out_words; ++i )
+            store_word( (uint8_t*)out + i * sizeof(Word), state[i], BigEndian );
+    }
+};
+
+typedef md_context<uint32_t, 5, 64, true>   sha1_context;
+typedef md_context<uint32_t, 8, 64, true>   sha256_context;
+typedef md_context<uint64_t, 8, 128, true>  sha512_context;
+typedef md_context<uint32_t, 5, 64, false>  ripemd160_context;
+
+}
+
+} } // fc::detail
@@ -30,4 +30,7 @@ class public_key_impl
         void free_key() BOOST_NOEXCEPT;
 };
 
+/* the EC_KEY of public_key_impl is already decoded, decompressed_public_key keeps nothing besides */
+class public_key_point_impl {};
+
 }}}
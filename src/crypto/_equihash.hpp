@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* The Equihash solver behind fc::equihash::proof::hash() and the BLAKE2b
+ * it runs on.  Every index of a proof is hashed with the same 24 byte input,
+ * the 4 seed words, the nonce and the index, so the hashers take a list of
+ * indexes and compute one digest per index, several at a time where the CPU
+ * allows.  The results are those of the vendored blake2b() with a 32 byte
+ * digest, as _POW::Proof uses for validation.  equihash_blake2b_avx2.cpp
+ * is compiled for AVX2, so this header keeps to plain types and internal
+ * linkage; the solver is declared in _equihash_solver.hpp.
+ */
+
+namespace fc { namespace detail {
+
+struct equihash_hasher
+{
+    /** writes the 8 digest words of each of the count indexes to out */
+    void (*hash)( const uint32_t* seed, uint32_t nonce, const uint32_t* indexes, size_t count, uint32_t* out );
+    const char* name;
+};
+
+void equihash_hash_portable( const uint32_t* seed, uint32_t nonce, const uint32_t* indexes, size_t count, uint32_t* out );
+#if defined(__x86_64__) || defined(_M_X64)
+void equihash_hash_avx2( const uint32_t* seed, uint32_t nonce, const uint32_t* indexes, size_t count, uint32_t* out );
+#endif
+
+/** the hasher used on this CPU, chosen once */
+const equihash_hasher& get_equihash_hasher();
+
+namespace {
+
+const uint64_t blake2b_iv[8] =
+{
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+const uint8_t blake2b_sigma[12][16] =
+{
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+/** the parameter block for a 32 byte digest without key, folded into the first IV word */
+const uint64_t equihash_blake2b_param = 0x01010020;
+
+/** the input is a single 24 byte block */
+const uint64_t equihash_blake2b_input_length = 24;
+
+} // anonymous
+
+} } // fc::detail
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "_equihash.hpp"
+
+#include <vector>
+
+namespace fc {
+
+class worker_pool;
+
+namespace detail {
+
+/**
+ *  Runs Wagner's algorithm with the bucket sizes and limits of the vendored
+ *  _POW::Equihash::FindProof(nonce) and returns the same solution it would,
+ *  before canonization, or nothing if there is none.
+ */
+std::vector<uint32_t> equihash_solve( unsigned n, unsigned k, const uint32_t* seed, uint32_t nonce, worker_pool& pool );
+
+} } // fc::detail
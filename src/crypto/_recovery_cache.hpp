@@ -0,0 +1,13 @@
+#pragma once
+#include <fc/crypto/elliptic.hpp>
+
+/* hooks used by the public_key(compact_signature, ...) constructors of every ecc implementation */
+
+namespace fc { namespace ecc { namespace detail {
+
+/** @return true and sets @p key if the key for (@p c, @p digest) is cached */
+bool find_recovered_key( const compact_signature& c, const fc::sha256& digest, public_key_data& key );
+
+void remember_recovered_key( const compact_signature& c, const fc::sha256& digest, const public_key_data& key );
+
+}}}
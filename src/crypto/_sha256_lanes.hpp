@@ -0,0 +1,240 @@
+#pragma once
+
+#include "_digest_engine.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Multi-buffer SHA-256: hashes several independent messages in lockstep, one
+ * message per SIMD lane.  Every sha256_lanes_*.cpp file instantiates
+ * lane_engine with the vector operations of one instruction set and is compiled
+ * with the matching target flags, so everything here has internal linkage to
+ * keep code built for different targets from being merged by the linker.  For
+ * the same reason the kernels see digests as plain bytes: fc::sha256 and its
+ * header bring inline functions whose weak copies would be built for the
+ * kernel's target as well.
+ */
+
+namespace fc { namespace detail {
+
+/** hashes data[i] (sizes[i] bytes) into the 32 bytes at out + 32 * i for i in [0, count) */
+typedef void (*sha256_many_fn)( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out );
+
+void sha256_many_portable( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out );
+#if defined(__x86_64__) || defined(_M_X64)
+void sha256_many_sse2( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out );
+void sha256_many_avx2( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out );
+void sha256_many_avx512( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out );
+#endif
+
+struct sha256_many_impl
+{
+    sha256_many_fn fn;
+    const char*    name;
+};
+
+/** the fastest implementation for this CPU, chosen on first use */
+const sha256_many_impl& select_sha256_many();
+
+namespace {
+
+inline void store_digest( const uint32_t state[8], uint8_t* out )
+{
+    for( int i = 0; i < 8; ++i )
+        store_be32( out + 4 * i, state[i] );
+}
+
+/** walks one message block by block, producing the padding blocks at the end */
+struct message_cursor
+{
+    const uint8_t* data = nullptr;
+    uint64_t       full_blocks = 0;   // complete 64 byte blocks taken directly from data
+    uint32_t       tail_blocks = 0;   // 1 or 2 blocks holding the remaining bytes and the padding
+    uint64_t       next = 0;          // index of the next block to hand out
+    uint8_t        tail[128];
+
+    void reset( const char* d, uint32_t size )
+    {
+        data = (const uint8_t*)d;
+        full_blocks = size / 64;
+        uint32_t rest = size % 64;
+        tail_blocks = rest + 9 <= 64 ? 1 : 2;
+        next = 0;
+
+        memset( tail, 0, sizeof(tail) );
+        if( rest )
+            memcpy( tail, data + full_blocks * 64, rest );
+        tail[rest] = 0x80;
+        uint64_t bits = uint64_t(size) * 8;
+        uint8_t* len = tail + tail_blocks * 64 - 8;
+        store_be32( len, uint32_t( bits >> 32 ) );
+        store_be32( len + 4, uint32_t( bits ) );
+    }
+
+    uint64_t blocks_left()const
+    {
+        return full_blocks + tail_blocks - next;
+    }
+
+    const uint8_t* next_block()
+    {
+        uint64_t i = next++;
+        return i < full_blocks ? data + i * 64 : tail + ( i - full_blocks ) * 64;
+    }
+};
+
+/**
+ *  Three-input functions of SHA-256 built from two-input vector operations, for
+ *  instruction sets without a ternary logic instruction.
+ */
+template<typename Ops>
+struct basic_ternary_ops
+{
+    template<typename V>
+    static V xor3( V a, V b, V c )
+    {
+        return Ops::bxor( Ops::bxor( a, b ), c );
+    }
+
+    template<typename V>
+    static V ch( V e, V f, V g )
+    {
+        return Ops::bxor( Ops::band( e, f ), Ops::bandnot( e, g ) );
+    }
+
+    template<typename V>
+    static V maj( V a, V b, V c )
+    {
+        return Ops::bor( Ops::band( a, b ), Ops::band( c, Ops::bor( a, b ) ) );
+    }
+};
+
+/**
+ *  Runs Ops::lanes SHA-256 computations side by side.  Ops provides a vector type
+ *  with one 32 bit word per lane and the handful of operations SHA-256 needs.
+ *  Whenever a lane finishes its message it picks up the next pending one, so
+ *  messages of different lengths keep all lanes busy until the input runs dry.
+ */
+template<typename Ops>
+struct lane_engine
+{
+    typedef typename Ops::vec vec;
+    static const int lanes = Ops::lanes;
+
+    template<int N>
+    static vec rotr( vec x )
+    {
+        return Ops::template rotr<N>( x );
+    }
+
+    /** compresses one block per lane; blocks[l] is the block of lane l */
+    static void compress( uint32_t state[8][lanes], const uint8_t* const blocks[lanes] )
+    {
+        vec w[16];
+        for( int i = 0; i < 16; ++i )
+        {
+            alignas(64) uint32_t words[lanes];
+            for( int l = 0; l < lanes; ++l )
+                words[l] = load_be32( blocks[l] + 4 * i );
+            w[i] = Ops::load( words );
+        }
+
+        vec a = Ops::load( state[0] ), b = Ops::load( state[1] ), c = Ops::load( state[2] ), d = Ops::load( state[3] );
+        vec e = Ops::load( state[4] ), f = Ops::load( state[5] ), g = Ops::load( state[6] ), h = Ops::load( state[7] );
+        for( int i = 0; i < 64; ++i )
+        {
+            vec wi;
+            if( i < 16 )
+                wi = w[i];
+            else
+            {
+                vec w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+                vec s0 = Ops::xor3( rotr<7>( w15 ), rotr<18>( w15 ), Ops::template shr<3>( w15 ) );
+                vec s1 = Ops::xor3( rotr<17>( w2 ), rotr<19>( w2 ), Ops::template shr<10>( w2 ) );
+                wi = Ops::add( Ops::add( w[i & 15], s0 ), Ops::add( w[(i - 7) & 15], s1 ) );
+                w[i & 15] = wi;
+            }
+            vec s1 = Ops::xor3( rotr<6>( e ), rotr<11>( e ), rotr<25>( e ) );
+            vec t1 = Ops::add( Ops::add( Ops::add( h, s1 ), Ops::add( Ops::ch( e, f, g ), Ops::set1( sha256_k[i] ) ) ), wi );
+            vec s0 = Ops::xor3( rotr<2>( a ), rotr<13>( a ), rotr<22>( a ) );
+            vec t2 = Ops::add( s0, Ops::maj( a, b, c ) );
+            h = g; g = f; f = e; e = Ops::add( d, t1 );
+            d = c; c = b; b = a; a = Ops::add( t1, t2 );
+        }
+        Ops::store( state[0], Ops::add( a, Ops::load( state[0] ) ) );
+        Ops::store( state[1], Ops::add( b, Ops::load( state[1] ) ) );
+        Ops::store( state[2], Ops::add( c, Ops::load( state[2] ) ) );
+        Ops::store( state[3], Ops::add( d, Ops::load( state[3] ) ) );
+        Ops::store( state[4], Ops::add( e, Ops::load( state[4] ) ) );
+        Ops::store( state[5], Ops::add( f, Ops::load( state[5] ) ) );
+        Ops::store( state[6], Ops::add( g, Ops::load( state[6] ) ) );
+        Ops::store( state[7], Ops::add( h, Ops::load( state[7] ) ) );
+    }
+
+    static void run( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out )
+    {
+        alignas(64) uint32_t state[8][lanes];
+        message_cursor cursor[lanes];
+        size_t message[lanes];
+        bool active[lanes];
+        static const uint8_t idle_block[64] = {};
+
+        size_t pending = 0;
+        int busy = 0;
+        auto start = [&]( int l ) {
+            if( pending == count )
+            {
+                active[l] = false;
+                return;
+            }
+            message[l] = pending;
+            cursor[l].reset( data[pending], sizes[pending] );
+            ++pending;
+            for( int i = 0; i < 8; ++i )
+                state[i][l] = sha256_h0[i];
+            active[l] = true;
+            ++busy;
+        };
+        for( int l = 0; l < lanes; ++l )
+            start( l );
+
+        // once a single lane is left a scalar compression is cheaper than a full vector step
+        while( busy > 1 || ( busy == 1 && pending < count ) )
+        {
+            const uint8_t* blocks[lanes];
+            for( int l = 0; l < lanes; ++l )
+                blocks[l] = active[l] ? cursor[l].next_block() : idle_block;
+            compress( state, blocks );
+
+            for( int l = 0; l < lanes; ++l )
+            {
+                if( active[l] && !cursor[l].blocks_left() )
+                {
+                    uint32_t digest[8];
+                    for( int i = 0; i < 8; ++i )
+                        digest[i] = state[i][l];
+                    store_digest( digest, out + 32 * message[l] );
+                    --busy;
+                    start( l );
+                }
+            }
+        }
+
+        for( int l = 0; l < lanes; ++l )
+        {
+            if( !active[l] )
+                continue;
+            uint32_t digest[8];
+            for( int i = 0; i < 8; ++i )
+                digest[i] = state[i][l];
+            while( cursor[l].blocks_left() )
+                sha256_block( digest, cursor[l].next_block() );
+            store_digest( digest, out + 32 * message[l] );
+        }
+    }
+};
+
+} // anonymous namespace
+
+} } // fc::detail
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Vectorized block loops of the hex and base64 codecs.  Each one converts as
+ * many whole blocks as it can and returns how much input it consumed, leaving
+ * the tail, and any block with an invalid character, to the scalar code in
+ * hex.cpp and base64.cpp, which also reports the errors.  get_text_codecs()
+ * picks the loops once; where the CPU has none they consume nothing.
+ */
+
+namespace fc { namespace detail {
+
+struct text_codecs
+{
+    /** 16 bytes to 32 hex digits per block */
+    size_t (*hex_encode)( const uint8_t* in, size_t len, char* out );
+    /** 32 hex digits to 16 bytes per block, at most out_len bytes */
+    size_t (*hex_decode)( const char* in, size_t len, uint8_t* out, size_t out_len );
+    /** 12 bytes to 16 base64 characters per block */
+    size_t (*base64_encode)( const uint8_t* in, size_t len, char* out );
+    /** 16 base64 characters to 12 bytes per block */
+    size_t (*base64_decode)( const char* in, size_t len, uint8_t* out );
+    const char* name;
+};
+
+size_t hex_encode_none( const uint8_t* in, size_t len, char* out );
+size_t hex_decode_none( const char* in, size_t len, uint8_t* out, size_t out_len );
+size_t base64_encode_none( const uint8_t* in, size_t len, char* out );
+size_t base64_decode_none( const char* in, size_t len, uint8_t* out );
+#if defined(__x86_64__) || defined(_M_X64)
+size_t hex_encode_ssse3( const uint8_t* in, size_t len, char* out );
+size_t hex_decode_ssse3( const char* in, size_t len, uint8_t* out, size_t out_len );
+size_t base64_encode_ssse3( const uint8_t* in, size_t len, char* out );
+size_t base64_decode_ssse3( const char* in, size_t len, uint8_t* out );
+#endif
+
+/** the block loops used on this CPU, chosen once */
+const text_codecs& get_text_codecs();
+
+} } // fc::detail
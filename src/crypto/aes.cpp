@@ -5,10 +5,12 @@
 
 #include <fc/io/fstream.hpp>
 #include <fc/io/raw.hpp>
+#include <fc/crypto/rand.hpp>
 
 #include <fc/log/logger.hpp>
 
 #include <fc/thread/thread.hpp>
+#include <fc/thread/worker_pool.hpp>
 #include <boost/thread/mutex.hpp>
 #include <openssl/opensslconf.h>
 #ifndef OPENSSL_THREADS
@@ -16,6 +18,8 @@
 #endif
 #include <openssl/crypto.h>
 
+#include <cstring>
+
 #if defined(_WIN32)
 # include <windows.h>
 #endif
@@ -38,7 +42,8 @@ aes_encoder::~aes_encoder()
 
 void aes_encoder::init( const fc::sha256& key, const fc::uint128_t& init_value )
 {
-    my->ctx.obj = EVP_CIPHER_CTX_new();
+    if( !my->ctx )
+        my->ctx.obj = EVP_CIPHER_CTX_new();
     /* Create and initialise the context */
     if(!my->ctx)
     {
@@ -102,7 +107,8 @@ aes_decoder::aes_decoder()
 
 void aes_decoder::init( const fc::sha256& key, const fc::uint128_t& init_value )
 {
-    my->ctx.obj = EVP_CIPHER_CTX_new();
+    if( !my->ctx )
+        my->ctx.obj = EVP_CIPHER_CTX_new();
     /* Create and initialise the context */
     if(!my->ctx)
     {
@@ -168,11 +174,23 @@ uint32_t aes_decoder::final_decode( char* plaintext )
 
 
 
+namespace {
+    /**
+     *  The context of the one shot functions below, one per thread.  Every use starts with an
+     *  EVP_*Init_ex() that sets a cipher, which resets whatever the previous use left behind.
+     */
+    EVP_CIPHER_CTX* thread_cipher_ctx()
+    {
+        static thread_local evp_cipher_ctx ctx( EVP_CIPHER_CTX_new() );
+        return ctx;
+    }
+}
+
 /** example method from wiki.opensslfoundation.com */
 unsigned aes_encrypt(unsigned char *plaintext, int plaintext_len, unsigned char *key,
                      unsigned char *iv, unsigned char *ciphertext)
 {
-    evp_cipher_ctx ctx( EVP_CIPHER_CTX_new() );
+    EVP_CIPHER_CTX* ctx = thread_cipher_ctx();
 
     int len = 0;
     unsigned ciphertext_len = 0;
@@ -221,7 +239,7 @@ unsigned aes_encrypt(unsigned char *plaintext, int plaintext_len, unsigned char
 unsigned aes_decrypt(unsigned char *ciphertext, int ciphertext_len, unsigned char *key,
                      unsigned char *iv, unsigned char *plaintext)
 {
-    evp_cipher_ctx ctx( EVP_CIPHER_CTX_new() );
+    EVP_CIPHER_CTX* ctx = thread_cipher_ctx();
     int len = 0;
     unsigned plaintext_len = 0;
 
@@ -270,7 +288,7 @@ unsigned aes_decrypt(unsigned char *ciphertext, int ciphertext_len, unsigned cha
 unsigned aes_cfb_decrypt(unsigned char *ciphertext, int ciphertext_len, unsigned char *key,
                          unsigned char *iv, unsigned char *plaintext)
 {
-    evp_cipher_ctx ctx( EVP_CIPHER_CTX_new() );
+    EVP_CIPHER_CTX* ctx = thread_cipher_ctx();
     int len = 0;
     unsigned plaintext_len = 0;
 
@@ -377,6 +395,305 @@ std::vector<char> aes_load( const fc::path& file, const fc::sha512& key )
    return aes_decrypt( key, cipher );
 } FC_RETHROW_EXCEPTIONS( warn, "", ("file",file) ) }
 
+namespace {
+    const size_t aes_block_size = 16;
+    const size_t aes_gcm_tag_size = 16;
+
+    /// magic and version of the files written by aes_stream_save(), followed by the iv
+    const char aes_stream_file_magic[8] = { 'f', 'c', 'a', 'e', 's', 'g', 'c', 'm' };
+
+    const EVP_CIPHER* aes_stream_cipher( aes_stream_mode mode )
+    {
+        switch( mode )
+        {
+            case aes_cbc: return EVP_aes_256_cbc();
+            case aes_ctr: return EVP_aes_256_ctr();
+            case aes_gcm: return EVP_aes_256_gcm();
+        }
+        FC_THROW_EXCEPTION( aes_exception, "unknown aes stream mode ${m}", ("m", int(mode)) );
+    }
+
+    /// reads until buf is full or in has ended, which sets eof
+    size_t read_full( istream& in, char* buf, size_t len, bool& eof )
+    {
+        size_t r = 0;
+        try
+        {
+            while( r < len )
+                r += in.readsome( buf + r, len - r );
+        }
+        catch( const fc::eof_exception& )
+        {
+            eof = true;
+        }
+        return r;
+    }
+
+    /**
+     *  The pipeline of aes_stream_encoder and aes_stream_decoder.  Each step runs two tasks at
+     *  once, the caller writing out the result of the previous step and reading the input of the
+     *  next one while a pool thread runs the cipher over the current input, so buffers alternate
+     *  between the two sets.  Input buffers start with room for a GCM tag: the decoder cannot tell
+     *  the tag from cipher text before the input ends, so it holds back the last tag size bytes
+     *  of every buffer and moves them to the front of the next.
+     */
+    class aes_stream
+    {
+    public:
+        aes_stream( aes_stream_mode mode, bool encrypt, size_t buffer_size, worker_pool* pool )
+            : _mode( mode ), _encrypt( encrypt ), _buffer_size( buffer_size ), _pool( pool ),
+              _ctx( EVP_CIPHER_CTX_new() )
+        {
+            static int init = init_openssl();
+            (void)init;
+            FC_ASSERT( buffer_size >= aes_block_size && buffer_size <= (1u << 30), "", ("buffer_size", buffer_size) );
+            aes_stream_cipher( mode );
+            if( !_ctx )
+            {
+                FC_THROW_EXCEPTION( aes_exception, "error allocating evp cipher context",
+                                   ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+            }
+        }
+
+        uint64_t run( istream& in, ostream& out, const fc::sha256& key, const fc::uint128_t& iv,
+                      const std::vector<char>& aad );
+
+    private:
+        void   init( const fc::sha256& key, const fc::uint128_t& iv, const std::vector<char>& aad );
+        size_t update( const char* in, size_t len, char* out );
+        size_t finish( ostream& out, char* tag );
+
+        aes_stream_mode _mode;
+        bool            _encrypt;
+        size_t          _buffer_size;
+        worker_pool*    _pool;
+        evp_cipher_ctx  _ctx;
+        std::unique_ptr<char[]> _in[2];
+        std::unique_ptr<char[]> _out[2];
+    };
+
+    void aes_stream::init( const fc::sha256& key, const fc::uint128_t& iv, const std::vector<char>& aad )
+    {
+        FC_ASSERT( _mode == aes_gcm || aad.empty(), "only AES-GCM authenticates additional data" );
+        if( 1 != EVP_CipherInit_ex( _ctx, aes_stream_cipher( _mode ), NULL, NULL, NULL, _encrypt ) ||
+            ( _mode == aes_gcm && 1 != EVP_CIPHER_CTX_ctrl( _ctx, EVP_CTRL_GCM_SET_IVLEN, sizeof(iv), NULL ) ) ||
+            1 != EVP_CipherInit_ex( _ctx, NULL, NULL, (const unsigned char*)&key, (const unsigned char*)&iv, _encrypt ) )
+        {
+            FC_THROW_EXCEPTION( aes_exception, "error during aes 256 stream init",
+                               ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+        }
+        EVP_CIPHER_CTX_set_padding( _ctx, _mode == aes_cbc );
+
+        int len = 0;
+        if( !aad.empty() && 1 != EVP_CipherUpdate( _ctx, NULL, &len, (const unsigned char*)aad.data(), int(aad.size()) ) )
+        {
+            FC_THROW_EXCEPTION( aes_exception, "error during aes 256 gcm aad update",
+                               ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+        }
+
+        if( !_in[0] )
+        {
+            for( int i = 0; i < 2; ++i )
+            {
+                _in[i].reset( new char[aes_gcm_tag_size + _buffer_size] );
+                _out[i].reset( new char[_buffer_size + 2 * aes_block_size] );
+            }
+        }
+    }
+
+    size_t aes_stream::update( const char* in, size_t len, char* out )
+    {
+        int out_len = 0;
+        if( len && 1 != EVP_CipherUpdate( _ctx, (unsigned char*)out, &out_len, (const unsigned char*)in, int(len) ) )
+        {
+            FC_THROW_EXCEPTION( aes_exception, "error during aes 256 stream update",
+                               ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+        }
+        return out_len;
+    }
+
+    size_t aes_stream::finish( ostream& out, char* tag )
+    {
+        if( !_encrypt && _mode == aes_gcm &&
+            1 != EVP_CIPHER_CTX_ctrl( _ctx, EVP_CTRL_GCM_SET_TAG, aes_gcm_tag_size, tag ) )
+        {
+            FC_THROW_EXCEPTION( aes_exception, "error setting aes 256 gcm tag",
+                               ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+        }
+
+        char last[2 * aes_block_size];
+        int len = 0;
+        if( 1 != EVP_CipherFinal_ex( _ctx, (unsigned char*)last, &len ) )
+        {
+            if( _mode == aes_gcm )
+                FC_THROW_EXCEPTION( aes_exception, "aes 256 gcm authentication failed" );
+            FC_THROW_EXCEPTION( aes_exception, "error during aes 256 stream final",
+                               ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+        }
+        out.write( last, len );
+        size_t written = len;
+
+        if( _encrypt && _mode == aes_gcm )
+        {
+            if( 1 != EVP_CIPHER_CTX_ctrl( _ctx, EVP_CTRL_GCM_GET_TAG, aes_gcm_tag_size, tag ) )
+            {
+                FC_THROW_EXCEPTION( aes_exception, "error getting aes 256 gcm tag",
+                                   ("s", ERR_error_string( ERR_get_error(), nullptr) ) );
+            }
+            out.write( tag, aes_gcm_tag_size );
+            written += aes_gcm_tag_size;
+        }
+        return written;
+    }
+
+    uint64_t aes_stream::run( istream& in, ostream& out, const fc::sha256& key, const fc::uint128_t& iv,
+                              const std::vector<char>& aad )
+    {
+        init( key, iv, aad );
+        worker_pool& pool = _pool ? *_pool : worker_pool::get_default();
+        const bool holds_tag = !_encrypt && _mode == aes_gcm;
+        char tag[aes_gcm_tag_size];
+
+        // the input of the current step is _in[cur][begin, end)
+        bool eof = false;
+        int cur = 0;
+        size_t begin = aes_gcm_tag_size;
+        size_t end = begin + read_full( in, _in[cur].get() + begin, _buffer_size, eof );
+        size_t pending = 0;
+        uint64_t written = 0;
+        while( true )
+        {
+            const bool last = eof;
+            const int next = 1 - cur;
+            size_t crypt_end = end;
+            size_t next_begin = aes_gcm_tag_size;
+            if( holds_tag )
+            {
+                if( end - begin < aes_gcm_tag_size )
+                    FC_THROW_EXCEPTION( aes_exception, "aes 256 gcm stream is too short to hold its tag" );
+                crypt_end = end - aes_gcm_tag_size;
+                if( last )
+                    memcpy( tag, _in[cur].get() + crypt_end, aes_gcm_tag_size );
+                else
+                {
+                    memcpy( _in[next].get(), _in[cur].get() + crypt_end, aes_gcm_tag_size );
+                    next_begin = 0;
+                }
+            }
+
+            size_t next_end = aes_gcm_tag_size;
+            size_t produced = 0;
+            pool.for_each_range( 2, [&]( size_t first, size_t past )
+            {
+                for( size_t task = first; task < past; ++task )
+                {
+                    if( task == 0 )
+                    {
+                        if( pending )
+                            out.write( _out[next].get(), pending );
+                        if( !last )
+                            next_end += read_full( in, _in[next].get() + aes_gcm_tag_size, _buffer_size, eof );
+                    }
+                    else
+                        produced = update( _in[cur].get() + begin, crypt_end - begin, _out[cur].get() );
+                }
+            } );
+            written += pending;
+            pending = produced;
+            if( last )
+                break;
+            cur = next;
+            begin = next_begin;
+            end = next_end;
+        }
+        if( pending )
+            out.write( _out[cur].get(), pending );
+        written += pending;
+        return written + finish( out, tag );
+    }
+}
+
+struct aes_stream_encoder::impl
+{
+   impl( aes_stream_mode mode, size_t buffer_size, worker_pool* pool )
+      : stream( mode, true, buffer_size, pool ) {}
+
+   aes_stream stream;
+};
+
+aes_stream_encoder::aes_stream_encoder( aes_stream_mode mode, size_t buffer_size, worker_pool* pool )
+   : my( new impl( mode, buffer_size, pool ) )
+{
+}
+
+aes_stream_encoder::~aes_stream_encoder()
+{
+}
+
+uint64_t aes_stream_encoder::encode( istream& in, ostream& out, const fc::sha256& key, const fc::uint128_t& iv,
+                                     const std::vector<char>& aad )
+{
+    return my->stream.run( in, out, key, iv, aad );
+}
+
+struct aes_stream_decoder::impl
+{
+   impl( aes_stream_mode mode, size_t buffer_size, worker_pool* pool )
+      : stream( mode, false, buffer_size, pool ) {}
+
+   aes_stream stream;
+};
+
+aes_stream_decoder::aes_stream_decoder( aes_stream_mode mode, size_t buffer_size, worker_pool* pool )
+   : my( new impl( mode, buffer_size, pool ) )
+{
+}
+
+aes_stream_decoder::~aes_stream_decoder()
+{
+}
+
+uint64_t aes_stream_decoder::decode( istream& in, ostream& out, const fc::sha256& key, const fc::uint128_t& iv,
+                                     const std::vector<char>& aad )
+{
+    return my->stream.run( in, out, key, iv, aad );
+}
+
+void aes_stream_save( const fc::path& file, const fc::sha512& key, istream& plain_text )
+{ try {
+   std::vector<char> header( aes_stream_file_magic, aes_stream_file_magic + sizeof(aes_stream_file_magic) );
+   fc::uint128_t iv;
+   fc::rand_bytes( (char*)&iv, sizeof(iv) );
+   header.insert( header.end(), (const char*)&iv, (const char*)&iv + sizeof(iv) );
+
+   fc::sha256 aes_key;
+   memcpy( (char*)&aes_key, (const char*)&key, sizeof(aes_key) );
+
+   fc::ofstream out( file );
+   out.write( header.data(), header.size() );
+   aes_stream_encoder( aes_gcm ).encode( plain_text, out, aes_key, iv, header );
+   out.flush();
+} FC_RETHROW_EXCEPTIONS( warn, "", ("file",file) ) }
+
+void aes_stream_load( const fc::path& file, const fc::sha512& key, ostream& plain_text )
+{ try {
+   FC_ASSERT( fc::exists( file ) );
+
+   fc::ifstream in( file, fc::ifstream::binary );
+   std::vector<char> header( sizeof(aes_stream_file_magic) + sizeof(fc::uint128_t) );
+   bool eof = false;
+   if( read_full( in, header.data(), header.size(), eof ) != header.size() ||
+       memcmp( header.data(), aes_stream_file_magic, sizeof(aes_stream_file_magic) ) != 0 )
+      FC_THROW_EXCEPTION( aes_exception, "not a file written by aes_stream_save" );
+   fc::uint128_t iv;
+   memcpy( (char*)&iv, header.data() + sizeof(aes_stream_file_magic), sizeof(iv) );
+
+   fc::sha256 aes_key;
+   memcpy( (char*)&aes_key, (const char*)&key, sizeof(aes_key) );
+
+   aes_stream_decoder( aes_gcm ).decode( in, plain_text, aes_key, iv, header );
+} FC_RETHROW_EXCEPTIONS( warn, "", ("file",file) ) }
+
 /* This stuff has to go somewhere, I guess this is as good a place as any...
   OpenSSL isn't thread-safe unless you give it access to some mutexes,
   so the CRYPTO_set_id_callback() function needs to be called before there's any
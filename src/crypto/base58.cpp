@@ -12,635 +12,291 @@
 // - E-mail usually won't line-break if there's no punctuation to break at.
 // - Doubleclicking selects the whole number as one word if it's all alphanumeric.
 //
-#ifndef BITCOIN_BASE58_H
-#define BITCOIN_BASE58_H
-
-#include <string>
-#include <vector>
-#include <limits>
-#include <algorithm>
-#include <string.h>
-
-#include <fc/log/logger.hpp>
-#include <fc/string.hpp>
+#include <fc/crypto/base58.hpp>
 #include <fc/exception/exception.hpp>
 
-#include <stdexcept>
-#include <vector>
-#include <openssl/bn.h>
-
-/** Errors thrown by the bignum class */
-class bignum_error : public std::runtime_error
-{
-public:
-    explicit bignum_error(const std::string& str) : std::runtime_error(str) {}
-};
-
-
-/** RAII encapsulated BN_CTX (OpenSSL bignum context) */
-class CAutoBN_CTX
-{
-protected:
-    BN_CTX* pctx;
-    BN_CTX* operator=(BN_CTX* pnew) { return pctx = pnew; }
-
-public:
-    CAutoBN_CTX()
-    {
-        pctx = BN_CTX_new();
-        if (pctx == NULL)
-            throw bignum_error("CAutoBN_CTX : BN_CTX_new() returned NULL");
-    }
-
-    ~CAutoBN_CTX()
-    {
-        if (pctx != NULL)
-            BN_CTX_free(pctx);
-    }
-
-    operator BN_CTX*() { return pctx; }
-    BN_CTX& operator*() { return *pctx; }
-    BN_CTX** operator&() { return &pctx; }
-    bool operator!() { return (pctx == NULL); }
-};
-
-
-/** C++ wrapper for BIGNUM (OpenSSL bignum) */
-class CBigNum
-{
-    BIGNUM* bn;
-public:
-    CBigNum()
-       : bn(BN_new()) {}
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 
-    CBigNum(const CBigNum& b)
-       : CBigNum()
-    {
-        if (!BN_copy(bn, b.bn))
-        {
-            BN_clear_free(bn);
-            throw bignum_error("CBigNum::CBigNum(const CBigNum&) : BN_copy failed");
+namespace fc {
+    namespace {
+        const char base58_alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+        /// value of every base58 character, -1 for the other bytes
+        const int8_t base58_digits[256] = {
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1,  0,  1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1,
+            -1,  9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+            22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+            -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+            47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        };
+
+        /// powers of 58 up to 58^5, the largest one that fits a 32 bit limb
+        const uint32_t base58_powers[6] = {1, 58, 3364, 195112, 11316496, 656356768};
+
+        /// inputs and strings up to this size are converted in stack buffers
+        const size_t stack_limit = 128;
+
+        size_t limbs_for_bytes(size_t size) {
+            return size / 4 + 1;
         }
-    }
-
-    CBigNum& operator=(const CBigNum& b)
-    {
-        if (!BN_copy(bn, b.bn))
-            throw bignum_error("CBigNum::operator= : BN_copy failed");
-        return (*this);
-    }
 
-    ~CBigNum()
-    {
-        BN_clear_free(bn);
-    }
-
-    //CBigNum(char n) is not portable.  Use 'signed char' or 'unsigned char'.
-    CBigNum(signed char n)      :CBigNum() { if (n >= 0) setulong(n); else setint64(n); }
-    CBigNum(short n)            :CBigNum() { if (n >= 0) setulong(n); else setint64(n); }
-    CBigNum(int n)              :CBigNum() { if (n >= 0) setulong(n); else setint64(n); }
-    CBigNum(int64_t n)          :CBigNum() { setint64(n); }
-    CBigNum(unsigned char n)    :CBigNum() { setulong(n); }
-    CBigNum(unsigned short n)   :CBigNum() { setulong(n); }
-    CBigNum(unsigned int n)     :CBigNum() { setulong(n); }
-    CBigNum(uint64_t n)         :CBigNum() { setuint64(n); }
-
-    explicit CBigNum(const std::vector<unsigned char>& vch)
-       : CBigNum()
-    {
-        setvch(vch);
-    }
-
-    void setulong(unsigned long n)
-    {
-        if (!BN_set_word(bn, n))
-            throw bignum_error("CBigNum conversion from unsigned long : BN_set_word failed");
-    }
-
-    unsigned long getulong() const
-    {
-        return BN_get_word(bn);
-    }
-
-    unsigned int getuint() const
-    {
-        return BN_get_word(bn);
-    }
+        /**
+         *  Writes the base58 encoding of size bytes to out, which must have room for
+         *  base58_max_size(size) characters.  limbs is scratch space of
+         *  limbs_for_bytes(size) words.  The number is kept as big endian 32 bit limbs
+         *  and divided by 58^5 until it is zero, which yields five digits per pass.
+         */
+        inline size_t encode(const uint8_t *in, size_t size, uint32_t *limbs, char *out) {
+            size_t zeros = 0;
+            while (zeros < size && in[zeros] == 0) {
+                ++zeros;
+            }
 
-    int getint() const
-    {
-        unsigned long n = BN_get_word(bn);
-        if (!BN_is_negative(bn))
-            return (n > (unsigned long)std::numeric_limits<int>::max() ? std::numeric_limits<int>::max() : n);
-        else
-            return (n > (unsigned long)std::numeric_limits<int>::max() ? std::numeric_limits<int>::min() : -(int)n);
-    }
+            // the first limb holds the 1-4 bytes that do not fill a whole word
+            size_t count = (size + 3) / 4;
+            size_t top = 0;
+            if (count) {
+                size_t lead = size - (count - 1) * 4;
+                uint32_t word = 0;
+                for (size_t i = 0; i < lead; ++i) {
+                    word = word << 8 | in[i];
+                }
+                limbs[0] = word;
+                for (size_t i = 1; i < count; ++i) {
+                    const uint8_t *p = in + lead + (i - 1) * 4;
+                    limbs[i] = uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+                }
+            }
 
-    void setint64(int64_t n)
-    {
-        unsigned char pch[sizeof(n) + 6];
-        unsigned char* p = pch + 4;
-        bool fNegative = false;
-        if (n < (int64_t)0)
-        {
-            n = -n;
-            fNegative = true;
-        }
-        bool fLeadingZeroes = true;
-        for (int i = 0; i < 8; i++)
-        {
-            unsigned char c = (n >> 56) & 0xff;
-            n <<= 8;
-            if (fLeadingZeroes)
-            {
-                if (c == 0)
-                    continue;
-                if (c & 0x80)
-                    *p++ = (fNegative ? 0x80 : 0);
-                else if (fNegative)
-                    c |= 0x80;
-                fLeadingZeroes = false;
+            // digits come out least significant first and are reversed at the end
+            char *digit = out;
+            while (top < count && limbs[top] == 0) {
+                ++top;
             }
-            *p++ = c;
+            while (top < count) {
+                uint64_t rest = 0;
+                for (size_t i = top; i < count; ++i) {
+                    uint64_t current = rest << 32 | limbs[i];
+                    limbs[i] = uint32_t(current / base58_powers[5]);
+                    rest = current % base58_powers[5];
+                }
+                while (top < count && limbs[top] == 0) {
+                    ++top;
+                }
+                // only the most significant group stops at its highest nonzero digit
+                uint32_t group = uint32_t(rest);
+                for (int i = 0; i < 5 && (group || top < count); ++i) {
+                    *digit++ = base58_alphabet[group % 58];
+                    group /= 58;
+                }
+            }
+            for (size_t i = 0; i < zeros; ++i) {
+                *digit++ = base58_alphabet[0];
+            }
+            std::reverse(out, digit);
+            return digit - out;
         }
-        unsigned int nSize = p - (pch + 4);
-        pch[0] = (nSize >> 24) & 0xff;
-        pch[1] = (nSize >> 16) & 0xff;
-        pch[2] = (nSize >> 8) & 0xff;
-        pch[3] = (nSize) & 0xff;
-        BN_mpi2bn(pch, p - pch, bn);
-    }
 
-    void setuint64(uint64_t n)
-    {
-        unsigned char pch[sizeof(n) + 6];
-        unsigned char* p = pch + 4;
-        bool fLeadingZeroes = true;
-        for (int i = 0; i < 8; i++)
-        {
-            unsigned char c = (n >> 56) & 0xff;
-            n <<= 8;
-            if (fLeadingZeroes)
-            {
-                if (c == 0)
-                    continue;
-                if (c & 0x80)
-                    *p++ = 0;
-                fLeadingZeroes = false;
+        /**
+         *  Accumulates the digits of [begin, end) into count little endian 32 bit limbs,
+         *  five characters per multiply-add pass.  The characters must be valid.
+         *  @return the number of limbs in use, or count + 1 if the value does not fit
+         */
+        inline size_t decode(const char *begin, const char *end, uint32_t *limbs, size_t count) {
+            size_t used = 0;
+            size_t group = (end - begin) % 5;
+            if (group == 0) {
+                group = 5;
+            }
+            for (const char *p = begin; p < end; p += group, group = 5) {
+                uint32_t value = 0;
+                for (size_t i = 0; i < group; ++i) {
+                    value = value * 58 + base58_digits[uint8_t(p[i])];
+                }
+                uint64_t carry = value;
+                for (size_t i = 0; i < used; ++i) {
+                    carry += uint64_t(limbs[i]) * base58_powers[group];
+                    limbs[i] = uint32_t(carry);
+                    carry >>= 32;
+                }
+                if (carry) {
+                    if (used == count) {
+                        return count + 1;
+                    }
+                    limbs[used++] = uint32_t(carry);
+                }
             }
-            *p++ = c;
+            return used;
         }
-        unsigned int nSize = p - (pch + 4);
-        pch[0] = (nSize >> 24) & 0xff;
-        pch[1] = (nSize >> 16) & 0xff;
-        pch[2] = (nSize >> 8) & 0xff;
-        pch[3] = (nSize) & 0xff;
-        BN_mpi2bn(pch, p - pch, bn);
-    }
-
-
-    void setvch(const std::vector<unsigned char>& vch)
-    {
-        std::vector<unsigned char> vch2(vch.size() + 4);
-        unsigned int nSize = vch.size();
-        // BIGNUM's byte stream format expects 4 bytes of
-        // big endian size data info at the front
-        vch2[0] = (nSize >> 24) & 0xff;
-        vch2[1] = (nSize >> 16) & 0xff;
-        vch2[2] = (nSize >> 8) & 0xff;
-        vch2[3] = (nSize >> 0) & 0xff;
-        // swap data to big endian
-        reverse_copy(vch.begin(), vch.end(), vch2.begin() + 4);
-        BN_mpi2bn(&vch2[0], vch2.size(), bn);
-    }
-
-    std::vector<unsigned char> getvch() const
-    {
-        unsigned int nSize = BN_bn2mpi(bn, NULL);
-        if (nSize <= 4)
-            return std::vector<unsigned char>();
-        std::vector<unsigned char> vch(nSize);
-        BN_bn2mpi(bn, &vch[0]);
-        vch.erase(vch.begin(), vch.begin() + 4);
-        reverse(vch.begin(), vch.end());
-        return vch;
-    }
-
-    CBigNum& SetCompact(unsigned int nCompact)
-    {
-        unsigned int nSize = nCompact >> 24;
-        std::vector<unsigned char> vch(4 + nSize);
-        vch[3] = nSize;
-        if (nSize >= 1) vch[4] = (nCompact >> 16) & 0xff;
-        if (nSize >= 2) vch[5] = (nCompact >> 8) & 0xff;
-        if (nSize >= 3) vch[6] = (nCompact >> 0) & 0xff;
-        BN_mpi2bn(&vch[0], vch.size(), bn);
-        return *this;
-    }
-
-    unsigned int GetCompact() const
-    {
-        unsigned int nSize = BN_bn2mpi(bn, NULL);
-        std::vector<unsigned char> vch(nSize);
-        nSize -= 4;
-        BN_bn2mpi(bn, &vch[0]);
-        unsigned int nCompact = nSize << 24;
-        if (nSize >= 1) nCompact |= (vch[4] << 16);
-        if (nSize >= 2) nCompact |= (vch[5] << 8);
-        if (nSize >= 3) nCompact |= (vch[6] << 0);
-        return nCompact;
-    }
 
-    void SetHex(const std::string& str)
-    {
-        // skip 0x
-        const char* psz = str.c_str();
-        while (isspace(*psz))
-            psz++;
-        bool fNegative = false;
-        if (*psz == '-')
-        {
-            fNegative = true;
-            psz++;
+        /// number of bytes of the value in limbs[0, used) without leading zero bytes
+        size_t value_bytes(const uint32_t *limbs, size_t used) {
+            if (used == 0) {
+                return 0;
+            }
+            size_t bytes = used * 4;
+            for (uint32_t top = limbs[used - 1]; !(top & 0xff000000); top <<= 8) {
+                --bytes;
+            }
+            return bytes;
         }
-        if (psz[0] == '0' && tolower(psz[1]) == 'x')
-            psz += 2;
-        while (isspace(*psz))
-            psz++;
 
-        // hex string to bignum
-        static signed char phexdigit[256] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,1,2,3,4,5,6,7,8,9,0,0,0,0,0,0, 0,0xa,0xb,0xc,0xd,0xe,0xf,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0xa,0xb,0xc,0xd,0xe,0xf,0,0,0,0,0,0,0,0,0 };
-        *this = 0;
-        while (isxdigit(*psz))
-        {
-            *this <<= 4;
-            int n = phexdigit[(unsigned char)*psz++];
-            *this += n;
+        /// writes the value big endian to the last bytes of out[0, size)
+        void store_value(const uint32_t *limbs, char *out, size_t size) {
+            for (size_t i = 0; i < size; ++i) {
+                out[size - 1 - i] = char(limbs[i / 4] >> (8 * (i % 4)));
+            }
         }
-        if (fNegative)
-            BN_set_negative(bn, 1);
-    }
 
-    std::string ToString(int nBase=10) const
-    {
-        CAutoBN_CTX pctx;
-        CBigNum bnBase = nBase;
-        CBigNum bn0 = 0;
-        std::string str;
-        CBigNum bn = *this;
-        BN_set_negative(bn.bn, false);
-        CBigNum dv;
-        CBigNum rem;
-        if (BN_cmp(bn.bn, bn0.bn) == 0)
-            return "0";
-        while (BN_cmp(bn.bn, bn0.bn) > 0)
-        {
-            if (!BN_div(dv.bn, rem.bn, bn.bn, bnBase.bn, pctx))
-                throw bignum_error("CBigNum::ToString() : BN_div failed");
-            bn = dv;
-            unsigned int c = rem.getulong();
-            str += "0123456789abcdef"[c];
+        /**
+         *  Finds the digits of a base58 string: leading and trailing whitespace is
+         *  ignored, anything else that is not in the alphabet is an error.
+         */
+        void parse(const std::string &str, const char *&begin, const char *&end, size_t &zeros) {
+            const char *p = str.c_str();
+            while (isspace(uint8_t(*p))) {
+                ++p;
+            }
+            begin = p;
+            while (base58_digits[uint8_t(*p)] >= 0) {
+                ++p;
+            }
+            end = p;
+            while (isspace(uint8_t(*p))) {
+                ++p;
+            }
+            if (*p != '\0') {
+                FC_THROW_EXCEPTION(parse_error_exception, "Unable to decode base58 string ${base58_str}",
+                                   ("base58_str", str));
+            }
+            zeros = 0;
+            while (begin + zeros < end && begin[zeros] == base58_alphabet[0]) {
+                ++zeros;
+            }
         }
-        if (BN_is_negative(this->bn))
-            str += "-";
-        reverse(str.begin(), str.end());
-        return str;
-    }
-
-    std::string GetHex() const
-    {
-        return ToString(16);
-    }
-
-
-
-    bool operator!() const
-    {
-        return BN_is_zero(bn);
-    }
-
-    CBigNum& operator+=(const CBigNum& b)
-    {
-        if (!BN_add(bn, bn, b.bn))
-            throw bignum_error("CBigNum::operator+= : BN_add failed");
-        return *this;
-    }
-
-    CBigNum& operator-=(const CBigNum& b)
-    {
-        if (!BN_sub(bn, bn, b.bn))
-            throw bignum_error("CBigNum::operator-= : BN_sub failed");
-        return *this;
-    }
-
-    CBigNum& operator*=(const CBigNum& b)
-    {
-        CAutoBN_CTX pctx;
-        if (!BN_mul(bn, bn, b.bn, pctx))
-            throw bignum_error("CBigNum::operator*= : BN_mul failed");
-        return *this;
-    }
-
-    CBigNum& operator/=(const CBigNum& b)
-    {
-        CAutoBN_CTX pctx;
-        if (!BN_div(bn, NULL, bn, b.bn, pctx))
-            throw bignum_error("CBigNum::operator/= : BN_div failed");
-        return *this;
-    }
 
-    CBigNum& operator%=(const CBigNum& b)
-    {
-        CAutoBN_CTX pctx;
-        if (!BN_div(NULL, bn, bn, b.bn, pctx))
-            throw bignum_error("CBigNum::operator%= : BN_div failed");
-        return *this;
-    }
-
-    CBigNum& operator<<=(unsigned int shift)
-    {
-        if (!BN_lshift(bn, bn, shift))
-            throw bignum_error("CBigNum:operator<<= : BN_lshift failed");
-        return *this;
-    }
-
-    CBigNum& operator>>=(unsigned int shift)
-    {
-        // Note: BN_rshift segfaults on 64-bit if 2^shift is greater than the number
-        //   if built on ubuntu 9.04 or 9.10, probably depends on version of openssl
-        CBigNum a = 1;
-        a <<= shift;
-        if (BN_cmp(a.bn, bn) > 0)
-        {
-            *this = 0;
-            return *this;
+        /// encodes with scratch space sized at compile time for the common key and address sizes
+        template<size_t Size, typename Output>
+        void encode_fixed(const uint8_t *in, Output &&output) {
+            uint32_t limbs[Size / 4 + 1];
+            char out[Size * 138 / 100 + 1];
+            output(out, encode(in, Size, limbs, out));
         }
 
-        if (!BN_rshift(bn, bn, shift))
-            throw bignum_error("CBigNum:operator>>= : BN_rshift failed");
-        return *this;
-    }
-
-
-    CBigNum& operator++()
-    {
-        // prefix operator
-        if (!BN_add(bn, bn, BN_value_one()))
-            throw bignum_error("CBigNum::operator++ : BN_add failed");
-        return *this;
-    }
-
-    const CBigNum operator++(int)
-    {
-        // postfix operator
-        const CBigNum ret = *this;
-        ++(*this);
-        return ret;
-    }
-
-    CBigNum& operator--()
-    {
-        // prefix operator
-        CBigNum r;
-        if (!BN_sub(r.bn, bn, BN_value_one()))
-            throw bignum_error("CBigNum::operator-- : BN_sub failed");
-        *this = r;
-        return *this;
-    }
-
-    const CBigNum operator--(int)
-    {
-        // postfix operator
-        const CBigNum ret = *this;
-        --(*this);
-        return ret;
-    }
-
-    const BIGNUM* to_bignum() const {
-       return bn;
-    }
-    BIGNUM* to_bignum() {
-       return bn;
-    }
-};
-
-
-
-inline const CBigNum operator+(const CBigNum& a, const CBigNum& b)
-{
-    CBigNum r;
-    if (!BN_add(r.to_bignum(), a.to_bignum(), b.to_bignum()))
-        throw bignum_error("CBigNum::operator+ : BN_add failed");
-    return r;
-}
-
-inline const CBigNum operator-(const CBigNum& a, const CBigNum& b)
-{
-    CBigNum r;
-    if (!BN_sub(r.to_bignum(), a.to_bignum(), b.to_bignum()))
-        throw bignum_error("CBigNum::operator- : BN_sub failed");
-    return r;
-}
-
-inline const CBigNum operator-(const CBigNum& a)
-{
-    CBigNum r(a);
-    BN_set_negative(r.to_bignum(), !BN_is_negative(r.to_bignum()));
-    return r;
-}
-
-inline const CBigNum operator*(const CBigNum& a, const CBigNum& b)
-{
-    CAutoBN_CTX pctx;
-    CBigNum r;
-    if (!BN_mul(r.to_bignum(), a.to_bignum(), b.to_bignum(), pctx))
-        throw bignum_error("CBigNum::operator* : BN_mul failed");
-    return r;
-}
-
-inline const CBigNum operator/(const CBigNum& a, const CBigNum& b)
-{
-    CAutoBN_CTX pctx;
-    CBigNum r;
-    if (!BN_div(r.to_bignum(), NULL, a.to_bignum(), b.to_bignum(), pctx))
-        throw bignum_error("CBigNum::operator/ : BN_div failed");
-    return r;
-}
-
-inline const CBigNum operator%(const CBigNum& a, const CBigNum& b)
-{
-    CAutoBN_CTX pctx;
-    CBigNum r;
-    if (!BN_mod(r.to_bignum(), a.to_bignum(), b.to_bignum(), pctx))
-        throw bignum_error("CBigNum::operator% : BN_div failed");
-    return r;
-}
-
-inline const CBigNum operator<<(const CBigNum& a, unsigned int shift)
-{
-    CBigNum r;
-    if (!BN_lshift(r.to_bignum(), a.to_bignum(), shift))
-        throw bignum_error("CBigNum:operator<< : BN_lshift failed");
-    return r;
-}
-
-inline const CBigNum operator>>(const CBigNum& a, unsigned int shift)
-{
-    CBigNum r = a;
-    r >>= shift;
-    return r;
-}
-
-inline bool operator==(const CBigNum& a, const CBigNum& b) { return (BN_cmp(a.to_bignum(), b.to_bignum()) == 0); }
-inline bool operator!=(const CBigNum& a, const CBigNum& b) { return (BN_cmp(a.to_bignum(), b.to_bignum()) != 0); }
-inline bool operator<=(const CBigNum& a, const CBigNum& b) { return (BN_cmp(a.to_bignum(), b.to_bignum()) <= 0); }
-inline bool operator>=(const CBigNum& a, const CBigNum& b) { return (BN_cmp(a.to_bignum(), b.to_bignum()) >= 0); }
-inline bool operator<(const CBigNum& a, const CBigNum& b)  { return (BN_cmp(a.to_bignum(), b.to_bignum()) < 0); }
-inline bool operator>(const CBigNum& a, const CBigNum& b)  { return (BN_cmp(a.to_bignum(), b.to_bignum()) > 0); }
-
-
-static const char* pszBase58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-
-// Encode a byte sequence as a base58-encoded string
-inline std::string EncodeBase58(const unsigned char* pbegin, const unsigned char* pend)
-{
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn0 = 0;
-
-    // Convert big endian data to little endian
-    // Extra zero at the end make sure bignum will interpret as a positive number
-    std::vector<unsigned char> vchTmp(pend-pbegin+1, 0);
-    reverse_copy(pbegin, pend, vchTmp.begin());
-
-    // Convert little endian data to bignum
-    CBigNum bn;
-    bn.setvch(vchTmp);
-
-    // Convert bignum to std::string
-    std::string str;
-    // Expected size increase from base58 conversion is approximately 137%
-    // use 138% to be safe
-    str.reserve((pend - pbegin) * 138 / 100 + 1);
-    CBigNum dv;
-    CBigNum rem;
-    while (bn > bn0)
-    {
-        if (!BN_div(dv.to_bignum(), rem.to_bignum(), bn.to_bignum(), bn58.to_bignum(), pctx))
-            throw bignum_error("EncodeBase58 : BN_div failed");
-        bn = dv;
-        unsigned int c = rem.getulong();
-        str += pszBase58[c];
-    }
-
-    // Leading zeroes encoded as base58 zeros
-    for (const unsigned char* p = pbegin; p < pend && *p == 0; p++)
-        str += pszBase58[0];
-
-    // Convert little endian std::string to big endian
-    reverse(str.begin(), str.end());
-//    slog( "Encode '%s'", str.c_str() );
-    return str;
-}
-
-// Encode a byte vector as a base58-encoded string
-inline std::string EncodeBase58(const std::vector<unsigned char>& vch)
-{
-    return EncodeBase58(&vch[0], &vch[0] + vch.size());
-}
-
-// Decode a base58-encoded string psz into byte vector vchRet
-// returns true if decoding is succesful
-inline bool DecodeBase58(const char* psz, std::vector<unsigned char>& vchRet)
-{
-    CAutoBN_CTX pctx;
-    vchRet.clear();
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
-    while (isspace(*psz))
-        psz++;
+        /// calls output(chars, length) with the encoding of size bytes
+        template<typename Output>
+        void encode_to(const char *data, size_t size, Output &&output) {
+            const uint8_t *in = (const uint8_t *)data;
+            switch (size) {
+                case 33:    // compressed public key
+                    return encode_fixed<33>(in, output);
+                case 37:    // public key or private key with checksum
+                    return encode_fixed<37>(in, output);
+                case 65:    // uncompressed public key, compact signature
+                    return encode_fixed<65>(in, output);
+            }
+            if (size <= stack_limit) {
+                uint32_t limbs[stack_limit / 4 + 1];
+                char out[stack_limit * 138 / 100 + 1];
+                output(out, encode(in, size, limbs, out));
+            } else {
+                std::vector<uint32_t> limbs(limbs_for_bytes(size));
+                std::vector<char> out(base58_max_size(size));
+                output(out.data(), encode(in, size, limbs.data(), out.data()));
+            }
+        }
 
-    // Convert big endian string to bignum
-    for (const char* p = psz; *p; p++)
-    {
-        const char* p1 = strchr(pszBase58, *p);
-        if (p1 == NULL)
-        {
-            while (isspace(*p))
-                p++;
-            if (*p != '\0') {
-                //slog( "%s  '%c'", pszBase58,*p );
-                return false;
+        /**
+         *  Decodes the digits in [begin, end) into limbs and calls output(limbs, used),
+         *  where used is the number of limbs holding the value.
+         */
+        template<typename Output>
+        void decode_to(const char *begin, const char *end, Output &&output) {
+            // 58^n < 256^(n * 733 / 1000 + 1)
+            size_t count = limbs_for_bytes((end - begin) * 733 / 1000 + 1);
+            if (count <= stack_limit / 4) {
+                uint32_t limbs[stack_limit / 4];
+                output(limbs, decode(begin, end, limbs, count));
+            } else {
+                std::vector<uint32_t> limbs(count);
+                output(limbs.data(), decode(begin, end, limbs.data(), count));
             }
-            break;
         }
-        bnChar.setulong(p1 - pszBase58);
-        if (!BN_mul(bn.to_bignum(), bn.to_bignum(), bn58.to_bignum(), pctx))
-            throw bignum_error("DecodeBase58 : BN_mul failed");
-        bn += bnChar;
     }
 
-    // Get bignum as little endian data
-    std::vector<unsigned char> vchTmp = bn.getvch();
-
-    // Trim off sign byte if present
-    if (vchTmp.size() >= 2 && vchTmp.end()[-1] == 0 && vchTmp.end()[-2] >= 0x80)
-        vchTmp.erase(vchTmp.end()-1);
-
-    // Restore leading zeros
-    int nLeadingZeros = 0;
-    for (const char* p = psz; *p == pszBase58[0]; p++)
-        nLeadingZeros++;
-    vchRet.assign(nLeadingZeros + vchTmp.size(), 0);
-
-    // Convert little endian data to big endian
-    reverse_copy(vchTmp.begin(), vchTmp.end(), vchRet.end() - vchTmp.size());
-    return true;
-}
-
-// Decode a base58-encoded string str into byte vector vchRet
-// returns true if decoding is succesful
-inline bool DecodeBase58(const std::string& str, std::vector<unsigned char>& vchRet)
-{
-    return DecodeBase58(str.c_str(), vchRet);
-}
-
-
-namespace fc {
-
-std::string to_base58( const char* d, size_t s ) {
-  return EncodeBase58( (const unsigned char*)d, (const unsigned char*)d+s ).c_str();
-}
+    std::string to_base58(const char *d, size_t s) {
+        std::string result;
+        encode_to(d, s, [&](const char *chars, size_t length) {
+            result.assign(chars, length);
+        });
+        return result;
+    }
+
+    std::string to_base58(const std::vector<char> &d) {
+        return to_base58(d.data(), d.size());
+    }
+
+    size_t to_base58(const char *d, size_t s, char *out_data, size_t out_data_len) {
+        size_t result = 0;
+        encode_to(d, s, [&](const char *chars, size_t length) {
+            FC_ASSERT(length <= out_data_len);
+            memcpy(out_data, chars, length);
+            result = length;
+        });
+        return result;
+    }
+
+    std::vector<char> from_base58(const std::string &base58_str) {
+        const char *begin, *end;
+        size_t zeros;
+        parse(base58_str, begin, end, zeros);
+
+        std::vector<char> result;
+        decode_to(begin, end, [&](const uint32_t *limbs, size_t used) {
+            size_t bytes = value_bytes(limbs, used);
+            result.assign(zeros + bytes, 0);
+            store_value(limbs, result.data() + zeros, bytes);
+        });
+        return result;
+    }
+
+    /**
+     *  @return the number of bytes decoded
+     */
+    size_t from_base58(const std::string &base58_str, char *out_data, size_t out_data_len) {
+        const char *begin, *end;
+        size_t zeros;
+        parse(base58_str, begin, end, zeros);
+
+        // a value that does not fit out_data does not need more limbs than it has bytes
+        size_t count = limbs_for_bytes(out_data_len);
+        uint32_t stack_limbs[stack_limit / 4];
+        std::vector<uint32_t> heap_limbs;
+        uint32_t *limbs = stack_limbs;
+        if (count > stack_limit / 4) {
+            heap_limbs.resize(count);
+            limbs = heap_limbs.data();
+        }
 
-std::string to_base58( const std::vector<char>& d )
-{
-  if( d.size() )
-     return to_base58( d.data(), d.size() );
-  return std::string();
-}
-std::vector<char> from_base58( const std::string& base58_str ) {
-   std::vector<unsigned char> out;
-   if( !DecodeBase58( base58_str.c_str(), out ) ) {
-     FC_THROW_EXCEPTION( parse_error_exception, "Unable to decode base58 string ${base58_str}", ("base58_str",base58_str) );
-   }
-   return std::vector<char>((const char*)out.data(), ((const char*)out.data())+out.size() );
-}
-/**
- *  @return the number of bytes decoded
- */
-size_t from_base58( const std::string& base58_str, char* out_data, size_t out_data_len ) {
-  //slog( "%s", base58_str.c_str() );
-  std::vector<unsigned char> out;
-  if( !DecodeBase58( base58_str.c_str(), out ) ) {
-    FC_THROW_EXCEPTION( parse_error_exception, "Unable to decode base58 string ${base58_str}", ("base58_str",base58_str) );
-  }
-  FC_ASSERT( out.size() <= out_data_len );
-  if (!out.empty()) {
-     memcpy( out_data, out.data(), out.size() );
-  }
-  return out.size();
-}
+        size_t used = decode(begin, end, limbs, count);
+        FC_ASSERT(used <= count);
+        size_t bytes = value_bytes(limbs, used);
+        FC_ASSERT(zeros + bytes <= out_data_len);
+        memset(out_data, 0, zeros);
+        store_value(limbs, out_data + zeros, bytes);
+        return zeros + bytes;
+    }
 }
-
-#endif
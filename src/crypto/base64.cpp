@@ -1,5 +1,7 @@
 #include <fc/crypto/base64.hpp>
-#include <ctype.h>
+
+#include "_text_codecs.hpp"
+
 /* 
    base64.cpp and base64.h
 
@@ -25,114 +27,115 @@
 
    René Nyffenegger rene.nyffenegger@adp-gmbh.ch
 
+   Altered: table driven, with vectorized block loops and buffer based overloads.
+
 */
 
 namespace fc {
 
-inline const std::string& base64_chars()
-{
-    static const std::string m_base64_chars =
-                 "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                 "abcdefghijklmnopqrstuvwxyz"
-                 "0123456789+/";
-    return m_base64_chars;
+namespace {
+    const char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    /// value of every base64 character, -1 for the other bytes including '='
+    const int8_t base64_values[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    };
 }
 
-static inline bool is_base64(unsigned char c) {
-  return (isalnum(c) || (c == '+') || (c == '/'));
-}
+size_t base64_encode(const char* in, size_t in_len, char* out) {
+  const uint8_t* bytes = (const uint8_t*)in;
+  size_t i = detail::get_text_codecs().base64_encode(bytes, in_len, out);
+  char* pos = out + i / 3 * 4;
+
+  for (; in_len - i >= 3; i += 3, pos += 4) {
+    uint32_t group = uint32_t(bytes[i]) << 16 | uint32_t(bytes[i + 1]) << 8 | bytes[i + 2];
+    pos[0] = base64_alphabet[group >> 18];
+    pos[1] = base64_alphabet[(group >> 12) & 0x3f];
+    pos[2] = base64_alphabet[(group >> 6) & 0x3f];
+    pos[3] = base64_alphabet[group & 0x3f];
+  }
+
+  if (i < in_len) {
+    uint32_t group = uint32_t(bytes[i]) << 16;
+    if (i + 1 < in_len)
+      group |= uint32_t(bytes[i + 1]) << 8;
+    pos[0] = base64_alphabet[group >> 18];
+    pos[1] = base64_alphabet[(group >> 12) & 0x3f];
+    pos[2] = i + 1 < in_len ? base64_alphabet[(group >> 6) & 0x3f] : '=';
+    pos[3] = '=';
+    pos += 4;
+  }
 
-std::string base64_encode(unsigned char const* bytes_to_encode, unsigned int in_len);
+  return pos - out;
+}
 
 std::string base64_encode( const std::string& enc ) {
   char const* s = enc.c_str();
   return base64_encode( (unsigned char const*)s, enc.size() );
 }
+
 std::string base64_encode(unsigned char const* bytes_to_encode, unsigned int in_len) {
+  std::string ret(base64_encoded_size(in_len), '\0');
+  if (in_len)
+    base64_encode((const char*)bytes_to_encode, in_len, &ret[0]);
+  return ret;
+}
 
-  std::string ret;
-  int i = 0;
-  int j = 0;
-  unsigned char char_array_3[3];
-  unsigned char char_array_4[4];
-
-  while (in_len--) {
-    char_array_3[i++] = *(bytes_to_encode++);
-    if (i == 3) {
-      char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-      char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-      char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-      char_array_4[3] = char_array_3[2] & 0x3f;
-
-      for(i = 0; (i <4) ; i++)
-        ret += base64_chars()[char_array_4[i]];
-      i = 0;
+size_t base64_decode(const char* in, size_t in_len, char* out, size_t* consumed) {
+  uint8_t* pos = (uint8_t*)out;
+  size_t i = detail::get_text_codecs().base64_decode(in, in_len, pos);
+  pos += i / 4 * 3;
+
+  // the block loop stops before a block with '=' or another character outside the alphabet
+  uint32_t group = 0;
+  int chars = 0;
+  for (; i < in_len; ++i) {
+    int8_t value = base64_values[uint8_t(in[i])];
+    if (value < 0)
+      break;
+    group = group << 6 | uint32_t(value);
+    if (++chars == 4) {
+      pos[0] = uint8_t(group >> 16);
+      pos[1] = uint8_t(group >> 8);
+      pos[2] = uint8_t(group);
+      pos += 3;
+      group = 0;
+      chars = 0;
     }
   }
 
-  if (i)
-  {
-    for(j = i; j < 3; j++)
-      char_array_3[j] = '\0';
-
-    char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-    char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-    char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-    char_array_4[3] = char_array_3[2] & 0x3f;
-
-    for (j = 0; (j < i + 1); j++)
-      ret += base64_chars()[char_array_4[j]];
-
-    while((i++ < 3))
-      ret += '=';
-
+  // a partial group of n characters carries n - 1 bytes
+  if (chars > 1) {
+    group <<= 6 * (4 - chars);
+    for (int j = 0; j < chars - 1; ++j)
+      *pos++ = uint8_t(group >> (16 - 8 * j));
   }
 
-  return ret;
-
+  if (consumed)
+    *consumed = i;
+  return pos - (uint8_t*)out;
 }
 
-
 std::string base64_decode(std::string const& encoded_string) {
-  int in_len = encoded_string.size();
-  int i = 0;
-  int j = 0;
-  int in_ = 0;
-  unsigned char char_array_4[4], char_array_3[3];
-  std::string ret;
-
-  while (in_len-- && ( encoded_string[in_] != '=') && is_base64(encoded_string[in_])) {
-    char_array_4[i++] = encoded_string[in_]; in_++;
-    if (i ==4) {
-      for (i = 0; i <4; i++)
-        char_array_4[i] = base64_chars().find(char_array_4[i]);
-
-      char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-      char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-      char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-
-      for (i = 0; (i < 3); i++)
-        ret += char_array_3[i];
-      i = 0;
-    }
-  }
-
-  if (i) {
-    for (j = i; j <4; j++)
-      char_array_4[j] = 0;
-
-    for (j = 0; j <4; j++)
-      char_array_4[j] = base64_chars().find(char_array_4[j]);
-
-    char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-    char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-    char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-
-    for (j = 0; (j < i - 1); j++) ret += char_array_3[j];
-  }
-
+  std::string ret(base64_decoded_max_size(encoded_string.size()), '\0');
+  if (!ret.empty())
+    ret.resize(base64_decode(encoded_string.data(), encoded_string.size(), &ret[0]));
   return ret;
 }
 
 } // namespace fc
-
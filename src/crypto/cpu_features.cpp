@@ -0,0 +1,102 @@
+#include "_cpu_features.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+# include <intrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+# include <sys/auxv.h>
+# include <asm/hwcap.h>
+#endif
+
+#include <cstdint>
+
+namespace fc { namespace detail {
+
+namespace {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    void cpuid( uint32_t leaf, uint32_t subleaf, uint32_t regs[4] )
+    {
+# if defined(_MSC_VER)
+        int r[4];
+        __cpuidex( r, int(leaf), int(subleaf) );
+        for( int i = 0; i < 4; ++i )
+            regs[i] = uint32_t(r[i]);
+# else
+        __cpuid_count( leaf, subleaf, regs[0], regs[1], regs[2], regs[3] );
+# endif
+    }
+
+    uint64_t xgetbv0()
+    {
+# if defined(_MSC_VER)
+        return _xgetbv( 0 );
+# else
+        uint32_t lo, hi;
+        __asm__ volatile( "xgetbv" : "=a"(lo), "=d"(hi) : "c"(0) );
+        return ( uint64_t(hi) << 32 ) | lo;
+# endif
+    }
+
+    cpu_features detect()
+    {
+        cpu_features f;
+        uint32_t r[4];
+        cpuid( 0, 0, r );
+        uint32_t max_leaf = r[0];
+        if( max_leaf < 1 )
+            return f;
+
+        cpuid( 1, 0, r );
+        f.sse2  = ( r[3] >> 26 ) & 1;
+        f.ssse3 = ( r[2] >> 9 ) & 1;
+        f.sse41 = ( r[2] >> 19 ) & 1;
+        f.sse42 = ( r[2] >> 20 ) & 1;
+        bool osxsave = ( r[2] >> 27 ) & 1;
+        uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+        bool ymm_enabled = ( xcr0 & 0x6 ) == 0x6;
+        bool zmm_enabled = ( xcr0 & 0xe6 ) == 0xe6;
+
+        if( max_leaf >= 7 )
+        {
+            cpuid( 7, 0, r );
+            f.avx2     = ymm_enabled && ( ( r[1] >> 5 ) & 1 );
+            f.avx512f  = zmm_enabled && ( ( r[1] >> 16 ) & 1 );
+            f.avx512bw = f.avx512f && ( ( r[1] >> 30 ) & 1 );
+            f.sha_ni   = ( r[1] >> 29 ) & 1;
+        }
+        return f;
+    }
+#elif defined(__aarch64__) && defined(__linux__)
+    cpu_features detect()
+    {
+        cpu_features f;
+        unsigned long caps = getauxval( AT_HWCAP );
+        f.arm_crc32 = caps & HWCAP_CRC32;
+        f.arm_sha2  = caps & HWCAP_SHA2;
+        return f;
+    }
+#elif defined(__aarch64__) && defined(__APPLE__)
+    cpu_features detect()
+    {
+        // every Apple arm64 CPU implements the CRC32 and SHA-2 extensions
+        cpu_features f;
+        f.arm_crc32 = true;
+        f.arm_sha2  = true;
+        return f;
+    }
+#else
+    cpu_features detect()
+    {
+        return cpu_features();
+    }
+#endif
+}
+
+const cpu_features& get_cpu_features()
+{
+    static const cpu_features features = detect();
+    return features;
+}
+
+}} // fc::detail
@@ -1,5 +1,12 @@
 #include <cstdint>
 #include <stdlib.h>
+
+#include <fc/crypto/crc32c.hpp>
+
+#include "_city_crc.hpp"
+#include "_cpu_features.hpp"
+#include "_crc32c.hpp"
+
 //#include <zlib.h>
 /* Tables generated with code like the following:
 
@@ -601,27 +608,110 @@ static const uint32_t crc_c[256] = {
          0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E,
          0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351,
  };
-#if !defined __SSE4_2__ || (defined __SSE4_2__ && !defined __x86_64__)
 
+namespace fc {
+
+namespace detail {
+
+namespace {
+    struct slicing_by_8
+    {
+        static uint64_t u64( uint64_t crc, uint64_t v )
+        {
+            return crc32cSlicingBy8( uint32_t( crc ), &v, sizeof( v ) );
+        }
+    };
+
+    // GF(2) matrix helpers: a 32x32 matrix is an array of the images of the 32 unit vectors
+    uint32_t gf2_matrix_times( const uint32_t* mat, uint32_t vec )
+    {
+        uint32_t sum = 0;
+        for( ; vec; vec >>= 1, ++mat )
+            if( vec & 1 )
+                sum ^= *mat;
+        return sum;
+    }
+
+    void gf2_matrix_square( uint32_t* square, const uint32_t* mat )
+    {
+        for( int n = 0; n < 32; ++n )
+            square[n] = gf2_matrix_times( mat, mat[n] );
+    }
+
+    /** tables appending len zero bytes, len a power of two */
+    crc32c_zeros make_zeros( size_t len )
+    {
+        // the operator for one zero bit, squared three times gives the one for a zero byte
+        uint32_t op[32], tmp[32];
+        op[0] = 0x82f63b78;
+        for( int n = 1; n < 32; ++n )
+            op[n] = uint32_t( 1 ) << ( n - 1 );
+        for( size_t bits = 1; bits < 8 * len; bits *= 2 )
+        {
+            gf2_matrix_square( tmp, op );
+            memcpy( op, tmp, sizeof( op ) );
+        }
+
+        crc32c_zeros zeros;
+        for( uint32_t n = 0; n < 256; ++n )
+            for( int k = 0; k < 4; ++k )
+                zeros.table[k][n] = gf2_matrix_times( op, n << ( 8 * k ) );
+        return zeros;
+    }
+
+    crc32c_engine choose_crc32c_engine()
+    {
+        const cpu_features& cpu = get_cpu_features();
+#if defined(__x86_64__) || defined(_M_X64)
+        if( cpu.sse42 )
+            return { &crc32c_update_sse42, &city_hash_crc256_sse42, "sse4.2" };
+#elif defined(__aarch64__)
+        if( cpu.arm_crc32 )
+            return { &crc32c_update_armv8, &city_hash_crc256_armv8, "armv8-crc" };
+#endif
+        (void)cpu;
+        return { &crc32c_update_portable, &city_hash_crc256_portable, "portable" };
+    }
+}
 
-uint64_t _mm_crc32_u64(uint64_t a, uint64_t b )
+uint32_t crc32c_update_portable( uint32_t crc, const uint8_t* data, size_t len )
 {
-    return crc32cSlicingBy8(a, (unsigned char*)&b, sizeof(b)); 
+    return crc32cSlicingBy8( crc, data, len );
 }
-/*
-//#include "citycrc.h"
-#include <nmmintrin.h>
-#include <iostream>
 
-int main( int argc, char** argv )
+void city_hash_crc256_portable( const char* s, size_t len, uint64_t* result )
 {
-    uint64_t f = 0x1234;
-    uint64_t a = 0x5678;
-    uint32_t f1 = _mm_crc32_u64(f, a); 
-    uint32_t f4  = crc32cSlicingBy8(f, (unsigned char*)&a, sizeof(a)); 
-    std::cout<<std::hex<<f1<<"\n"<<f2<<"\n"<<f3<<"\n"<<f4<<"\n";
-    return 0;
+    city_hash_crc256<slicing_by_8>( s, len, result );
 }
-*/
 
-#endif
+const crc32c_zeros& crc32c_zeros_long()
+{
+    static const crc32c_zeros zeros = make_zeros( crc32c_long_block );
+    return zeros;
+}
+
+const crc32c_zeros& crc32c_zeros_short()
+{
+    static const crc32c_zeros zeros = make_zeros( crc32c_short_block );
+    return zeros;
+}
+
+const crc32c_engine& get_crc32c_engine()
+{
+    static const crc32c_engine engine = choose_crc32c_engine();
+    return engine;
+}
+
+} // namespace detail
+
+uint32_t crc32c( const char* data, size_t len, uint32_t crc )
+{
+    return ~detail::get_crc32c_engine().update( ~crc, (const uint8_t*)data, len );
+}
+
+const char* crc32c_implementation()
+{
+    return detail::get_crc32c_engine().name;
+}
+
+} // namespace fc
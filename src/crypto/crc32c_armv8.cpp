@@ -0,0 +1,39 @@
+#include "_crc32c.hpp"
+#include "_city_crc.hpp"
+
+#if defined(__aarch64__)
+
+#include <arm_acle.h>
+
+/* compiled with the ARMv8 CRC extension enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    struct armv8_crc
+    {
+        static uint32_t u8( uint32_t crc, uint8_t v )
+        {
+            return __crc32cb( crc, v );
+        }
+
+        static uint64_t u64( uint64_t crc, uint64_t v )
+        {
+            return __crc32cd( uint32_t( crc ), v );
+        }
+    };
+}
+
+uint32_t crc32c_update_armv8( uint32_t crc, const uint8_t* data, size_t len )
+{
+    return crc32c_hardware<armv8_crc>( crc, data, len );
+}
+
+void city_hash_crc256_armv8( const char* s, size_t len, uint64_t* result )
+{
+    city_hash_crc256<armv8_crc>( s, len, result );
+}
+
+} } // fc::detail
+
+#endif
@@ -0,0 +1,39 @@
+#include "_crc32c.hpp"
+#include "_city_crc.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <nmmintrin.h>
+
+/* compiled with SSE4.2 enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    struct sse42_crc
+    {
+        static uint32_t u8( uint32_t crc, uint8_t v )
+        {
+            return _mm_crc32_u8( crc, v );
+        }
+
+        static uint64_t u64( uint64_t crc, uint64_t v )
+        {
+            return _mm_crc32_u64( crc, v );
+        }
+    };
+}
+
+uint32_t crc32c_update_sse42( uint32_t crc, const uint8_t* data, size_t len )
+{
+    return crc32c_hardware<sse42_crc>( crc, data, len );
+}
+
+void city_hash_crc256_sse42( const char* s, size_t len, uint64_t* result )
+{
+    city_hash_crc256<sse42_crc>( s, len, result );
+}
+
+} } // fc::detail
+
+#endif
@@ -0,0 +1,74 @@
+#include "_digest_engine.hpp"
+#include "_cpu_features.hpp"
+
+#include <openssl/sha.h>
+
+namespace fc { namespace detail {
+
+// OpenSSL's own (mostly assembly) block functions, reached through the *_Transform() calls
+void sha1_compress_openssl( uint32_t* state, const uint8_t* data, size_t blocks )
+{
+    SHA_CTX ctx;
+    ctx.h0 = state[0]; ctx.h1 = state[1]; ctx.h2 = state[2]; ctx.h3 = state[3]; ctx.h4 = state[4];
+    for( ; blocks; --blocks, data += 64 )
+        SHA1_Transform( &ctx, data );
+    state[0] = ctx.h0; state[1] = ctx.h1; state[2] = ctx.h2; state[3] = ctx.h3; state[4] = ctx.h4;
+}
+
+void sha256_compress_openssl( uint32_t* state, const uint8_t* data, size_t blocks )
+{
+    SHA256_CTX ctx;
+    memcpy( ctx.h, state, sizeof(ctx.h) );
+    for( ; blocks; --blocks, data += 64 )
+        SHA256_Transform( &ctx, data );
+    memcpy( state, ctx.h, sizeof(ctx.h) );
+}
+
+void sha512_compress_openssl( uint64_t* state, const uint8_t* data, size_t blocks )
+{
+    SHA512_CTX ctx;
+    memcpy( ctx.h, state, sizeof(ctx.h) );
+    for( ; blocks; --blocks, data += 128 )
+        SHA512_Transform( &ctx, data );
+    memcpy( state, ctx.h, sizeof(ctx.h) );
+}
+
+void ripemd160_compress_portable( uint32_t* state, const uint8_t* data, size_t blocks )
+{
+    for( ; blocks; --blocks, data += 64 )
+        ripemd160_block( state, data );
+}
+
+namespace {
+    digest_engine choose_digest_engine()
+    {
+        digest_engine engine = {
+            { &sha1_compress_openssl,       "openssl" },
+            { &sha256_compress_openssl,     "openssl" },
+            { &sha512_compress_openssl,     "openssl" },
+            { &ripemd160_compress_portable, "portable" }
+        };
+
+#if defined(__x86_64__) || defined(_M_X64)
+        // about 10% faster than OpenSSL, which uses the same instructions
+        const cpu_features& cpu = get_cpu_features();
+        if( cpu.sha_ni && cpu.sse41 )
+        {
+            engine.sha1   = { &sha1_compress_shani,   "sha-ni" };
+            engine.sha256 = { &sha256_compress_shani, "sha-ni" };
+        }
+#endif
+        return engine;
+    }
+
+    // pick the backends while the library loads instead of on the first hash
+    const digest_engine& startup_engine = get_digest_engine();
+}
+
+const digest_engine& get_digest_engine()
+{
+    static const digest_engine engine = choose_digest_engine();
+    return engine;
+}
+
+} } // fc::detail
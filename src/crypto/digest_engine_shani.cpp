@@ -0,0 +1,157 @@
+#include "_digest_engine.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+/* compiled with the SHA extensions and SSE4.1 enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    inline __m128i load_message( const uint8_t* p, __m128i mask )
+    {
+        return _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)p ), mask );
+    }
+
+    /** four rounds of SHA-1; G is the group index (0..19), messages rotate through m[] */
+    template<int G>
+    inline void sha1_group( __m128i& abcd, __m128i e[2], __m128i m[4] )
+    {
+        __m128i& e_cur = e[G & 1];
+        __m128i& e_next = e[( G + 1 ) & 1];
+        if( G == 0 )
+            e_cur = _mm_add_epi32( e_cur, m[0] );
+        else
+            e_cur = _mm_sha1nexte_epu32( e_cur, m[G & 3] );
+        e_next = abcd;
+        if( G >= 3 && G <= 18 )
+            m[( G + 1 ) & 3] = _mm_sha1msg2_epu32( m[( G + 1 ) & 3], m[G & 3] );
+        abcd = _mm_sha1rnds4_epu32( abcd, e_cur, G / 5 );
+        if( G >= 1 && G <= 16 )
+            m[( G - 1 ) & 3] = _mm_sha1msg1_epu32( m[( G - 1 ) & 3], m[G & 3] );
+        if( G >= 2 && G <= 17 )
+            m[( G - 2 ) & 3] = _mm_xor_si128( m[( G - 2 ) & 3], m[G & 3] );
+    }
+
+    /** four rounds of SHA-256 with message words m (not yet including the round constants) */
+    inline void sha256_quad_round( __m128i& abef, __m128i& cdgh, __m128i m, const uint32_t* k )
+    {
+        __m128i wk = _mm_add_epi32( m, _mm_loadu_si128( (const __m128i*)k ) );
+        cdgh = _mm_sha256rnds2_epu32( cdgh, abef, wk );
+        abef = _mm_sha256rnds2_epu32( abef, cdgh, _mm_shuffle_epi32( wk, 0x0e ) );
+    }
+
+    /** first half of the schedule of m0 */
+    inline void sha256_schedule_a( __m128i& m0, __m128i m1 )
+    {
+        m0 = _mm_sha256msg1_epu32( m0, m1 );
+    }
+
+    /** finishes m2 from the two messages before it */
+    inline void sha256_schedule_c( __m128i m0, __m128i m1, __m128i& m2 )
+    {
+        m2 = _mm_sha256msg2_epu32( _mm_add_epi32( m2, _mm_alignr_epi8( m1, m0, 4 ) ), m1 );
+    }
+
+    inline void sha256_schedule_b( __m128i& m0, __m128i m1, __m128i& m2 )
+    {
+        sha256_schedule_c( m0, m1, m2 );
+        sha256_schedule_a( m0, m1 );
+    }
+}
+
+void sha1_compress_shani( uint32_t* state, const uint8_t* data, size_t blocks )
+{
+    const __m128i mask = _mm_set_epi64x( 0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL );
+    __m128i abcd = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i*)state ), 0x1b );
+    __m128i e0 = _mm_set_epi32( int(state[4]), 0, 0, 0 );
+
+    for( ; blocks; --blocks, data += 64 )
+    {
+        const __m128i abcd_save = abcd;
+        const __m128i e0_save = e0;
+        __m128i e[2] = { e0, _mm_setzero_si128() };
+        __m128i m[4] = { load_message( data, mask ), load_message( data + 16, mask ),
+                         load_message( data + 32, mask ), load_message( data + 48, mask ) };
+
+        sha1_group<0>( abcd, e, m );   sha1_group<1>( abcd, e, m );   sha1_group<2>( abcd, e, m );
+        sha1_group<3>( abcd, e, m );   sha1_group<4>( abcd, e, m );   sha1_group<5>( abcd, e, m );
+        sha1_group<6>( abcd, e, m );   sha1_group<7>( abcd, e, m );   sha1_group<8>( abcd, e, m );
+        sha1_group<9>( abcd, e, m );   sha1_group<10>( abcd, e, m );  sha1_group<11>( abcd, e, m );
+        sha1_group<12>( abcd, e, m );  sha1_group<13>( abcd, e, m );  sha1_group<14>( abcd, e, m );
+        sha1_group<15>( abcd, e, m );  sha1_group<16>( abcd, e, m );  sha1_group<17>( abcd, e, m );
+        sha1_group<18>( abcd, e, m );  sha1_group<19>( abcd, e, m );
+
+        e0 = _mm_sha1nexte_epu32( e[0], e0_save );
+        abcd = _mm_add_epi32( abcd, abcd_save );
+    }
+
+    _mm_storeu_si128( (__m128i*)state, _mm_shuffle_epi32( abcd, 0x1b ) );
+    state[4] = uint32_t( _mm_extract_epi32( e0, 3 ) );
+}
+
+void sha256_compress_shani( uint32_t* state, const uint8_t* data, size_t blocks )
+{
+    const __m128i mask = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+    const uint32_t* k = sha256_k;
+
+    // the SHA-256 instructions keep the state as ABEF and CDGH
+    __m128i t1 = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i*)state ), 0xb1 );
+    __m128i t2 = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i*)( state + 4 ) ), 0x1b );
+    __m128i abef = _mm_alignr_epi8( t1, t2, 8 );
+    __m128i cdgh = _mm_blend_epi16( t2, t1, 0xf0 );
+
+    for( ; blocks; --blocks, data += 64 )
+    {
+        const __m128i abef_save = abef;
+        const __m128i cdgh_save = cdgh;
+
+        __m128i m0 = load_message( data, mask );
+        sha256_quad_round( abef, cdgh, m0, k );
+        __m128i m1 = load_message( data + 16, mask );
+        sha256_quad_round( abef, cdgh, m1, k + 4 );
+        sha256_schedule_a( m0, m1 );
+        __m128i m2 = load_message( data + 32, mask );
+        sha256_quad_round( abef, cdgh, m2, k + 8 );
+        sha256_schedule_a( m1, m2 );
+        __m128i m3 = load_message( data + 48, mask );
+        sha256_quad_round( abef, cdgh, m3, k + 12 );
+        sha256_schedule_b( m2, m3, m0 );
+        sha256_quad_round( abef, cdgh, m0, k + 16 );
+        sha256_schedule_b( m3, m0, m1 );
+        sha256_quad_round( abef, cdgh, m1, k + 20 );
+        sha256_schedule_b( m0, m1, m2 );
+        sha256_quad_round( abef, cdgh, m2, k + 24 );
+        sha256_schedule_b( m1, m2, m3 );
+        sha256_quad_round( abef, cdgh, m3, k + 28 );
+        sha256_schedule_b( m2, m3, m0 );
+        sha256_quad_round( abef, cdgh, m0, k + 32 );
+        sha256_schedule_b( m3, m0, m1 );
+        sha256_quad_round( abef, cdgh, m1, k + 36 );
+        sha256_schedule_b( m0, m1, m2 );
+        sha256_quad_round( abef, cdgh, m2, k + 40 );
+        sha256_schedule_b( m1, m2, m3 );
+        sha256_quad_round( abef, cdgh, m3, k + 44 );
+        sha256_schedule_b( m2, m3, m0 );
+        sha256_quad_round( abef, cdgh, m0, k + 48 );
+        sha256_schedule_b( m3, m0, m1 );
+        sha256_quad_round( abef, cdgh, m1, k + 52 );
+        sha256_schedule_c( m0, m1, m2 );
+        sha256_quad_round( abef, cdgh, m2, k + 56 );
+        sha256_schedule_c( m1, m2, m3 );
+        sha256_quad_round( abef, cdgh, m3, k + 60 );
+
+        abef = _mm_add_epi32( abef, abef_save );
+        cdgh = _mm_add_epi32( cdgh, cdgh_save );
+    }
+
+    t1 = _mm_shuffle_epi32( abef, 0x1b );
+    t2 = _mm_shuffle_epi32( cdgh, 0xb1 );
+    _mm_storeu_si128( (__m128i*)state, _mm_blend_epi16( t1, t2, 0xf0 ) );
+    _mm_storeu_si128( (__m128i*)( state + 4 ), _mm_alignr_epi8( t2, t1, 8 ) );
+}
+
+} } // fc::detail
+
+#endif
@@ -4,6 +4,7 @@
 #include <fc/crypto/hmac.hpp>
 #include <fc/crypto/openssl.hpp>
 #include <fc/crypto/ripemd160.hpp>
+#include <fc/thread/worker_pool.hpp>
 
 #ifdef _WIN32
 # include <malloc.h>
@@ -67,7 +68,7 @@ namespace fc { namespace ecc {
             return _derive_message( *key.begin(), key.begin() + 1, i );
         }
 
-        static chr37 _derive_message( const private_key_secret& key, int i )
+        chr37 _derive_message( const private_key_secret& key, int i )
         {
             return _derive_message( 0, key.data(), i );
         }
@@ -129,6 +130,15 @@ namespace fc { namespace ecc {
        return add( enc.result() );
     }
 
+    public_key decompressed_public_key::child( const fc::sha256& offset )const
+    {
+       fc::sha256::encoder enc;
+       fc::raw::pack( enc, _key );
+       fc::raw::pack( enc, offset );
+
+       return add( enc.result() );
+    }
+
     private_key private_key::child( const fc::sha256& offset )const
     {
        fc::sha256::encoder enc;
@@ -175,6 +185,83 @@ namespace fc { namespace ecc {
                && !(c.data[33] == 0 && !(c.data[34] & 0x80));
     }
 
+    std::vector<recovered_key> recover_batch( const signature_digest* items, size_t count,
+                                              bool check_canonical, worker_pool* pool )
+    {
+        std::vector<recovered_key> results( count );
+        // recovery is read-only on the shared secp256k1 context, so workers need no context of their own
+        auto recover_range = [&]( size_t begin, size_t end ) {
+            for( size_t i = begin; i < end; ++i )
+            {
+                try
+                {
+                    results[i].key = public_key( items[i].first, items[i].second, check_canonical ).serialize();
+                }
+                catch( const fc::exception& e )
+                {
+                    results[i].error = e.dynamic_copy_exception();
+                }
+                catch( ... )
+                {
+                    results[i].error = std::make_shared<unhandled_exception>(
+                        FC_LOG_MESSAGE( warn, "unable to reconstruct public key from signature" ) );
+                }
+            }
+        };
+        // a recovery takes tens of microseconds, keep chunks large enough to amortize the hand-off
+        ( pool ? *pool : worker_pool::get_default() ).for_each_range( count, recover_range, 8 );
+        return results;
+    }
+
+    std::vector<recovered_key> recover_batch( const std::vector<signature_digest>& items,
+                                              bool check_canonical, worker_pool* pool )
+    {
+        return recover_batch( items.data(), items.size(), check_canonical, pool );
+    }
+
+    namespace {
+        /// signs digests[i] with key_at( i ), the shared secp256k1 context is only read while signing
+        template<typename KeyAt>
+        std::vector<compact_signature> sign_range( KeyAt&& key_at, const fc::sha256* digests, size_t count,
+                                                   bool require_canonical, worker_pool* pool )
+        {
+            std::vector<compact_signature> results( count );
+            ( pool ? *pool : worker_pool::get_default() ).for_each_range( count, [&]( size_t begin, size_t end ) {
+                for( size_t i = begin; i < end; ++i )
+                    results[i] = key_at( i ).sign_compact( digests[i], require_canonical );
+            }, 8 );
+            return results;
+        }
+    }
+
+    std::vector<compact_signature> sign_compact_batch( const private_key* keys, const fc::sha256* digests,
+                                                       size_t count, bool require_canonical, worker_pool* pool )
+    {
+        return sign_range( [keys]( size_t i ) -> const private_key& { return keys[i]; },
+                           digests, count, require_canonical, pool );
+    }
+
+    std::vector<compact_signature> sign_compact_batch( const std::vector<private_key>& keys,
+                                                       const std::vector<fc::sha256>& digests,
+                                                       bool require_canonical, worker_pool* pool )
+    {
+        FC_ASSERT( keys.size() == digests.size(), "one key per digest",
+                   ("keys", keys.size())("digests", digests.size()) );
+        return sign_compact_batch( keys.data(), digests.data(), digests.size(), require_canonical, pool );
+    }
+
+    std::vector<compact_signature> sign_compact_batch( const private_key& key, const std::vector<fc::sha256>& digests,
+                                                       bool require_canonical, worker_pool* pool )
+    {
+        return sign_range( [&key]( size_t ) -> const private_key& { return key; },
+                           digests.data(), digests.size(), require_canonical, pool );
+    }
+
+    std::vector<decompressed_public_key> decompress_batch( const std::vector<public_key_data>& keys, worker_pool* pool )
+    {
+        return decompress_batch( keys.data(), keys.size(), pool );
+    }
+
     private_key private_key::generate_from_seed( const fc::sha256& seed, const fc::sha256& offset )
     {
         ssl_bignum z;
@@ -235,7 +322,7 @@ namespace fc { namespace ecc {
         memcpy( buffer, key.begin(), key.size() );
         fc::sha256 double_hash = fc::sha256::hash( fc::sha256::hash( key.begin(), key.size() ));
         memcpy( buffer + key.size(), double_hash.data(), 4 );
-        return fc::to_base58( buffer, sizeof(buffer) );
+        return fc::to_base58( buffer, key.size() + 4 );
     }
 
     static void _parse_extended_data( unsigned char* buffer, std::string base58 )
@@ -1,7 +1,9 @@
 #include <fc/fwd_impl.hpp>
+#include <fc/thread/worker_pool.hpp>
 #include <boost/config.hpp>
 
 #include "_elliptic_impl_pub.hpp"
+#include "_recovery_cache.hpp"
 
 /* used by mixed + openssl */
 
@@ -318,6 +320,41 @@ namespace fc { namespace ecc {
       }
     }
 
+    // the EC_KEY of a public_key already holds the decoded point, there is nothing more to keep
+    decompressed_public_key::decompressed_public_key() {}
+
+    decompressed_public_key::decompressed_public_key( const public_key& k ) : _key( k ) {}
+
+    decompressed_public_key::decompressed_public_key( const decompressed_public_key& k ) : _key( k._key ) {}
+
+    decompressed_public_key::~decompressed_public_key() {}
+
+    decompressed_public_key& decompressed_public_key::operator=( const decompressed_public_key& k )
+    {
+        _key = k._key;
+        return *this;
+    }
+
+    public_key decompressed_public_key::add( const fc::sha256& offset )const
+    {
+        return _key.add( offset );
+    }
+
+    public_key_point_data decompressed_public_key::serialize_ecc_point()const
+    {
+        return _key.serialize_ecc_point();
+    }
+
+    std::vector<decompressed_public_key> decompress_batch( const public_key_data* keys, size_t count, worker_pool* pool )
+    {
+        std::vector<decompressed_public_key> result( count );
+        ( pool ? *pool : worker_pool::get_default() ).for_each_range( count, [&]( size_t begin, size_t end ) {
+            for( size_t i = begin; i < end; ++i )
+                result[i] = decompressed_public_key( public_key( keys[i] ) );
+        }, 32 );
+        return result;
+    }
+
 //    bool       private_key::verify( const fc::sha256& digest, const fc::ecc::signature& sig )
 //    {
 //      return 1 == ECDSA_verify( 0, (unsigned char*)&digest, sizeof(digest), (unsigned char*)&sig, sizeof(sig), my->_key );
@@ -329,15 +366,22 @@ namespace fc { namespace ecc {
         if (nV<27 || nV>=35)
             FC_THROW_EXCEPTION( exception, "unable to reconstruct public key from signature" );
 
-        ECDSA_SIG *sig = ECDSA_SIG_new();
-        BN_bin2bn(&c.data[1],32,sig->r);
-        BN_bin2bn(&c.data[33],32,sig->s);
-
         if( check_canonical )
         {
             FC_ASSERT( is_canonical( c ), "signature is not canonical" );
         }
 
+        public_key_data cached;
+        if( detail::find_recovered_key( c, digest, cached ) )
+        {
+            *this = public_key( cached );
+            return;
+        }
+
+        ECDSA_SIG *sig = ECDSA_SIG_new();
+        BN_bin2bn(&c.data[1],32,sig->r);
+        BN_bin2bn(&c.data[33],32,sig->s);
+
         my->_key = EC_KEY_new_by_curve_name(NID_secp256k1);
 
         if (nV >= 31)
@@ -350,6 +394,7 @@ namespace fc { namespace ecc {
         if (detail::public_key_impl::ECDSA_SIG_recover_key_GFp(my->_key, sig, (unsigned char*)&digest, sizeof(digest), nV - 27, 0) == 1)
         {
             ECDSA_SIG_free(sig);
+            detail::remember_recovered_key( c, digest, serialize() );
             return;
         }
         ECDSA_SIG_free(sig);
@@ -6,6 +6,7 @@
 #include <fc/crypto/sha512.hpp>
 
 #include <fc/fwd_impl.hpp>
+#include <fc/thread/worker_pool.hpp>
 #include <fc/exception/exception.hpp>
 #include <fc/log/logger.hpp>
 
@@ -23,6 +24,7 @@
 #endif
 
 #include "_elliptic_impl_priv.hpp"
+#include "_recovery_cache.hpp"
 
 namespace fc {
     namespace ecc {
@@ -53,10 +55,22 @@ namespace fc {
                 public_key_data _key;
             };
 
+            class public_key_point_impl {
+            public:
+                public_key_point_impl() BOOST_NOEXCEPT {
+                    _init_lib();
+                    memset(&_point, 0, sizeof(_point));
+                }
+
+                secp256k1_pubkey _point;
+            };
+
             typedef fc::array<char, 37> chr37;
 
             chr37 _derive_message(const public_key_data &key, int i);
 
+            chr37 _derive_message(const private_key_secret &key, int i);
+
             fc::sha256 _left(const fc::sha512 &v);
 
             fc::sha256 _right(const fc::sha512 &v);
@@ -178,6 +192,10 @@ namespace fc {
                 FC_ASSERT(is_canonical(c), "signature is not canonical");
             }
 
+            if (detail::find_recovered_key(c, digest, my->_key)) {
+                return;
+            }
+
             secp256k1_ecdsa_recoverable_signature sig;
             FC_ASSERT(secp256k1_ecdsa_recoverable_signature_parse_compact(detail::_get_context(), &sig, (const unsigned char*)c.begin() + 1, (*c.begin() - 27) & 3));
 
@@ -187,6 +205,57 @@ namespace fc {
             size_t pk_len = my->_key.size();
             FC_ASSERT(secp256k1_ec_pubkey_serialize(detail::_get_context(), (unsigned char*)my->_key.begin(), &pk_len, &recovered_key, SECP256K1_EC_COMPRESSED));
             FC_ASSERT(pk_len == my->_key.size());
+            detail::remember_recovered_key(c, digest, my->_key);
+        }
+
+        decompressed_public_key::decompressed_public_key() {}
+
+        decompressed_public_key::decompressed_public_key(const public_key &k) : _key(k) {
+            const public_key_data data = k.serialize();
+            FC_ASSERT(secp256k1_ec_pubkey_parse(detail::_get_context(), &_point->_point, (const unsigned char*)data.begin(), data.size()));
+        }
+
+        decompressed_public_key::decompressed_public_key(const decompressed_public_key &k)
+                : _key(k._key), _point(k._point) {}
+
+        decompressed_public_key::~decompressed_public_key() {}
+
+        decompressed_public_key &decompressed_public_key::operator=(const decompressed_public_key &k) {
+            _key = k._key;
+            _point = k._point;
+            return *this;
+        }
+
+        public_key decompressed_public_key::add(const fc::sha256 &digest) const {
+            FC_ASSERT(_key.valid());
+
+            secp256k1_pubkey pubkey = _point->_point;
+            FC_ASSERT(secp256k1_ec_pubkey_tweak_add(detail::_get_context(), &pubkey, (unsigned char*)digest.data()));
+
+            public_key_data new_key;
+            size_t pk_len = new_key.size();
+            FC_ASSERT(secp256k1_ec_pubkey_serialize(detail::_get_context(), (unsigned char*)new_key.begin(), &pk_len, &pubkey, SECP256K1_EC_COMPRESSED));
+            return public_key(new_key);
+        }
+
+        public_key_point_data decompressed_public_key::serialize_ecc_point() const {
+            FC_ASSERT(_key.valid());
+
+            public_key_point_data dat;
+            size_t pk_len = dat.size();
+            FC_ASSERT(secp256k1_ec_pubkey_serialize(detail::_get_context(), (unsigned char*)dat.begin(), &pk_len, &_point->_point, SECP256K1_EC_UNCOMPRESSED));
+            FC_ASSERT(pk_len == dat.size());
+            return dat;
+        }
+
+        std::vector<decompressed_public_key> decompress_batch(const public_key_data *keys, size_t count, worker_pool *pool) {
+            std::vector<decompressed_public_key> result(count);
+            (pool ? *pool : worker_pool::get_default()).for_each_range(count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    result[i] = decompressed_public_key(public_key(keys[i]));
+                }
+            }, 32);
+            return result;
         }
 
         extended_public_key::extended_public_key(const public_key &k, const fc::sha256 &c, int child, int parent,
@@ -195,22 +264,54 @@ namespace fc {
         }
 
         extended_public_key extended_public_key::derive_normal_child(int i) const {
-            public_key_data key = serialize();
-            const detail::chr37 data = detail::_derive_message(key, i);
+            const detail::chr37 data = detail::_derive_message(serialize(), i);
             fc::sha512 l = hmac_sha512().digest(c.data(), c.data_size(), data.begin(), data.size());
-            fc::sha256 left = detail::_left(l);
+            return derive_rest(decompressed_public_key(*this), l, i, fingerprint());
+        }
+
+        extended_public_key extended_public_key::derive_rest(const decompressed_public_key &point, const fc::sha512 &hash,
+                                                             int i, int fingerprint) const {
+            fc::sha256 left = detail::_left(hash);
             FC_ASSERT(left < detail::get_curve_order());
 
-            secp256k1_pubkey pubkey;
-            FC_ASSERT(secp256k1_ec_pubkey_parse(detail::_get_context(), &pubkey, (const unsigned char*)key.begin(), key.size()));
+            secp256k1_pubkey pubkey = point._point->_point;
 
             FC_ASSERT(secp256k1_ec_pubkey_tweak_add(detail::_get_context(), &pubkey, (const unsigned char*)left.data()));
 
+            public_key_data key;
             size_t pk_len = key.size();
             FC_ASSERT(secp256k1_ec_pubkey_serialize(detail::_get_context(), (unsigned char*)key.begin(), &pk_len, &pubkey, SECP256K1_EC_COMPRESSED));
 
             // FIXME: check validity - if left + key == infinity then invalid
-            extended_public_key result(key, detail::_right(l), i, fingerprint(), depth + 1);
+            extended_public_key result(key, detail::_right(hash), i, fingerprint, depth + 1);
+            return result;
+        }
+
+        extended_public_key_deriver::extended_public_key_deriver(const extended_public_key &parent)
+                : parent(parent), point(parent), key(parent.serialize()), mac(parent.c.data(), parent.c.data_size()),
+                  fingerprint(parent.fingerprint()) {
+        }
+
+        extended_public_key extended_public_key_deriver::derive_child(int i) const {
+            FC_ASSERT(!(i & 0x80000000), "Can't derive hardened public key!");
+            const detail::chr37 data = detail::_derive_message(key, i);
+            return parent.derive_rest(point, mac.digest(data.begin(), data.size()), i, fingerprint);
+        }
+
+        std::vector<extended_public_key> extended_public_key_deriver::derive_children(int first, size_t count,
+                                                                                      worker_pool *pool) const {
+            FC_ASSERT(first >= 0 && uint64_t(first) + count <= 0x80000000u, "Can't derive hardened public key!",
+                      ("first", first)("count", count));
+            std::vector<extended_public_key> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                result.push_back(parent);
+            }
+            (pool ? *pool : worker_pool::get_default()).for_each_range(count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    result[i] = derive_child(first + int(i));
+                }
+            }, 16);
             return result;
         }
 
@@ -373,15 +474,47 @@ namespace fc {
         }
 
         extended_private_key extended_private_key::private_derive_rest(const fc::sha512 &hash, int i) const {
+            return private_derive_rest(hash, i, fingerprint());
+        }
+
+        extended_private_key extended_private_key::private_derive_rest(const fc::sha512 &hash, int i,
+                                                                       int fingerprint) const {
             fc::sha256 left = detail::_left(hash);
             FC_ASSERT(left < detail::get_curve_order());
             FC_ASSERT(secp256k1_ec_privkey_tweak_add(detail::_get_context(), (unsigned char *) left.data(),
                                                      (unsigned char *) get_secret().data()) > 0);
-            extended_private_key result(private_key::regenerate(left), detail::_right(hash), i, fingerprint(),
+            extended_private_key result(private_key::regenerate(left), detail::_right(hash), i, fingerprint,
                                         depth + 1);
             return result;
         }
 
+        extended_private_key_deriver::extended_private_key_deriver(const extended_private_key &parent)
+                : parent(parent), secret(parent.get_secret()), key(parent.get_public_key().serialize()),
+                  mac(parent.c.data(), parent.c.data_size()), fingerprint(public_key(key).fingerprint()) {
+        }
+
+        extended_private_key extended_private_key_deriver::derive_child(int i) const {
+            const detail::chr37 data = i < 0 ? detail::_derive_message(secret, i) : detail::_derive_message(key, i);
+            return parent.private_derive_rest(mac.digest(data.begin(), data.size()), i, fingerprint);
+        }
+
+        std::vector<extended_private_key> extended_private_key_deriver::derive_children(int first, size_t count,
+                                                                                        worker_pool *pool) const {
+            FC_ASSERT(uint64_t(uint32_t(first)) + count <= uint64_t(1) << 32, "index out of range",
+                      ("first", first)("count", count));
+            std::vector<extended_private_key> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                result.push_back(parent);
+            }
+            (pool ? *pool : worker_pool::get_default()).for_each_range(count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    result[i] = derive_child(int(uint32_t(first) + uint32_t(i)));
+                }
+            }, 16);
+            return result;
+        }
+
         public_key extended_private_key::blind_public_key(const extended_public_key &bob, int i) const {
             private_key_secret a = generate_a(i).get_secret();
             private_key_secret b = generate_b(i).get_secret();
@@ -563,6 +696,66 @@ namespace fc {
             return true;
         }
 
+        namespace {
+            bool parse_commitments(const std::vector<commitment_type> &in, std::vector<secp256k1_pedersen_commitment> &out,
+                                   std::vector<const secp256k1_pedersen_commitment *> &ptrs) {
+                out.resize(in.size());
+                ptrs.resize(in.size());
+                for (size_t i = 0; i < in.size(); ++i) {
+                    if (!secp256k1_pedersen_commitment_parse(detail::_get_context(), &out[i],
+                                                             (const unsigned char *) in[i].begin())) {
+                        return false;
+                    }
+                    ptrs[i] = &out[i];
+                }
+                return true;
+            }
+        }
+
+        std::vector<range_proof_result> verify_range_batch(const commitment_range_proof *items, size_t count,
+                                                           worker_pool *pool) {
+            std::vector<range_proof_result> results(count);
+            // verification only reads the shared context, each proof needs nothing but the stack
+            (pool ? *pool : worker_pool::get_default()).for_each_range(count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    range_proof_result &r = results[i];
+                    r.min_value = r.max_value = 0;
+                    secp256k1_pedersen_commitment commitment;
+                    r.valid = secp256k1_pedersen_commitment_parse(detail::_get_context(), &commitment,
+                                                                  (const unsigned char *) items[i].first.begin()) &&
+                              secp256k1_rangeproof_verify(detail::_get_context(), &r.min_value, &r.max_value,
+                                                          &commitment, (const unsigned char *) items[i].second.data(),
+                                                          items[i].second.size(), NULL, 0, secp256k1_generator_h);
+                }
+            });
+            return results;
+        }
+
+        std::vector<range_proof_result> verify_range_batch(const std::vector<commitment_range_proof> &items,
+                                                           worker_pool *pool) {
+            return verify_range_batch(items.data(), items.size(), pool);
+        }
+
+        std::vector<bool> verify_sum_batch(const commitment_sum *items, size_t count, worker_pool *pool) {
+            std::vector<uint8_t> valid(count);
+            (pool ? *pool : worker_pool::get_default()).for_each_range(count, [&](size_t begin, size_t end) {
+                std::vector<secp256k1_pedersen_commitment> commits, neg_commits;
+                std::vector<const secp256k1_pedersen_commitment *> commit_ptrs, neg_commit_ptrs;
+                for (size_t i = begin; i < end; ++i) {
+                    valid[i] = parse_commitments(items[i].first, commits, commit_ptrs) &&
+                               parse_commitments(items[i].second, neg_commits, neg_commit_ptrs) &&
+                               secp256k1_pedersen_verify_tally(detail::_get_context(), commit_ptrs.data(),
+                                                               commit_ptrs.size(), neg_commit_ptrs.data(),
+                                                               neg_commit_ptrs.size());
+                }
+            }, 4);
+            return std::vector<bool>(valid.begin(), valid.end());
+        }
+
+        std::vector<bool> verify_sum_batch(const std::vector<commitment_sum> &items, worker_pool *pool) {
+            return verify_sum_batch(items.data(), items.size(), pool);
+        }
+
         range_proof_info range_get_info(const std::vector<char> &proof) {
             range_proof_info result;
             FC_ASSERT(secp256k1_rangeproof_info(detail::_get_context(), (int *) &result.exp, (int *) &result.mantissa,
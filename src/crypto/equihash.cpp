@@ -1,6 +1,11 @@
 #include <equihash/pow.hpp>
 
 #include <fc/crypto/equihash.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include "_equihash_solver.hpp"
+
+#include <algorithm>
 
 #define EQUIHASH_NONCE 2
 
@@ -34,21 +39,135 @@ namespace fc {
             return test.Test();
         }
 
+        namespace {
+            /// _POW::Proof::CheckIndexesCanon()
+            bool is_canonical(const std::vector<uint32_t> &inputs) {
+                for (size_t half = 1, block = 2; block <= inputs.size(); half = block, block += block) {
+                    for (size_t i = 0; i + block <= inputs.size(); i += block) {
+                        if (inputs[i] >= inputs[i + half]) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            /**
+             *  proof::is_valid() on the lane hasher.  With test_intermediate_zeros the cheap checks on the
+             *  indexes come first and the inputs are hashed a pair at a time, so a proof whose first pair
+             *  does not collide costs two hashes instead of 2^k.  Parameters the vendored code would read
+             *  out of bounds with (k > 7 or n < k + 1) make a proof invalid.
+             */
+            bool verify(const proof &p, bool test_canonical_order, bool test_intermediate_zeros,
+                        std::vector<uint32_t> &values) {
+                if (p.k > 7) {
+                    return false;
+                }
+                const uint32_t bits = p.n / (p.k + 1);
+                if (bits == 0 || bits > 32) {
+                    return false;
+                }
+                const std::vector<uint32_t> &inputs = p.inputs;
+                if (test_canonical_order && !is_canonical(inputs)) {
+                    return false;
+                }
+
+                const unsigned width = p.k + 1, shift = 32 - bits;
+                if (test_intermediate_zeros) {
+                    if (inputs.size() != size_t(1) << p.k) {
+                        return false;
+                    }
+                    values.assign(inputs.begin(), inputs.end());
+                    std::sort(values.begin(), values.end());
+                    if (std::adjacent_find(values.begin(), values.end()) != values.end() ||
+                        values.back() >= uint64_t(1) << (bits + 1)) {
+                        return false;
+                    }
+                }
+
+                const _POW::Seed seed = sha_to_seed(p.seed);
+                const detail::equihash_hasher &hasher = detail::get_equihash_hasher();
+                uint32_t digests[4 * 8];
+
+                if (!test_intermediate_zeros) {
+                    // _POW::Proof::Test(): every block of the hashes XORs to zero
+                    uint32_t blocks[8] = {};
+                    for (size_t i = 0; i < inputs.size(); i += 4) {
+                        const size_t count = std::min<size_t>(4, inputs.size() - i);
+                        hasher.hash(seed.v.data(), EQUIHASH_NONCE, inputs.data() + i, count, digests);
+                        for (size_t j = 0; j < count; ++j) {
+                            for (unsigned b = 0; b < width; ++b) {
+                                blocks[b] ^= digests[8 * j + b] >> shift;
+                            }
+                        }
+                    }
+                    return !inputs.empty() && std::all_of(blocks, blocks + width, [](uint32_t b) { return b == 0; });
+                }
+
+                // _POW::Proof::FullTest(): pairs collide on their first block at every level of the tree,
+                // checked for the leaves as soon as a pair is hashed
+                values.resize(inputs.size() * width);
+                for (size_t i = 0; i < inputs.size(); i += 4) {
+                    const size_t count = std::min<size_t>(4, inputs.size() - i);
+                    hasher.hash(seed.v.data(), EQUIHASH_NONCE, inputs.data() + i, count, digests);
+                    for (size_t j = 0; j < count; ++j) {
+                        for (unsigned b = 0; b < width; ++b) {
+                            values[(i + j) * width + b] = digests[8 * j + b] >> shift;
+                        }
+                        if ((j & 1) && values[(i + j - 1) * width] != values[(i + j) * width]) {
+                            return false;
+                        }
+                    }
+                }
+                for (size_t count = inputs.size(), level = 0; count > 1; count /= 2, ++level) {
+                    for (size_t i = 0; i < count; i += 2) {
+                        const uint32_t *a = values.data() + i * width, *b = a + width;
+                        if (a[0] != b[0]) {
+                            return false;
+                        }
+                        uint32_t *out = values.data() + i / 2 * width;
+                        for (unsigned j = 1; j < width - level; ++j) {
+                            out[j - 1] = a[j] ^ b[j];
+                        }
+                    }
+                }
+                return values[0] == 0;
+            }
+        }
+
+        std::vector<bool> is_valid_batch(const proof *proofs, size_t count, bool test_canonical_order,
+                                         bool test_intermediate_zeros, worker_pool *pool) {
+            std::vector<uint8_t> valid(count);
+            worker_pool &workers = pool ? *pool : worker_pool::get_default();
+            workers.for_each_range(count, [&](size_t begin, size_t end) {
+                std::vector<uint32_t> values;
+                for (size_t i = begin; i < end; ++i) {
+                    valid[i] = verify(proofs[i], test_canonical_order, test_intermediate_zeros, values);
+                }
+            }, 4);
+            return std::vector<bool>(valid.begin(), valid.end());
+        }
+
+        std::vector<bool> is_valid_batch(const std::vector<proof> &proofs, bool test_canonical_order,
+                                         bool test_intermediate_zeros, worker_pool *pool) {
+            return is_valid_batch(proofs.data(), proofs.size(), test_canonical_order, test_intermediate_zeros, pool);
+        }
+
         void proof::canonize_indexes() {
             _POW::Proof p(n, k, sha_to_seed(seed), EQUIHASH_NONCE, inputs);
             _POW::Proof p_canon = p.CanonizeIndexes();
             inputs = p_canon.inputs;
         }
 
-        proof proof::hash(uint32_t n, uint32_t k, sha256 seed) {
-            auto hash = _POW::Equihash(n, k, sha_to_seed(seed));
-            auto result = hash.FindProof(EQUIHASH_NONCE);
+        proof proof::hash(uint32_t n, uint32_t k, sha256 seed, worker_pool *pool) {
+            const _POW::Seed s = sha_to_seed(seed);
 
             proof p;
             p.n = n;
             p.k = k;
             p.seed = seed;
-            p.inputs = result.inputs;
+            p.inputs = detail::equihash_solve(n, k, s.v.data(), EQUIHASH_NONCE, pool ? *pool : worker_pool::get_default());
+            p.canonize_indexes();
 
             return p;
         }
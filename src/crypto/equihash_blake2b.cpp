@@ -0,0 +1,88 @@
+#include "_equihash.hpp"
+#include "_cpu_features.hpp"
+
+namespace fc { namespace detail {
+
+namespace {
+    inline uint64_t rotr64( uint64_t w, unsigned c )
+    {
+        return ( w >> c ) | ( w << ( 64 - c ) );
+    }
+
+#define EQUIHASH_G( r, i, a, b, c, d )                       \
+    do {                                                     \
+        a = a + b + m[blake2b_sigma[r][2 * i]];              \
+        d = rotr64( d ^ a, 32 );                             \
+        c = c + d;                                           \
+        b = rotr64( b ^ c, 24 );                             \
+        a = a + b + m[blake2b_sigma[r][2 * i + 1]];          \
+        d = rotr64( d ^ a, 16 );                             \
+        c = c + d;                                           \
+        b = rotr64( b ^ c, 63 );                             \
+    } while( 0 )
+
+    /** BLAKE2b-256 of the single block m, holding 24 bytes of input */
+    void blake2b_24( const uint64_t* m, uint32_t* out )
+    {
+        uint64_t v[16];
+        for( int i = 0; i < 8; ++i )
+        {
+            v[i] = blake2b_iv[i];
+            v[i + 8] = blake2b_iv[i];
+        }
+        v[0] ^= equihash_blake2b_param;
+        const uint64_t h0 = v[0];
+        v[12] ^= equihash_blake2b_input_length;
+        v[14] = ~v[14];
+
+        for( int r = 0; r < 12; ++r )
+        {
+            EQUIHASH_G( r, 0, v[0], v[4], v[8], v[12] );
+            EQUIHASH_G( r, 1, v[1], v[5], v[9], v[13] );
+            EQUIHASH_G( r, 2, v[2], v[6], v[10], v[14] );
+            EQUIHASH_G( r, 3, v[3], v[7], v[11], v[15] );
+            EQUIHASH_G( r, 4, v[0], v[5], v[10], v[15] );
+            EQUIHASH_G( r, 5, v[1], v[6], v[11], v[12] );
+            EQUIHASH_G( r, 6, v[2], v[7], v[8], v[13] );
+            EQUIHASH_G( r, 7, v[3], v[4], v[9], v[14] );
+        }
+
+        for( int i = 0; i < 4; ++i )
+        {
+            const uint64_t h = ( i ? blake2b_iv[i] : h0 ) ^ v[i] ^ v[i + 8];
+            out[2 * i] = uint32_t( h );
+            out[2 * i + 1] = uint32_t( h >> 32 );
+        }
+    }
+
+#undef EQUIHASH_G
+
+    equihash_hasher choose_equihash_hasher()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        if( get_cpu_features().avx2 )
+            return { &equihash_hash_avx2, "avx2" };
+#endif
+        return { &equihash_hash_portable, "portable" };
+    }
+}
+
+void equihash_hash_portable( const uint32_t* seed, uint32_t nonce, const uint32_t* indexes, size_t count, uint32_t* out )
+{
+    uint64_t m[16] = {};
+    m[0] = seed[0] | uint64_t( seed[1] ) << 32;
+    m[1] = seed[2] | uint64_t( seed[3] ) << 32;
+    for( size_t i = 0; i < count; ++i, out += 8 )
+    {
+        m[2] = nonce | uint64_t( indexes[i] ) << 32;
+        blake2b_24( m, out );
+    }
+}
+
+const equihash_hasher& get_equihash_hasher()
+{
+    static const equihash_hasher hasher = choose_equihash_hasher();
+    return hasher;
+}
+
+} } // fc::detail
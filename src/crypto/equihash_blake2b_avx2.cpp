@@ -0,0 +1,115 @@
+#include "_equihash.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+#include <cstring>
+
+/* compiled with AVX2 enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    const size_t lanes = 4;
+
+    inline __m256i rotr32( __m256i x )
+    {
+        return _mm256_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+    }
+
+    inline __m256i rotr24( __m256i x )
+    {
+        const __m256i r24 = _mm256_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                              3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10 );
+        return _mm256_shuffle_epi8( x, r24 );
+    }
+
+    inline __m256i rotr16( __m256i x )
+    {
+        const __m256i r16 = _mm256_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                              2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9 );
+        return _mm256_shuffle_epi8( x, r16 );
+    }
+
+    inline __m256i rotr63( __m256i x )
+    {
+        return _mm256_or_si256( _mm256_srli_epi64( x, 63 ), _mm256_add_epi64( x, x ) );
+    }
+
+#define EQUIHASH_G4( r, i, a, b, c, d )                                                      \
+    do {                                                                                     \
+        a = _mm256_add_epi64( _mm256_add_epi64( a, b ), m[blake2b_sigma[r][2 * i]] );       \
+        d = rotr32( _mm256_xor_si256( d, a ) );                                              \
+        c = _mm256_add_epi64( c, d );                                                        \
+        b = rotr24( _mm256_xor_si256( b, c ) );                                              \
+        a = _mm256_add_epi64( _mm256_add_epi64( a, b ), m[blake2b_sigma[r][2 * i + 1]] );   \
+        d = rotr16( _mm256_xor_si256( d, a ) );                                              \
+        c = _mm256_add_epi64( c, d );                                                        \
+        b = rotr63( _mm256_xor_si256( b, c ) );                                              \
+    } while( 0 )
+
+    /** four BLAKE2b-256 digests, one per 64 bit lane of the message words */
+    void blake2b_24x4( const __m256i* m, uint32_t* out, size_t count )
+    {
+        __m256i v[16];
+        for( int i = 0; i < 8; ++i )
+        {
+            v[i] = _mm256_set1_epi64x( int64_t( blake2b_iv[i] ) );
+            v[i + 8] = v[i];
+        }
+        v[0] = _mm256_xor_si256( v[0], _mm256_set1_epi64x( int64_t( equihash_blake2b_param ) ) );
+        const __m256i h0 = v[0];
+        v[12] = _mm256_xor_si256( v[12], _mm256_set1_epi64x( int64_t( equihash_blake2b_input_length ) ) );
+        v[14] = _mm256_xor_si256( v[14], _mm256_set1_epi64x( -1 ) );
+
+        for( int r = 0; r < 12; ++r )
+        {
+            EQUIHASH_G4( r, 0, v[0], v[4], v[8], v[12] );
+            EQUIHASH_G4( r, 1, v[1], v[5], v[9], v[13] );
+            EQUIHASH_G4( r, 2, v[2], v[6], v[10], v[14] );
+            EQUIHASH_G4( r, 3, v[3], v[7], v[11], v[15] );
+            EQUIHASH_G4( r, 4, v[0], v[5], v[10], v[15] );
+            EQUIHASH_G4( r, 5, v[1], v[6], v[11], v[12] );
+            EQUIHASH_G4( r, 6, v[2], v[7], v[8], v[13] );
+            EQUIHASH_G4( r, 7, v[3], v[4], v[9], v[14] );
+        }
+
+        // h[i] of every lane, then transposed so each digest is contiguous
+        alignas( 32 ) uint64_t h[4][lanes];
+        for( int i = 0; i < 4; ++i )
+        {
+            const __m256i iv = i ? _mm256_set1_epi64x( int64_t( blake2b_iv[i] ) ) : h0;
+            _mm256_store_si256( (__m256i*)h[i], _mm256_xor_si256( iv, _mm256_xor_si256( v[i], v[i + 8] ) ) );
+        }
+        for( size_t lane = 0; lane < count; ++lane, out += 8 )
+            for( int i = 0; i < 4; ++i )
+                memcpy( out + 2 * i, &h[i][lane], sizeof( uint64_t ) );
+    }
+
+#undef EQUIHASH_G4
+}
+
+void equihash_hash_avx2( const uint32_t* seed, uint32_t nonce, const uint32_t* indexes, size_t count, uint32_t* out )
+{
+    __m256i m[16];
+    for( int i = 3; i < 16; ++i )
+        m[i] = _mm256_setzero_si256();
+    m[0] = _mm256_set1_epi64x( int64_t( seed[0] | uint64_t( seed[1] ) << 32 ) );
+    m[1] = _mm256_set1_epi64x( int64_t( seed[2] | uint64_t( seed[3] ) << 32 ) );
+
+    for( size_t i = 0; i < count; i += lanes, out += 8 * lanes )
+    {
+        const size_t n = count - i < lanes ? count - i : lanes;
+        uint32_t index[lanes] = {};
+        memcpy( index, indexes + i, n * sizeof( uint32_t ) );
+        // index in the high half of each lane, the nonce in the low half
+        m[2] = _mm256_or_si256( _mm256_slli_epi64( _mm256_cvtepu32_epi64( _mm_loadu_si128( (const __m128i*)index ) ), 32 ),
+                                _mm256_set1_epi64x( nonce ) );
+        blake2b_24x4( m, out, n );
+    }
+}
+
+} } // fc::detail
+
+#endif
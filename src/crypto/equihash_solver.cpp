@@ -0,0 +1,372 @@
+#include "_equihash_solver.hpp"
+
+#include <fc/exception/exception.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <equihash/pow.hpp>
+
+#include <algorithm>
+#include <memory>
+
+/* Wagner's algorithm as in the vendored _POW::Equihash, on flat storage and
+ * over a worker_pool.  Rows keep at most LIST_LENGTH entries and a level at
+ * most FORK_MULTIPLIER forks per row, so which entries survive depends on the
+ * order they are found in.  To return the same proof as the serial solver,
+ * each stage works on a window of rows or indexes in three steps:
+ *
+ *  - the new entries are computed in parallel over contiguous parts of the
+ *    window, each part keeping them in serial order;
+ *  - they are inserted in parallel over ranges of destination rows, each
+ *    thread scanning every part in order and taking only its own rows;
+ *  - the surviving entries are numbered in order, which gives the references
+ *    of the next level.
+ */
+
+namespace fc { namespace detail {
+
+namespace {
+
+struct equihash_fork
+{
+    uint32_t ref1;
+    uint32_t ref2;
+};
+
+/**
+ *  One level of the bucket table in a single allocation: row r holds up to LIST_LENGTH
+ *  entries of blocks + 1 words, the reference to the fork or index the entry came from
+ *  followed by the blocks still to be collided.
+ */
+class equihash_table
+{
+public:
+    equihash_table( size_t rows, unsigned max_blocks )
+        : _rows( rows ), _blocks( 0 ), _words( new uint32_t[rows * LIST_LENGTH * ( max_blocks + 1 )] ), _filled( rows )
+    {
+    }
+
+    void reset( unsigned blocks )
+    {
+        _blocks = blocks;
+        std::fill( _filled.begin(), _filled.end(), 0 );
+    }
+
+    size_t rows() const
+    {
+        return _rows;
+    }
+
+    unsigned blocks() const
+    {
+        return _blocks;
+    }
+
+    uint8_t& filled( size_t row )
+    {
+        return _filled[row];
+    }
+
+    unsigned filled( size_t row ) const
+    {
+        return _filled[row];
+    }
+
+    uint32_t* entry( size_t row, unsigned slot )
+    {
+        return _words.get() + ( row * LIST_LENGTH + slot ) * ( _blocks + 1 );
+    }
+
+    const uint32_t* entry( size_t row, unsigned slot ) const
+    {
+        return _words.get() + ( row * LIST_LENGTH + slot ) * ( _blocks + 1 );
+    }
+
+private:
+    size_t _rows;
+    unsigned _blocks;
+    std::unique_ptr<uint32_t[]> _words;
+    std::vector<uint8_t> _filled;
+};
+
+/** entries for the next table, in the order the serial solver finds them */
+struct equihash_batch
+{
+    std::vector<uint32_t> rows;
+    /** the blocks of entry i start at i times the number of blocks of the table */
+    std::vector<uint32_t> blocks;
+    /** the pair of entries each collision came from, not used when filling */
+    std::vector<equihash_fork> forks;
+    /** the slot entry i was given, LIST_LENGTH if its row was full */
+    std::vector<uint8_t> slots;
+
+    void clear()
+    {
+        rows.clear();
+        blocks.clear();
+        forks.clear();
+        slots.clear();
+    }
+};
+
+class equihash_solver
+{
+public:
+    equihash_solver( unsigned n, unsigned k, const uint32_t* seed, uint32_t nonce, worker_pool& pool )
+        : _k( k ), _bits( n / ( k + 1 ) ), _nonce( nonce ), _pool( pool ),
+          _current( new equihash_table( size_t( 1 ) << _bits, k ) ),
+          _next( new equihash_table( size_t( 1 ) << _bits, k - 1 ) ),
+          _parts( 4 * ( pool.size() + 1 ) ),
+          _window( std::max<size_t>( 1 << 14, size_t( pool.size() + 1 ) << 14 ) )
+    {
+        std::copy( seed, seed + SEED_LENGTH, _seed );
+    }
+
+    std::vector<uint32_t> solve()
+    {
+        fill();
+        for( unsigned level = 1; level < _k; ++level )
+            collide();
+        return find_solution();
+    }
+
+private:
+    void fill()
+    {
+        equihash_table& table = *_current;
+        table.reset( _k );
+        const size_t length = size_t( 2 ) << _bits;
+        const unsigned shift = 32 - _bits;
+        const equihash_hasher& hasher = get_equihash_hasher();
+
+        std::vector<equihash_batch> batch( 1 );
+        equihash_batch& entries = batch[0];
+        for( size_t first = 0; first < length; first += 2 * _window )
+        {
+            const size_t count = std::min( 2 * _window, length - first );
+            entries.rows.resize( count );
+            entries.blocks.resize( count * _k );
+            _pool.for_each_range( count, [&]( size_t begin, size_t end ) {
+                uint32_t indexes[64];
+                uint32_t digests[64 * 8];
+                for( size_t i = begin; i < end; i += 64 )
+                {
+                    const size_t n = std::min<size_t>( 64, end - i );
+                    for( size_t j = 0; j < n; ++j )
+                        indexes[j] = uint32_t( first + i + j );
+                    hasher.hash( _seed, _nonce, indexes, n, digests );
+                    for( size_t j = 0; j < n; ++j )
+                    {
+                        const uint32_t* d = digests + 8 * j;
+                        entries.rows[i + j] = d[0] >> shift;
+                        for( unsigned b = 0; b < _k; ++b )
+                            entries.blocks[( i + j ) * _k + b] = d[b + 1] >> shift;
+                    }
+                }
+            }, 256 );
+
+            insert( batch, table );
+
+            // the reference of a filled entry is its index
+            _pool.for_each_range( count, [&]( size_t begin, size_t end ) {
+                for( size_t i = begin; i < end; ++i )
+                    if( entries.slots[i] < LIST_LENGTH )
+                        table.entry( entries.rows[i], entries.slots[i] )[0] = uint32_t( first + i );
+            }, 4096 );
+        }
+    }
+
+    /** one level of collisions on the first block, from _current to _next */
+    void collide()
+    {
+        const equihash_table& source = *_current;
+        equihash_table& table = *_next;
+        table.reset( source.blocks() - 1 );
+        const size_t max_forks = source.rows() * FORK_MULTIPLIER;
+
+        std::vector<equihash_fork> forks;
+        std::vector<size_t> offsets( _parts.size() + 1 );
+        for( size_t first = 0; first < source.rows() && forks.size() < max_forks; first += _window )
+        {
+            collect( first, std::min( first + _window, source.rows() ), false );
+            insert( _parts, table );
+
+            // number the entries that found a slot, the serial solver stops adding at max_forks
+            _pool.for_each_range( _parts.size(), [&]( size_t begin, size_t end ) {
+                for( size_t p = begin; p < end; ++p )
+                    offsets[p + 1] = std::count_if( _parts[p].slots.begin(), _parts[p].slots.end(),
+                                                    []( uint8_t slot ) { return slot < LIST_LENGTH; } );
+            } );
+            for( size_t p = 0; p < _parts.size(); ++p )
+                offsets[p + 1] += offsets[p];
+            const size_t base = forks.size();
+            const size_t added = offsets.back();
+            forks.resize( std::min( base + added, max_forks ) );
+
+            _pool.for_each_range( _parts.size(), [&]( size_t begin, size_t end ) {
+                for( size_t p = begin; p < end; ++p )
+                {
+                    const equihash_batch& part = _parts[p];
+                    size_t index = base + offsets[p];
+                    for( size_t i = 0; i < part.slots.size() && index < max_forks; ++i )
+                    {
+                        if( part.slots[i] == LIST_LENGTH )
+                            continue;
+                        forks[index] = part.forks[i];
+                        table.entry( part.rows[i], part.slots[i] )[0] = uint32_t( index );
+                        ++index;
+                    }
+                }
+            } );
+
+            // entries numbered past the limit are the last ones of their rows, drop them
+            if( base + added > max_forks )
+            {
+                size_t index = base;
+                for( const equihash_batch& part : _parts )
+                    for( size_t i = 0; i < part.slots.size(); ++i )
+                        if( part.slots[i] < LIST_LENGTH && index++ >= max_forks )
+                            --table.filled( part.rows[i] );
+            }
+        }
+
+        _forks.push_back( std::move( forks ) );
+        std::swap( _current, _next );
+    }
+
+    /** the last level: pairs whose last blocks are equal are solutions, the first without repeated indexes wins */
+    std::vector<uint32_t> find_solution()
+    {
+        std::vector<uint32_t> inputs, sorted;
+        for( size_t first = 0; first < _current->rows(); first += _window )
+        {
+            collect( first, std::min( first + _window, _current->rows() ), true );
+            for( const equihash_batch& part : _parts )
+            {
+                for( const equihash_fork& fork : part.forks )
+                {
+                    inputs.clear();
+                    resolve( fork, _forks.size(), inputs );
+                    sorted = inputs;
+                    std::sort( sorted.begin(), sorted.end() );
+                    if( std::adjacent_find( sorted.begin(), sorted.end() ) == sorted.end() )
+                        return inputs;
+                }
+            }
+        }
+        return std::vector<uint32_t>();
+    }
+
+    /**
+     *  Collides the entries of each row in [first, end) of _current pairwise, splitting
+     *  the rows over _parts.  On the last level only the forks of solutions are kept.
+     */
+    void collect( size_t first, size_t end, bool last )
+    {
+        const equihash_table& source = *_current;
+        const size_t rows = end - first;
+        _pool.for_each_range( _parts.size(), [&]( size_t begin_part, size_t end_part ) {
+            for( size_t p = begin_part; p < end_part; ++p )
+            {
+                equihash_batch& part = _parts[p];
+                part.clear();
+                const unsigned stride = source.blocks() + 1;
+                const unsigned blocks = source.blocks() - 1;
+                const size_t part_end = first + rows * ( p + 1 ) / _parts.size();
+                for( size_t row = first + rows * p / _parts.size(); row < part_end; ++row )
+                {
+                    const unsigned count = source.filled( row );
+                    const uint32_t* entries = source.entry( row, 0 );
+                    for( unsigned j = 0; j < count; ++j )
+                    {
+                        const uint32_t* a = entries + j * stride;
+                        for( unsigned m = j + 1; m < count; ++m )
+                        {
+                            const uint32_t* b = entries + m * stride;
+                            const uint32_t index = a[1] ^ b[1];
+                            if( last )
+                            {
+                                if( index == 0 )
+                                    part.forks.push_back( { a[0], b[0] } );
+                                continue;
+                            }
+                            part.rows.push_back( index );
+                            part.forks.push_back( { a[0], b[0] } );
+                            for( unsigned l = 0; l < blocks; ++l )
+                                part.blocks.push_back( a[l + 2] ^ b[l + 2] );
+                        }
+                    }
+                }
+            }
+        } );
+    }
+
+    /**
+     *  Gives every entry of the batches, in order, the next free slot of its row in table
+     *  and copies its blocks there.  Threads own ranges of rows, so the rows fill up in
+     *  the same order as they would serially.
+     */
+    void insert( std::vector<equihash_batch>& batches, equihash_table& table )
+    {
+        for( equihash_batch& batch : batches )
+            batch.slots.resize( batch.rows.size() );
+        const unsigned blocks = table.blocks();
+        _pool.for_each_range( table.rows(), [&]( size_t begin, size_t end ) {
+            for( equihash_batch& batch : batches )
+            {
+                const uint32_t* rows = batch.rows.data();
+                for( size_t i = 0, count = batch.rows.size(); i < count; ++i )
+                {
+                    const size_t row = rows[i];
+                    if( row < begin || row >= end )
+                        continue;
+                    uint8_t& filled = table.filled( row );
+                    if( filled == LIST_LENGTH )
+                    {
+                        batch.slots[i] = LIST_LENGTH;
+                        continue;
+                    }
+                    batch.slots[i] = filled;
+                    std::copy_n( batch.blocks.data() + i * blocks, blocks, table.entry( row, filled ) + 1 );
+                    ++filled;
+                }
+            }
+        }, 4096 );
+    }
+
+    void resolve( const equihash_fork& fork, size_t level, std::vector<uint32_t>& inputs ) const
+    {
+        if( level == 0 )
+        {
+            inputs.push_back( fork.ref1 );
+            inputs.push_back( fork.ref2 );
+            return;
+        }
+        resolve( _forks[level - 1][fork.ref1], level - 1, inputs );
+        resolve( _forks[level - 1][fork.ref2], level - 1, inputs );
+    }
+
+    const unsigned _k;
+    const unsigned _bits;
+    uint32_t _seed[SEED_LENGTH];
+    const uint32_t _nonce;
+    worker_pool& _pool;
+    std::unique_ptr<equihash_table> _current;
+    std::unique_ptr<equihash_table> _next;
+    /** the forks found by each level but the last, indexed by the references of the next level */
+    std::vector<std::vector<equihash_fork>> _forks;
+    std::vector<equihash_batch> _parts;
+    /** rows collided per window, twice as many indexes are hashed per window */
+    const size_t _window;
+};
+
+} // anonymous
+
+std::vector<uint32_t> equihash_solve( unsigned n, unsigned k, const uint32_t* seed, uint32_t nonce, worker_pool& pool )
+{
+    FC_ASSERT( k > 0 && k < 8, "Equihash k must be between 1 and 7, not ${k}", ("k", k) );
+    FC_ASSERT( n / ( k + 1 ) > 0 && n / ( k + 1 ) <= 30, "Equihash n / (k + 1) must be between 1 and 30",
+               ("n", n)("k", k) );
+    return equihash_solver( n, k, seed, nonce, pool ).solve();
+}
+
+} } // fc::detail
@@ -1,6 +1,8 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/exception/exception.hpp>
 
+#include "_text_codecs.hpp"
+
 namespace fc {
 
     uint8_t from_hex( char c ) {
@@ -14,31 +16,43 @@ namespace fc {
       return 0;
     }
 
+    void to_hex( const char* d, size_t s, char* out_data )
+    {
+        static const char* digits = "0123456789abcdef";
+        const uint8_t* c = (const uint8_t*)d;
+        for( size_t i = detail::get_text_codecs().hex_encode( c, s, out_data ); i < s; ++i )
+        {
+            out_data[2 * i] = digits[c[i] >> 4];
+            out_data[2 * i + 1] = digits[c[i] & 0x0f];
+        }
+    }
+
     std::string to_hex( const char* d, uint32_t s )
     {
-        std::string r;
-        const char* to_hex="0123456789abcdef";
-        uint8_t* c = (uint8_t*)d;
-        for( uint32_t i = 0; i < s; ++i )
-            (r += to_hex[(c[i]>>4)]) += to_hex[(c[i] &0x0f)];
+        std::string r( size_t( s ) * 2, '\0' );
+        if( s )
+            to_hex( d, s, &r[0] );
         return r;
     }
 
-    size_t from_hex( const std::string& hex_str, char* out_data, size_t out_data_len ) {
-        std::string::const_iterator i = hex_str.begin();
-        uint8_t* out_pos = (uint8_t*)out_data;
-        uint8_t* out_end = out_pos + out_data_len;
-        while( i != hex_str.end() && out_end != out_pos ) {
-          *out_pos = from_hex( *i ) << 4;   
-          ++i;
-          if( i != hex_str.end() )  {
-              *out_pos |= from_hex( *i );
-              ++i;
-          }
-          ++out_pos;
+    size_t from_hex( const char* hex, size_t hex_len, char* out_data, size_t out_data_len ) {
+        uint8_t* out = (uint8_t*)out_data;
+        size_t i = detail::get_text_codecs().hex_decode( hex, hex_len, out, out_data_len );
+        size_t pos = i / 2;
+        // the block loop stops before a block with an invalid digit, which is reported here
+        for( ; i < hex_len && pos < out_data_len; i += 2, ++pos ) {
+          uint8_t byte = from_hex( hex[i] ) << 4;
+          if( i + 1 < hex_len )
+              byte |= from_hex( hex[i + 1] );
+          out[pos] = byte;
         }
-        return out_pos - (uint8_t*)out_data;
+        return pos;
     }
+
+    size_t from_hex( const std::string& hex_str, char* out_data, size_t out_data_len ) {
+        return from_hex( hex_str.data(), hex_str.size(), out_data, out_data_len );
+    }
+
     std::string to_hex( const std::vector<char>& data )
     {
        if( data.size() )
@@ -0,0 +1,27 @@
+#include <fc/crypto/merkle_tree.hpp>
+
+namespace fc { namespace detail {
+
+void merkle_pair_hasher<fc::sha256>::hash_pairs( const fc::sha256* const* pairs, size_t count, fc::sha256* const* out )
+{
+    // the two children of a node are adjacent in their level, so each pair is one 64 byte message
+    const size_t batch = 64;
+    const char* data[batch];
+    uint32_t sizes[batch];
+    fc::sha256 digests[batch];
+
+    for( size_t i = 0; i < count; i += batch )
+    {
+        const size_t n = std::min( batch, count - i );
+        for( size_t j = 0; j < n; ++j )
+        {
+            data[j] = pairs[i + j][0].data();
+            sizes[j] = 2 * sizeof( fc::sha256 );
+        }
+        fc::sha256::hash_many( data, sizes, n, digests );
+        for( size_t j = 0; j < n; ++j )
+            *out[i + j] = digests[j];
+    }
+}
+
+} } // fc::detail
@@ -1,18 +1,174 @@
 #include <openssl/rand.h>
+#include <openssl/crypto.h>
+#include <fc/crypto/rand.hpp>
 #include <fc/crypto/openssl.hpp>
 #include <fc/exception/exception.hpp>
 #include <fc/fwd_impl.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#ifndef _WIN32
+# include <pthread.h>
+#endif
 
 namespace fc {
 
+namespace {
+    const size_t   chacha_block_size    = 64;
+    const size_t   rand_key_size        = 32;
+    const size_t   rand_buffer_size     = 16 * chacha_block_size;
+    /// output after which a thread mixes fresh OpenSSL randomness into its key
+    const uint64_t rand_reseed_interval = 1 << 20;
+
+    inline uint32_t rotl( uint32_t v, int n )
+    {
+        return ( v << n ) | ( v >> ( 32 - n ) );
+    }
+
+    inline void quarter_round( uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d )
+    {
+        a += b; d = rotl( d ^ a, 16 );
+        c += d; b = rotl( b ^ c, 12 );
+        a += b; d = rotl( d ^ a, 8 );
+        c += d; b = rotl( b ^ c, 7 );
+    }
+
+    /// ChaCha20 (RFC 7539) key stream blocks [0, blocks) of key with an all zero nonce
+    void chacha20_blocks( const uint32_t key[8], size_t blocks, unsigned char* out )
+    {
+        for( uint32_t counter = 0; counter < blocks; ++counter, out += chacha_block_size )
+        {
+            const uint32_t input[16] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+                                         key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+                                         counter, 0, 0, 0 };
+            uint32_t x[16];
+            memcpy( x, input, sizeof(x) );
+            for( int round = 0; round < 10; ++round )
+            {
+                quarter_round( x[0], x[4], x[8],  x[12] );
+                quarter_round( x[1], x[5], x[9],  x[13] );
+                quarter_round( x[2], x[6], x[10], x[14] );
+                quarter_round( x[3], x[7], x[11], x[15] );
+                quarter_round( x[0], x[5], x[10], x[15] );
+                quarter_round( x[1], x[6], x[11], x[12] );
+                quarter_round( x[2], x[7], x[8],  x[13] );
+                quarter_round( x[3], x[4], x[9],  x[14] );
+            }
+            for( int i = 0; i < 16; ++i )
+            {
+                const uint32_t v = x[i] + input[i];
+                out[4 * i]     = (unsigned char)v;
+                out[4 * i + 1] = (unsigned char)( v >> 8 );
+                out[4 * i + 2] = (unsigned char)( v >> 16 );
+                out[4 * i + 3] = (unsigned char)( v >> 24 );
+            }
+        }
+    }
+
+    /// bumped in the child after fork(), so the copied generators of the parent are never used
+    std::atomic<uint32_t> fork_generation( 0 );
+
+    void on_fork_child()
+    {
+        fork_generation.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+#ifndef _WIN32
+    /** called once per process; a failed registration would leave forked children sharing output */
+    int register_fork_handler()
+    {
+        const int rc = pthread_atfork( nullptr, nullptr, &on_fork_child );
+        FC_ASSERT( rc == 0, "pthread_atfork() failed: ${rc}", ("rc", rc) );
+        return rc;
+    }
+#endif
+
+    /**
+     *  A ChaCha20 generator per thread with fast key erasure: each refill produces
+     *  rand_buffer_size bytes of key stream, the first rand_key_size of which replace the key,
+     *  and every byte handed out is wiped from the buffer, so the state never allows recovering
+     *  earlier output.  Seeded from OpenSSL on first use, after fork() and every
+     *  rand_reseed_interval bytes.
+     */
+    struct thread_rand
+    {
+        uint32_t      key[8];
+        unsigned char buffer[rand_buffer_size];
+        size_t        available;   ///< unused bytes at the end of buffer
+        uint64_t      since_seed;
+        uint32_t      generation;
+        bool          seeded;
+
+        thread_rand() : key(), available( 0 ), since_seed( 0 ), generation( 0 ), seeded( false ) {}
+
+        ~thread_rand()
+        {
+            OPENSSL_cleanse( key, sizeof(key) );
+            OPENSSL_cleanse( buffer, sizeof(buffer) );
+        }
+
+        void seed()
+        {
+            static int init = init_openssl();
+            (void)init;
+#ifndef _WIN32
+            // retried by the next seed() if it throws
+            static int at_fork = register_fork_handler();
+            (void)at_fork;
+#endif
+            const uint32_t current = fork_generation.load( std::memory_order_relaxed );
+            uint32_t fresh[8];
+            if( RAND_bytes( (unsigned char*)fresh, sizeof(fresh) ) != 1 )
+                FC_THROW( "Error calling OpenSSL's RAND_bytes(): ${code}", ("code", (uint32_t)ERR_get_error()) );
+            for( int i = 0; i < 8; ++i )
+                key[i] ^= fresh[i];
+            OPENSSL_cleanse( fresh, sizeof(fresh) );
+            OPENSSL_cleanse( buffer, sizeof(buffer) );
+            available = 0;
+            since_seed = 0;
+            generation = current;
+            seeded = true;
+        }
+
+        void refill()
+        {
+            if( since_seed >= rand_reseed_interval )
+                seed();
+            chacha20_blocks( key, rand_buffer_size / chacha_block_size, buffer );
+            memcpy( key, buffer, rand_key_size );
+            OPENSSL_cleanse( buffer, rand_key_size );
+            available = rand_buffer_size - rand_key_size;
+            since_seed += available;
+        }
+
+        void read( unsigned char* out, size_t len )
+        {
+            if( !seeded || generation != fork_generation.load( std::memory_order_relaxed ) )
+                seed();
+            while( len )
+            {
+                if( !available )
+                    refill();
+                const size_t n = std::min( len, available );
+                unsigned char* from = buffer + rand_buffer_size - available;
+                memcpy( out, from, n );
+                OPENSSL_cleanse( from, n );
+                out += n;
+                len -= n;
+                available -= n;
+            }
+        }
+    };
+}
+
 void rand_bytes(char* buf, int count)
 {
-  static int init = init_openssl();
-
-  int result = RAND_bytes((unsigned char*)buf, count);
-  if (result != 1)
-    FC_THROW("Error calling OpenSSL's RAND_bytes(): ${code}", ("code", (uint32_t)ERR_get_error()));
+  if (count <= 0)
+    return;
+  static thread_local thread_rand generator;
+  generator.read((unsigned char*)buf, size_t(count));
 }
 
 }  // namespace fc
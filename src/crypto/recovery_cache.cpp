@@ -0,0 +1,225 @@
+#include <fc/crypto/recovery_cache.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "_recovery_cache.hpp"
+
+namespace fc { namespace ecc {
+
+    namespace detail {
+        namespace {
+            const unsigned cache_shards = 16;
+
+            struct cache_key
+            {
+                compact_signature sig;
+                fc::sha256        digest;
+
+                bool operator==( const cache_key& o )const
+                {
+                    return digest == o.digest && memcmp( sig.begin(), o.sig.begin(), sig.size() ) == 0;
+                }
+            };
+
+            struct cache_key_hash
+            {
+                size_t operator()( const cache_key& k )const
+                {
+                    // the digest is already uniformly distributed
+                    uint64_t h;
+                    memcpy( &h, k.digest.data(), sizeof(h) );
+                    uint64_t r;
+                    memcpy( &r, k.sig.begin() + 1, sizeof(r) );
+                    return size_t( h ^ r );
+                }
+            };
+
+            struct cache_entry
+            {
+                cache_key       key;
+                public_key_data value;
+                bool            referenced;
+            };
+
+            struct cache_shard
+            {
+                boost::mutex                                           mutex;
+                std::vector<cache_entry>                               slots;
+                std::unordered_map<cache_key, uint32_t, cache_key_hash> index;
+                size_t                                                 capacity = 0;
+                size_t                                                 hand = 0;
+                uint64_t                                               hits = 0;
+                uint64_t                                               misses = 0;
+                uint64_t                                               evictions = 0;
+
+                void reset( size_t new_capacity )
+                {
+                    std::vector<cache_entry>().swap( slots );
+                    std::unordered_map<cache_key, uint32_t, cache_key_hash>().swap( index );
+                    capacity = new_capacity;
+                    hand = 0;
+                    hits = misses = evictions = 0;
+                    if( capacity )
+                        index.reserve( capacity );
+                }
+
+                /** CLOCK: the hand clears reference bits until it finds an entry not used since its last pass */
+                uint32_t pick_victim()
+                {
+                    while( slots[hand].referenced )
+                    {
+                        slots[hand].referenced = false;
+                        hand = ( hand + 1 ) % slots.size();
+                    }
+                    uint32_t victim = hand;
+                    hand = ( hand + 1 ) % slots.size();
+                    return victim;
+                }
+            };
+
+            struct recovery_cache_state
+            {
+                boost::atomic<bool> enabled;
+                cache_shard         shards[cache_shards];
+
+                recovery_cache_state() : enabled( false ) {}
+
+                cache_shard& shard_for( const cache_key& k )
+                {
+                    return shards[ (unsigned char)k.digest.data()[31] % cache_shards ];
+                }
+            };
+
+            recovery_cache_state& get_state()
+            {
+                static recovery_cache_state state;
+                return state;
+            }
+
+            cache_key make_key( const compact_signature& c, const fc::sha256& digest )
+            {
+                cache_key k;
+                k.sig = c;
+                k.digest = digest;
+                return k;
+            }
+        }
+
+        bool find_recovered_key( const compact_signature& c, const fc::sha256& digest, public_key_data& key )
+        {
+            recovery_cache_state& state = get_state();
+            if( !state.enabled.load( boost::memory_order_relaxed ) )
+                return false;
+
+            cache_key k = make_key( c, digest );
+            cache_shard& shard = state.shard_for( k );
+            boost::unique_lock<boost::mutex> lock( shard.mutex );
+            auto itr = shard.index.find( k );
+            if( itr == shard.index.end() )
+            {
+                ++shard.misses;
+                return false;
+            }
+            ++shard.hits;
+            cache_entry& e = shard.slots[itr->second];
+            e.referenced = true;
+            key = e.value;
+            return true;
+        }
+
+        void remember_recovered_key( const compact_signature& c, const fc::sha256& digest, const public_key_data& key )
+        {
+            recovery_cache_state& state = get_state();
+            if( !state.enabled.load( boost::memory_order_relaxed ) )
+                return;
+
+            cache_key k = make_key( c, digest );
+            cache_shard& shard = state.shard_for( k );
+            boost::unique_lock<boost::mutex> lock( shard.mutex );
+            if( !shard.capacity || shard.index.count( k ) )
+                return;
+
+            uint32_t slot;
+            if( shard.slots.size() < shard.capacity )
+            {
+                slot = shard.slots.size();
+                shard.slots.push_back( cache_entry() );
+            }
+            else
+            {
+                slot = shard.pick_victim();
+                shard.index.erase( shard.slots[slot].key );
+                ++shard.evictions;
+            }
+            cache_entry& e = shard.slots[slot];
+            e.key = k;
+            e.value = key;
+            e.referenced = false;
+            shard.index.emplace( k, slot );
+        }
+    }
+
+    void recovery_cache::enable( size_t capacity )
+    {
+        if( !capacity )
+        {
+            disable();
+            return;
+        }
+        detail::recovery_cache_state& state = detail::get_state();
+        size_t per_shard = ( capacity + detail::cache_shards - 1 ) / detail::cache_shards;
+        for( auto& shard : state.shards )
+        {
+            boost::unique_lock<boost::mutex> lock( shard.mutex );
+            shard.reset( per_shard );
+        }
+        state.enabled.store( true, boost::memory_order_relaxed );
+    }
+
+    void recovery_cache::disable()
+    {
+        detail::recovery_cache_state& state = detail::get_state();
+        state.enabled.store( false, boost::memory_order_relaxed );
+        for( auto& shard : state.shards )
+        {
+            boost::unique_lock<boost::mutex> lock( shard.mutex );
+            shard.reset( 0 );
+        }
+    }
+
+    bool recovery_cache::enabled()
+    {
+        return detail::get_state().enabled.load( boost::memory_order_relaxed );
+    }
+
+    recovery_cache::stats recovery_cache::get_stats()
+    {
+        stats result;
+        for( auto& shard : detail::get_state().shards )
+        {
+            boost::unique_lock<boost::mutex> lock( shard.mutex );
+            result.hits      += shard.hits;
+            result.misses    += shard.misses;
+            result.evictions += shard.evictions;
+            result.size      += shard.slots.size();
+            result.capacity  += shard.capacity;
+        }
+        return result;
+    }
+
+    void recovery_cache::clear()
+    {
+        for( auto& shard : detail::get_state().shards )
+        {
+            boost::unique_lock<boost::mutex> lock( shard.mutex );
+            shard.reset( shard.capacity );
+        }
+    }
+
+} }
@@ -1,7 +1,5 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/fwd_impl.hpp>
-#include <openssl/sha.h>
-#include <openssl/ripemd.h>
 #include <cstring>
 #include <fc/crypto/ripemd160.hpp>
 #include <fc/crypto/sha512.hpp>
@@ -9,6 +7,7 @@
 #include <fc/variant.hpp>
 #include <vector>
 #include "_digest_common.hpp"
+#include "_digest_engine.hpp"
 
 namespace fc {
 
@@ -34,11 +33,7 @@ namespace fc {
 
 
     struct ripemd160::encoder::impl {
-        impl() {
-            memset((char *) &ctx, 0, sizeof(ctx));
-        }
-
-        RIPEMD160_CTX ctx;
+        detail::ripemd160_context ctx;
     };
 
     ripemd160::encoder::~encoder() {
@@ -66,18 +61,23 @@ namespace fc {
         return hash(s.c_str(), s.size());
     }
 
-    void ripemd160::encoder::write(const char *d, uint32_t dlen) {
-        RIPEMD160_Update(&my->ctx, d, dlen);
+    const char *ripemd160::implementation() {
+        return detail::get_digest_engine().ripemd160.name;
+    }
+
+    void ripemd160::encoder::write_blocks(const char *d, uint32_t dlen) {
+        my->ctx.write(detail::get_digest_engine().ripemd160.compress, _block, _used, d, dlen);
     }
 
     ripemd160 ripemd160::encoder::result() {
         ripemd160 h;
-        RIPEMD160_Final((uint8_t *) h.data(), &my->ctx);
+        my->ctx.finish(detail::get_digest_engine().ripemd160.compress, _block, _used, h.data(), 5);
         return h;
     }
 
     void ripemd160::encoder::reset() {
-        RIPEMD160_Init(&my->ctx);
+        my->ctx.init(detail::ripemd160_h0);
+        _used = 0;
     }
 
     ripemd160 operator<<(const ripemd160 &h1, uint32_t i) {
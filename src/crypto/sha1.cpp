@@ -1,11 +1,11 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/fwd_impl.hpp>
-#include <openssl/sha.h>
 #include <cstring>
 #include <fc/crypto/sha1.hpp>
 #include <fc/variant.hpp>
 #include <vector>
 #include "_digest_common.hpp"
+#include "_digest_engine.hpp"
 
 namespace fc {
 
@@ -31,7 +31,7 @@ namespace fc {
 
 
     struct sha1::encoder::impl {
-        SHA_CTX ctx;
+        detail::sha1_context ctx;
     };
 
     sha1::encoder::~encoder() {
@@ -51,18 +51,23 @@ namespace fc {
         return hash(s.c_str(), s.size());
     }
 
-    void sha1::encoder::write(const char *d, uint32_t dlen) {
-        SHA1_Update(&my->ctx, d, dlen);
+    const char *sha1::implementation() {
+        return detail::get_digest_engine().sha1.name;
+    }
+
+    void sha1::encoder::write_blocks(const char *d, uint32_t dlen) {
+        my->ctx.write(detail::get_digest_engine().sha1.compress, _block, _used, d, dlen);
     }
 
     sha1 sha1::encoder::result() {
         sha1 h;
-        SHA1_Final((uint8_t *) h.data(), &my->ctx);
+        my->ctx.finish(detail::get_digest_engine().sha1.compress, _block, _used, h.data(), 5);
         return h;
     }
 
     void sha1::encoder::reset() {
-        SHA1_Init(&my->ctx);
+        my->ctx.init(detail::sha1_h0);
+        _used = 0;
     }
 
     sha1 operator<<(const sha1 &h1, uint32_t i) {
@@ -1,11 +1,11 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/hmac.hpp>
 #include <fc/fwd_impl.hpp>
-#include <openssl/sha.h>
 #include <cstring>
 #include <fc/crypto/sha224.hpp>
 #include <fc/variant.hpp>
 #include "_digest_common.hpp"
+#include "_digest_engine.hpp"
 
 namespace fc {
 
@@ -31,12 +31,23 @@ namespace fc {
 
 
     struct sha224::encoder::impl {
-        SHA256_CTX ctx;
+        detail::sha256_context ctx;
     };
 
     sha224::encoder::~encoder() {
     }
 
+    sha224::encoder::encoder(const encoder &other) : my(other.my), _used(other._used) {
+        memcpy(_block, other._block, _used);
+    }
+
+    sha224::encoder &sha224::encoder::operator=(const encoder &other) {
+        my = other.my;
+        _used = other._used;
+        memcpy(_block, other._block, _used);
+        return *this;
+    }
+
     sha224::encoder::encoder() {
         reset();
     }
@@ -51,18 +62,23 @@ namespace fc {
         return hash(s.c_str(), s.size());
     }
 
-    void sha224::encoder::write(const char *d, uint32_t dlen) {
-        SHA224_Update(&my->ctx, d, dlen);
+    const char *sha224::implementation() {
+        return detail::get_digest_engine().sha256.name;
+    }
+
+    void sha224::encoder::write_blocks(const char *d, uint32_t dlen) {
+        my->ctx.write(detail::get_digest_engine().sha256.compress, _block, _used, d, dlen);
     }
 
     sha224 sha224::encoder::result() {
         sha224 h;
-        SHA224_Final((uint8_t *) h.data(), &my->ctx);
+        my->ctx.finish(detail::get_digest_engine().sha256.compress, _block, _used, h.data(), 7);
         return h;
     }
 
     void sha224::encoder::reset() {
-        SHA224_Init(&my->ctx);
+        my->ctx.init(detail::sha224_h0);
+        _used = 0;
     }
 
     sha224 operator<<(const sha224 &h1, uint32_t i) {
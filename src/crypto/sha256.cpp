@@ -1,13 +1,14 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/hmac.hpp>
 #include <fc/fwd_impl.hpp>
-#include <openssl/sha.h>
 #include <cstring>
 #include <cmath>
 #include <fc/crypto/sha256.hpp>
 #include <fc/variant.hpp>
 #include <fc/exception/exception.hpp>
 #include "_digest_common.hpp"
+#include "_digest_engine.hpp"
+#include "_sha256_lanes.hpp"
 
 namespace fc {
 
@@ -39,12 +40,23 @@ namespace fc {
 
 
     struct sha256::encoder::impl {
-        SHA256_CTX ctx;
+        detail::sha256_context ctx;
     };
 
     sha256::encoder::~encoder() {
     }
 
+    sha256::encoder::encoder(const encoder &other) : my(other.my), _used(other._used) {
+        memcpy(_block, other._block, _used);
+    }
+
+    sha256::encoder &sha256::encoder::operator=(const encoder &other) {
+        my = other.my;
+        _used = other._used;
+        memcpy(_block, other._block, _used);
+        return *this;
+    }
+
     sha256::encoder::encoder() {
         reset();
     }
@@ -59,22 +71,48 @@ namespace fc {
         return hash(s.c_str(), s.size());
     }
 
+    const char *sha256::implementation() {
+        return detail::get_digest_engine().sha256.name;
+    }
+
     sha256 sha256::hash(const sha256 &s) {
         return hash(s.data(), sizeof(s._hash));
     }
 
-    void sha256::encoder::write(const char *d, uint32_t dlen) {
-        SHA256_Update(&my->ctx, d, dlen);
+    void sha256::hash_many(const char *const *data, const uint32_t *sizes, size_t count, sha256 *out) {
+        static_assert(sizeof(sha256) == 32, "hash_many writes the digests back to back");
+        detail::select_sha256_many().fn(data, sizes, count, (uint8_t *) out);
+    }
+
+    std::vector<sha256> sha256::hash_many(const std::vector<std::vector<char>> &messages) {
+        std::vector<const char *> data(messages.size());
+        std::vector<uint32_t> sizes(messages.size());
+        for (size_t i = 0; i < messages.size(); ++i) {
+            data[i] = messages[i].data();
+            sizes[i] = messages[i].size();
+        }
+        std::vector<sha256> result(messages.size());
+        hash_many(data.data(), sizes.data(), messages.size(), result.data());
+        return result;
+    }
+
+    const char *sha256::hash_many_implementation() {
+        return detail::select_sha256_many().name;
+    }
+
+    void sha256::encoder::write_blocks(const char *d, uint32_t dlen) {
+        my->ctx.write(detail::get_digest_engine().sha256.compress, _block, _used, d, dlen);
     }
 
     sha256 sha256::encoder::result() {
         sha256 h;
-        SHA256_Final((uint8_t *) h.data(), &my->ctx);
+        my->ctx.finish(detail::get_digest_engine().sha256.compress, _block, _used, h.data(), 8);
         return h;
     }
 
     void sha256::encoder::reset() {
-        SHA256_Init(&my->ctx);
+        my->ctx.init(detail::sha256_h0);
+        _used = 0;
     }
 
     sha256 operator<<(const sha256 &h1, uint32_t i) {
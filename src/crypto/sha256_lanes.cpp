@@ -0,0 +1,42 @@
+#include <fc/crypto/sha256.hpp>
+
+#include "_sha256_lanes.hpp"
+#include "_cpu_features.hpp"
+
+namespace fc { namespace detail {
+
+void sha256_many_portable( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out )
+{
+    for( size_t i = 0; i < count; ++i )
+    {
+        const sha256 digest = sha256::hash( data[i], sizes[i] );
+        memcpy( out + 32 * i, digest.data(), 32 );
+    }
+}
+
+namespace {
+    sha256_many_impl choose_sha256_many()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        const cpu_features& cpu = get_cpu_features();
+        // one message at a time on the SHA extensions keeps up with even 16 AVX-512 lanes
+        if( cpu.sha_ni )
+            return { &sha256_many_portable, "sequential" };
+        if( cpu.avx512f )
+            return { &sha256_many_avx512, "avx512 x16" };
+        if( cpu.avx2 )
+            return { &sha256_many_avx2, "avx2 x8" };
+        if( cpu.sse2 )
+            return { &sha256_many_sse2, "sse2 x4" };
+#endif
+        return { &sha256_many_portable, "sequential" };
+    }
+}
+
+const sha256_many_impl& select_sha256_many()
+{
+    static const sha256_many_impl impl = choose_sha256_many();
+    return impl;
+}
+
+} } // fc::detail
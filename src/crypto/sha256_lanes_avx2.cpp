@@ -0,0 +1,37 @@
+#include "_sha256_lanes.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+/* compiled with AVX2 enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    struct avx2_ops : basic_ternary_ops<avx2_ops>
+    {
+        typedef __m256i vec;
+        static const int lanes = 8;
+
+        static vec load( const uint32_t* p ) { return _mm256_load_si256( (const __m256i*)p ); }
+        static void store( uint32_t* p, vec v ) { _mm256_store_si256( (__m256i*)p, v ); }
+        static vec set1( uint32_t x ) { return _mm256_set1_epi32( int(x) ); }
+        static vec add( vec a, vec b ) { return _mm256_add_epi32( a, b ); }
+        static vec band( vec a, vec b ) { return _mm256_and_si256( a, b ); }
+        static vec bor( vec a, vec b ) { return _mm256_or_si256( a, b ); }
+        static vec bxor( vec a, vec b ) { return _mm256_xor_si256( a, b ); }
+        static vec bandnot( vec a, vec b ) { return _mm256_andnot_si256( a, b ); }
+        template<int N> static vec shr( vec a ) { return _mm256_srli_epi32( a, N ); }
+        template<int N> static vec rotr( vec a ) { return _mm256_or_si256( _mm256_srli_epi32( a, N ), _mm256_slli_epi32( a, 32 - N ) ); }
+    };
+}
+
+void sha256_many_avx2( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out )
+{
+    lane_engine<avx2_ops>::run( data, sizes, count, out );
+}
+
+} } // fc::detail
+
+#endif
@@ -0,0 +1,42 @@
+#include "_sha256_lanes.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+/* compiled with AVX-512F enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    struct avx512_ops
+    {
+        typedef __m512i vec;
+        static const int lanes = 16;
+
+        static vec load( const uint32_t* p ) { return _mm512_load_si512( (const void*)p ); }
+        static void store( uint32_t* p, vec v ) { _mm512_store_si512( (void*)p, v ); }
+        static vec set1( uint32_t x ) { return _mm512_set1_epi32( int(x) ); }
+        static vec add( vec a, vec b ) { return _mm512_add_epi32( a, b ); }
+        static vec band( vec a, vec b ) { return _mm512_and_si512( a, b ); }
+        static vec bor( vec a, vec b ) { return _mm512_or_si512( a, b ); }
+        static vec bxor( vec a, vec b ) { return _mm512_xor_si512( a, b ); }
+        static vec bandnot( vec a, vec b ) { return _mm512_andnot_si512( a, b ); }
+        template<int N> static vec shr( vec a ) { return _mm512_srli_epi32( a, N ); }
+        template<int N> static vec rotr( vec a ) { return _mm512_ror_epi32( a, N ); }
+
+        // vpternlogd evaluates any three-input boolean function, the immediate is its truth table
+        static vec xor3( vec a, vec b, vec c ) { return _mm512_ternarylogic_epi32( a, b, c, 0x96 ); }
+        static vec ch( vec e, vec f, vec g ) { return _mm512_ternarylogic_epi32( e, f, g, 0xca ); }
+        static vec maj( vec a, vec b, vec c ) { return _mm512_ternarylogic_epi32( a, b, c, 0xe8 ); }
+    };
+}
+
+void sha256_many_avx512( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out )
+{
+    lane_engine<avx512_ops>::run( data, sizes, count, out );
+}
+
+} } // fc::detail
+
+#endif
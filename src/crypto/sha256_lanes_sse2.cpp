@@ -0,0 +1,35 @@
+#include "_sha256_lanes.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+namespace fc { namespace detail {
+
+namespace {
+    struct sse2_ops : basic_ternary_ops<sse2_ops>
+    {
+        typedef __m128i vec;
+        static const int lanes = 4;
+
+        static vec load( const uint32_t* p ) { return _mm_load_si128( (const __m128i*)p ); }
+        static void store( uint32_t* p, vec v ) { _mm_store_si128( (__m128i*)p, v ); }
+        static vec set1( uint32_t x ) { return _mm_set1_epi32( int(x) ); }
+        static vec add( vec a, vec b ) { return _mm_add_epi32( a, b ); }
+        static vec band( vec a, vec b ) { return _mm_and_si128( a, b ); }
+        static vec bor( vec a, vec b ) { return _mm_or_si128( a, b ); }
+        static vec bxor( vec a, vec b ) { return _mm_xor_si128( a, b ); }
+        static vec bandnot( vec a, vec b ) { return _mm_andnot_si128( a, b ); }
+        template<int N> static vec shr( vec a ) { return _mm_srli_epi32( a, N ); }
+        template<int N> static vec rotr( vec a ) { return _mm_or_si128( _mm_srli_epi32( a, N ), _mm_slli_epi32( a, 32 - N ) ); }
+    };
+}
+
+void sha256_many_sse2( const char* const* data, const uint32_t* sizes, size_t count, uint8_t* out )
+{
+    lane_engine<sse2_ops>::run( data, sizes, count, out );
+}
+
+} } // fc::detail
+
+#endif
@@ -1,11 +1,11 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/hmac.hpp>
 #include <fc/fwd_impl.hpp>
-#include <openssl/sha.h>
 #include <cstring>
 #include <fc/crypto/sha512.hpp>
 #include <fc/variant.hpp>
 #include "_digest_common.hpp"
+#include "_digest_engine.hpp"
 
 namespace fc {
 
@@ -31,12 +31,23 @@ namespace fc {
 
 
     struct sha512::encoder::impl {
-        SHA512_CTX ctx;
+        detail::sha512_context ctx;
     };
 
     sha512::encoder::~encoder() {
     }
 
+    sha512::encoder::encoder(const encoder &other) : my(other.my), _used(other._used) {
+        memcpy(_block, other._block, _used);
+    }
+
+    sha512::encoder &sha512::encoder::operator=(const encoder &other) {
+        my = other.my;
+        _used = other._used;
+        memcpy(_block, other._block, _used);
+        return *this;
+    }
+
     sha512::encoder::encoder() {
         reset();
     }
@@ -51,18 +62,23 @@ namespace fc {
         return hash(s.c_str(), s.size());
     }
 
-    void sha512::encoder::write(const char *d, uint32_t dlen) {
-        SHA512_Update(&my->ctx, d, dlen);
+    const char *sha512::implementation() {
+        return detail::get_digest_engine().sha512.name;
+    }
+
+    void sha512::encoder::write_blocks(const char *d, uint32_t dlen) {
+        my->ctx.write(detail::get_digest_engine().sha512.compress, _block, _used, d, dlen);
     }
 
     sha512 sha512::encoder::result() {
         sha512 h;
-        SHA512_Final((uint8_t *) h.data(), &my->ctx);
+        my->ctx.finish(detail::get_digest_engine().sha512.compress, _block, _used, h.data(), 8);
         return h;
     }
 
     void sha512::encoder::reset() {
-        SHA512_Init(&my->ctx);
+        my->ctx.init(detail::sha512_h0);
+        _used = 0;
     }
 
     sha512 operator<<(const sha512 &h1, uint32_t i) {
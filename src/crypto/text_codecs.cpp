@@ -0,0 +1,43 @@
+#include "_text_codecs.hpp"
+#include "_cpu_features.hpp"
+
+namespace fc { namespace detail {
+
+size_t hex_encode_none( const uint8_t*, size_t, char* )
+{
+    return 0;
+}
+
+size_t hex_decode_none( const char*, size_t, uint8_t*, size_t )
+{
+    return 0;
+}
+
+size_t base64_encode_none( const uint8_t*, size_t, char* )
+{
+    return 0;
+}
+
+size_t base64_decode_none( const char*, size_t, uint8_t* )
+{
+    return 0;
+}
+
+namespace {
+    text_codecs choose_text_codecs()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        if( get_cpu_features().ssse3 )
+            return { &hex_encode_ssse3, &hex_decode_ssse3, &base64_encode_ssse3, &base64_decode_ssse3, "ssse3" };
+#endif
+        return { &hex_encode_none, &hex_decode_none, &base64_encode_none, &base64_decode_none, "scalar" };
+    }
+}
+
+const text_codecs& get_text_codecs()
+{
+    static const text_codecs codecs = choose_text_codecs();
+    return codecs;
+}
+
+} } // fc::detail
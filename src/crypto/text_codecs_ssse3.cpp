@@ -0,0 +1,146 @@
+#include "_text_codecs.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <tmmintrin.h>
+
+#include <cstring>
+
+/* compiled with SSSE3 enabled, only called after a runtime CPU check */
+
+namespace fc { namespace detail {
+
+namespace {
+    inline bool all_set( __m128i mask )
+    {
+        return _mm_movemask_epi8( mask ) == 0xffff;
+    }
+
+    /** nibble values of 16 hex digits, valid is set where a byte is a hex digit */
+    inline __m128i hex_values( __m128i chars, __m128i& valid )
+    {
+        const __m128i digit = _mm_sub_epi8( chars, _mm_set1_epi8( '0' ) );
+        const __m128i is_digit = _mm_and_si128( _mm_cmpgt_epi8( chars, _mm_set1_epi8( '0' - 1 ) ),
+                                                _mm_cmplt_epi8( chars, _mm_set1_epi8( '9' + 1 ) ) );
+        const __m128i lower = _mm_or_si128( chars, _mm_set1_epi8( 0x20 ) );
+        const __m128i letter = _mm_sub_epi8( lower, _mm_set1_epi8( 'a' - 10 ) );
+        const __m128i is_letter = _mm_and_si128( _mm_cmpgt_epi8( lower, _mm_set1_epi8( 'a' - 1 ) ),
+                                                 _mm_cmplt_epi8( lower, _mm_set1_epi8( 'f' + 1 ) ) );
+        valid = _mm_or_si128( is_digit, is_letter );
+        return _mm_or_si128( _mm_and_si128( is_digit, digit ), _mm_and_si128( is_letter, letter ) );
+    }
+
+    /** spreads 12 bytes to the 6 bit values of 16 base64 characters, one per byte */
+    inline __m128i base64_split( __m128i in )
+    {
+        in = _mm_shuffle_epi8( in, _mm_set_epi8( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 ) );
+        const __m128i t0 = _mm_and_si128( in, _mm_set1_epi32( 0x0fc0fc00 ) );
+        const __m128i t1 = _mm_mulhi_epu16( t0, _mm_set1_epi32( 0x04000040 ) );
+        const __m128i t2 = _mm_and_si128( in, _mm_set1_epi32( 0x003f03f0 ) );
+        const __m128i t3 = _mm_mullo_epi16( t2, _mm_set1_epi32( 0x01000010 ) );
+        return _mm_or_si128( t1, t3 );
+    }
+
+    /** maps 6 bit values to the alphabet by adding the offset of their range */
+    inline __m128i base64_chars( __m128i values )
+    {
+        const __m128i offsets = _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                               '/' - 63, 'A', 0, 0 );
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m128i range = _mm_subs_epu8( values, _mm_set1_epi8( 51 ) );
+        range = _mm_or_si128( range, _mm_and_si128( _mm_cmpgt_epi8( _mm_set1_epi8( 26 ), values ),
+                                                    _mm_set1_epi8( 13 ) ) );
+        return _mm_add_epi8( values, _mm_shuffle_epi8( offsets, range ) );
+    }
+}
+
+size_t hex_encode_ssse3( const uint8_t* in, size_t len, char* out )
+{
+    const __m128i digits = _mm_setr_epi8( '0', '1', '2', '3', '4', '5', '6', '7',
+                                          '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' );
+    const __m128i low_nibbles = _mm_set1_epi8( 0x0f );
+    size_t done = 0;
+    for( ; len - done >= 16; done += 16, out += 32 )
+    {
+        const __m128i bytes = _mm_loadu_si128( (const __m128i*)( in + done ) );
+        const __m128i high = _mm_shuffle_epi8( digits, _mm_and_si128( _mm_srli_epi16( bytes, 4 ), low_nibbles ) );
+        const __m128i low = _mm_shuffle_epi8( digits, _mm_and_si128( bytes, low_nibbles ) );
+        _mm_storeu_si128( (__m128i*)out, _mm_unpacklo_epi8( high, low ) );
+        _mm_storeu_si128( (__m128i*)( out + 16 ), _mm_unpackhi_epi8( high, low ) );
+    }
+    return done;
+}
+
+size_t hex_decode_ssse3( const char* in, size_t len, uint8_t* out, size_t out_len )
+{
+    // each pair of nibbles becomes high * 16 + low
+    const __m128i weights = _mm_set1_epi16( 0x0110 );
+    size_t done = 0;
+    for( ; len - done >= 32 && out_len >= 16; done += 32, out += 16, out_len -= 16 )
+    {
+        __m128i valid0, valid1;
+        const __m128i v0 = hex_values( _mm_loadu_si128( (const __m128i*)( in + done ) ), valid0 );
+        const __m128i v1 = hex_values( _mm_loadu_si128( (const __m128i*)( in + done + 16 ) ), valid1 );
+        if( !all_set( _mm_and_si128( valid0, valid1 ) ) )
+            break;
+        _mm_storeu_si128( (__m128i*)out, _mm_packus_epi16( _mm_maddubs_epi16( v0, weights ),
+                                                           _mm_maddubs_epi16( v1, weights ) ) );
+    }
+    return done;
+}
+
+size_t base64_encode_ssse3( const uint8_t* in, size_t len, char* out )
+{
+    // each block loads 16 bytes and uses 12 of them
+    size_t done = 0;
+    for( ; len - done >= 16; done += 12, out += 16 )
+    {
+        const __m128i bytes = _mm_loadu_si128( (const __m128i*)( in + done ) );
+        _mm_storeu_si128( (__m128i*)out, base64_chars( base64_split( bytes ) ) );
+    }
+    return done;
+}
+
+size_t base64_decode_ssse3( const char* in, size_t len, uint8_t* out )
+{
+    // the bits of the high and low nibble tables of a character only overlap when it is not in the alphabet
+    const __m128i lut_lo = _mm_setr_epi8( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a );
+    const __m128i lut_hi = _mm_setr_epi8( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                          0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+    // offset from a character to its value, by high nibble with '/' moved to slot 1
+    const __m128i lut_roll = _mm_setr_epi8( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+    const __m128i mask_2f = _mm_set1_epi8( 0x2f );
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t done = 0;
+    for( ; len - done >= 16; done += 16, out += 12 )
+    {
+        const __m128i chars = _mm_loadu_si128( (const __m128i*)( in + done ) );
+        const __m128i hi_nibbles = _mm_and_si128( _mm_srli_epi32( chars, 4 ), mask_2f );
+        const __m128i lo_nibbles = _mm_and_si128( chars, mask_2f );
+        const __m128i hi = _mm_shuffle_epi8( lut_hi, hi_nibbles );
+        const __m128i lo = _mm_shuffle_epi8( lut_lo, lo_nibbles );
+        if( !all_set( _mm_cmpeq_epi8( _mm_and_si128( lo, hi ), zero ) ) )
+            break;
+
+        const __m128i eq_2f = _mm_cmpeq_epi8( chars, mask_2f );
+        const __m128i roll = _mm_shuffle_epi8( lut_roll, _mm_add_epi8( eq_2f, hi_nibbles ) );
+        const __m128i values = _mm_add_epi8( chars, roll );
+
+        // pack the four 6 bit values of every 32 bit word into 3 bytes
+        const __m128i pairs = _mm_maddubs_epi16( values, _mm_set1_epi32( 0x01400140 ) );
+        const __m128i words = _mm_madd_epi16( pairs, _mm_set1_epi32( 0x00011000 ) );
+        const __m128i bytes = _mm_shuffle_epi8( words, _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                                                      -1, -1, -1, -1 ) );
+        _mm_storel_epi64( (__m128i*)out, bytes );
+        const uint32_t tail = uint32_t( _mm_cvtsi128_si32( _mm_srli_si128( bytes, 8 ) ) );
+        memcpy( out + 8, &tail, 4 );
+    }
+    return done;
+}
+
+} } // fc::detail
+
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <boost/atomic.hpp>
+#include <boost/memory_order.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/chrono.hpp>
+#include <climits>
+#include <cstdint>
+
+#if defined(__linux__)
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# include <time.h>
+#endif
+
+namespace fc {
+    /**
+     *  Wakeup primitive used by thread_d to park when it runs out of work.
+     *
+     *  Producers only pay for an atomic load unless the consumer is actually
+     *  parked; the consumer announces itself with prepare_wait(), re-checks
+     *  its queues and then either cancels or commits the wait.  On Linux the
+     *  park is a futex wait on the epoch counter, elsewhere it falls back to
+     *  a mutex and condition variable taken only when a waiter is present.
+     *
+     *  Protocol:
+     *  @code
+     *    event_count::key k = ev.prepare_wait();
+     *    if( work_available() ) ev.cancel_wait();
+     *    else ev.wait( k );
+     *  @endcode
+     */
+    class event_count {
+    public:
+        typedef uint32_t key;
+
+        event_count() : _epoch(0), _waiters(0) {
+            static_assert(sizeof(boost::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit int");
+        }
+
+        key prepare_wait() {
+            _waiters.fetch_add(1, boost::memory_order_seq_cst);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            return _epoch.load(boost::memory_order_acquire);
+        }
+
+        void cancel_wait() {
+            _waiters.fetch_sub(1, boost::memory_order_relaxed);
+        }
+
+        /**
+         *  Blocks until notify() is called after prepare_wait() returned @p k, or
+         *  until @p timeout_us microseconds passed.  A negative timeout waits forever.
+         */
+        void wait(key k, int64_t timeout_us = -1) {
+#if defined(__linux__)
+            if (_epoch.load(boost::memory_order_acquire) == k) {
+                if (timeout_us < 0) {
+                    futex_wait(k, nullptr);
+                } else {
+                    struct timespec ts;
+                    ts.tv_sec = timeout_us / 1000000;
+                    ts.tv_nsec = (timeout_us % 1000000) * 1000;
+                    futex_wait(k, &ts);
+                }
+            }
+#else
+            boost::unique_lock<boost::mutex> lock(_mutex);
+            if (timeout_us < 0) {
+                while (_epoch.load(boost::memory_order_acquire) == k) {
+                    _cond.wait(lock);
+                }
+            } else {
+                auto deadline = boost::chrono::steady_clock::now() + boost::chrono::microseconds(timeout_us);
+                while (_epoch.load(boost::memory_order_acquire) == k) {
+                    if (_cond.wait_until(lock, deadline) == boost::cv_status::timeout) {
+                        break;
+                    }
+                }
+            }
+#endif
+            _waiters.fetch_sub(1, boost::memory_order_relaxed);
+        }
+
+        /**
+         *  Wakes the parked consumer, if any.  The caller must have published the
+         *  work it is signalling before calling notify().
+         */
+        void notify() {
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (!_waiters.load(boost::memory_order_relaxed)) {
+                return;
+            }
+#if defined(__linux__)
+            _epoch.fetch_add(1, boost::memory_order_release);
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+            {
+                boost::unique_lock<boost::mutex> lock(_mutex);
+                _epoch.fetch_add(1, boost::memory_order_release);
+            }
+            _cond.notify_all();
+#endif
+        }
+
+    private:
+#if defined(__linux__)
+        void futex_wait(key k, const struct timespec *timeout) {
+            // spurious returns (EINTR, EAGAIN) are fine, the caller re-checks its queues
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_epoch), FUTEX_WAIT_PRIVATE, k, timeout, nullptr, 0);
+        }
+#else
+        boost::mutex _mutex;
+        boost::condition_variable _cond;
+#endif
+
+        boost::atomic<uint32_t> _epoch;
+        boost::atomic<uint32_t> _waiters;
+    };
+} // namespace fc
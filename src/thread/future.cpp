@@ -19,6 +19,7 @@ namespace fc {
    _cancellation_reason(nullptr),
 #endif
    _desc(desc),
+   _value(nullptr),
    _compl(nullptr)
   { }
 
@@ -125,7 +126,14 @@ namespace fc {
     if( blocked_thread ) 
       blocked_thread->notify(ptr(this,true));
   }
-  promise_base::~promise_base() { }
+  promise_base::~promise_base() {
+    // handlers of a promise that never completed
+    while( _compl ) {
+      detail::completion_handler* next = _compl->_next;
+      delete _compl;
+      _compl = next;
+    }
+  }
   void promise_base::_set_timeout(){
     if( _ready ) 
       return;
@@ -134,21 +142,42 @@ namespace fc {
   void promise_base::_set_value(const void* s){
  //   slog( "%p == %d", &_ready, int(_ready));
 //    BOOST_ASSERT( !_ready );
+    detail::completion_handler* handlers;
     { synchronized(_spin_yield) 
       if (_ready) //don't allow promise to be set more than once
         return;
+      _value = s;
       _ready = true;
+      handlers = _compl;
+      _compl = nullptr;
     }
     _notify();
-    if( nullptr != _compl ) {
-      _compl->on_complete(s,_exceptp);
+
+    // handlers were pushed onto the front of the list, call them in registration order
+    detail::completion_handler* in_order = nullptr;
+    while( handlers ) {
+      detail::completion_handler* next = handlers->_next;
+      handlers->_next = in_order;
+      in_order = handlers;
+      handlers = next;
+    }
+    while( in_order ) {
+      detail::completion_handler* next = in_order->_next;
+      in_order->on_complete(s,_exceptp);
+      delete in_order;
+      in_order = next;
     }
   }
   void promise_base::_on_complete( detail::completion_handler* c ) {
     { synchronized(_spin_yield) 
-        delete _compl; 
+      if( !_ready ) {
+        c->_next = _compl;
         _compl = c;
+        return;
+      }
     }
+    // already completed, call the handler right away
+    c->on_complete(_value,_exceptp);
+    delete c;
   }
 }
-
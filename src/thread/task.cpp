@@ -4,6 +4,7 @@
 #include <fc/thread/spin_lock.hpp>
 #include <fc/fwd_impl.hpp>
 #include "context.hpp"
+#include "task_pool.hpp"
 
 #include <fc/log/logger.hpp>
 #include <boost/exception/all.hpp>
@@ -25,6 +26,14 @@ namespace fc {
   _functor(func){
   }
 
+  void* task_base::operator new( std::size_t size ) {
+    return detail::task_pool::allocate( size );
+  }
+
+  void task_base::operator delete( void* p ) {
+    detail::task_pool::deallocate( p );
+  }
+
   void task_base::run() {
 #ifdef _MSC_VER
     __try {
@@ -52,10 +61,15 @@ namespace fc {
     } 
     catch ( const exception& e ) 
     {
+      // posted tasks have no future to report through
+      if( !_promise_impl && !canceled() )
+        wlog( "posted task ${description} threw: ${e}", ("description", get_desc())("e", e.to_detail_string()) );
       set_exception( e.dynamic_copy_exception() );
     } 
     catch ( ... ) 
     {
+      if( !_promise_impl && !canceled() )
+        wlog( "posted task ${description} threw: ${diagnostic}", ("description", get_desc())("diagnostic",boost::current_exception_diagnostic_information()) );
       set_exception( std::make_shared<unhandled_exception>( FC_LOG_MESSAGE( warn, "unhandled exception: ${diagnostic}", ("diagnostic",boost::current_exception_diagnostic_information()) ) ) );
     }
   }
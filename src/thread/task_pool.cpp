@@ -0,0 +1,201 @@
+#include "task_pool.hpp"
+
+#include <boost/atomic.hpp>
+#include <boost/memory_order.hpp>
+#include <assert.h>
+#include <new>
+
+namespace fc {
+    namespace detail {
+        namespace {
+            const std::size_t size_classes[] = {128, 256, 512, 1024};
+            const unsigned num_size_classes = sizeof(size_classes) / sizeof(size_classes[0]);
+
+            // upper bound on the number of idle blocks a thread keeps per size class
+            const unsigned max_cached_blocks = 1024;
+
+            struct thread_pool;
+
+            struct block_header {
+                thread_pool *owner;     // nullptr for blocks served by the global allocator
+                block_header *next;     // free list link, only meaningful while the block is free
+                unsigned size_class;
+            };
+
+            // keep the payload aligned as strictly as ::operator new would
+            const std::size_t header_size =
+                    (sizeof(block_header) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+            inline void *payload_of(block_header *h) {
+                return reinterpret_cast<char *>(h) + header_size;
+            }
+
+            inline block_header *header_of(void *p) {
+                return reinterpret_cast<block_header *>(reinterpret_cast<char *>(p) - header_size);
+            }
+
+            inline unsigned size_class_for(std::size_t size) {
+                for (unsigned i = 0; i < num_size_classes; ++i) {
+                    if (size <= size_classes[i]) {
+                        return i;
+                    }
+                }
+                return num_size_classes;
+            }
+
+            struct thread_pool {
+                block_header *free_list[num_size_classes];
+                unsigned free_count[num_size_classes];
+
+                // blocks released by other threads, drained by the owner
+                boost::atomic<block_header *> returned;
+
+                // one reference for the owning thread plus one per block handed out;
+                // the pool is destroyed once the thread has exited and every block came back
+                boost::atomic<int32_t> refs;
+
+                thread_pool() : returned(nullptr), refs(1) {
+                    for (unsigned i = 0; i < num_size_classes; ++i) {
+                        free_list[i] = nullptr;
+                        free_count[i] = 0;
+                    }
+                }
+
+                ~thread_pool() {
+                    release_cached_blocks();
+                }
+
+                block_header *pop(unsigned sc) {
+                    if (!free_list[sc]) {
+                        drain_returned();
+                    }
+                    block_header *h = free_list[sc];
+                    if (h) {
+                        free_list[sc] = h->next;
+                        --free_count[sc];
+                    }
+                    return h;
+                }
+
+                void push_local(block_header *h) {
+                    unsigned sc = h->size_class;
+                    if (free_count[sc] >= max_cached_blocks) {
+                        ::operator delete(h);
+                        return;
+                    }
+                    h->next = free_list[sc];
+                    free_list[sc] = h;
+                    ++free_count[sc];
+                }
+
+                void push_returned(block_header *h) {
+                    block_header *stale_head = returned.load(boost::memory_order_relaxed);
+                    do {
+                        h->next = stale_head;
+                    } while (!returned.compare_exchange_weak(stale_head, h, boost::memory_order_release));
+                }
+
+                void drain_returned() {
+                    block_header *h = returned.exchange(nullptr, boost::memory_order_acquire);
+                    while (h) {
+                        block_header *next = h->next;
+                        push_local(h);
+                        h = next;
+                    }
+                }
+
+                void release_cached_blocks() {
+                    drain_returned();
+                    for (unsigned i = 0; i < num_size_classes; ++i) {
+                        while (free_list[i]) {
+                            block_header *next = free_list[i]->next;
+                            ::operator delete(free_list[i]);
+                            free_list[i] = next;
+                        }
+                        free_count[i] = 0;
+                    }
+                }
+
+                void unref() {
+                    if (refs.fetch_sub(1, boost::memory_order_acq_rel) == 1) {
+                        delete this;
+                    }
+                }
+            };
+
+            // set once the thread_local holder below has been destroyed, so tasks released
+            // during the remainder of thread teardown do not resurrect the pool
+            __thread bool pool_destroyed = false;
+
+            struct thread_pool_holder {
+                thread_pool *pool;
+
+                thread_pool_holder() : pool(nullptr) {
+                }
+
+                ~thread_pool_holder() {
+                    pool_destroyed = true;
+                    if (pool) {
+                        thread_pool *p = pool;
+                        pool = nullptr;
+                        p->release_cached_blocks();
+                        p->unref();
+                    }
+                }
+            };
+
+            thread_local thread_pool_holder holder;
+
+            thread_pool *current_pool() {
+                if (pool_destroyed) {
+                    return nullptr;
+                }
+                if (!holder.pool) {
+                    holder.pool = new thread_pool();
+                }
+                return holder.pool;
+            }
+        }
+
+        void *task_pool::allocate(std::size_t size) {
+            unsigned sc = size_class_for(size);
+            thread_pool *pool = sc < num_size_classes ? current_pool() : nullptr;
+            if (!pool) {
+                block_header *h = static_cast<block_header *>(::operator new(header_size + size));
+                h->owner = nullptr;
+                h->next = nullptr;
+                h->size_class = sc;
+                return payload_of(h);
+            }
+
+            block_header *h = pool->pop(sc);
+            if (!h) {
+                h = static_cast<block_header *>(::operator new(header_size + size_classes[sc]));
+                h->owner = pool;
+                h->size_class = sc;
+            }
+            h->next = nullptr;
+            pool->refs.fetch_add(1, boost::memory_order_relaxed);
+            return payload_of(h);
+        }
+
+        void task_pool::deallocate(void *p) {
+            if (!p) {
+                return;
+            }
+            block_header *h = header_of(p);
+            thread_pool *owner = h->owner;
+            if (!owner) {
+                ::operator delete(h);
+                return;
+            }
+
+            if (!pool_destroyed && owner == holder.pool) {
+                owner->push_local(h);
+            } else {
+                owner->push_returned(h);
+            }
+            owner->unref();
+        }
+    }
+} // namespace fc
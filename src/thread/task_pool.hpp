@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace fc {
+    namespace detail {
+        /**
+         *  Size-class slab allocator used for task objects.
+         *
+         *  Every thread owns a pool with one free list per size class, so the
+         *  common async/run/release cycle does not touch the global heap.  A block
+         *  released on a thread other than the one that allocated it is pushed onto
+         *  the owner's lock-free return stack and reclaimed by the owner the next
+         *  time its local free list runs dry.  Requests larger than the biggest
+         *  size class fall through to the global allocator.
+         */
+        class task_pool {
+        public:
+            static void *allocate(std::size_t size);
+
+            static void deallocate(void *p);
+        };
+    }
+} // namespace fc
@@ -151,15 +151,23 @@ namespace fc {
         return NULL;
     }
 
+    void thread::set_idle_policy(const idle_policy &p) {
+        my->idle.store(p, boost::memory_order_relaxed);
+    }
+
+    idle_policy thread::get_idle_policy() const {
+        return my->idle.load(boost::memory_order_relaxed);
+    }
+
     void thread::debug(const std::string &d) { /*my->debug(d);*/ }
 
     void thread::quit() {
         //if quitting from a different thread, start quit task on thread.
         //If we have and know our attached boost thread, wait for it to finish, then return.
         if (&current() != this) {
-            async([=]() {
+            post([=]() {
                 quit();
-            }, "thread::quit");//.wait();
+            }, "thread::quit");
             if (my->boost_thread) {
                 //wlog("destroying boost thread ${tid}",("tid",(uintptr_t)my->boost_thread->native_handle()));
                 my->boost_thread->join();
@@ -170,6 +178,10 @@ namespace fc {
         }
 
         my->done = true;
+        // deferred work holding the handle fails from here on, and whatever it queued
+        // before is moved to task_pqueue to be canceled below
+        my->handle->invalidate();
+        my->move_newly_scheduled_tasks_to_task_pqueue();
         //      wlog( "${s}", ("s",name()) );
         // We are quiting from our own thread...
 
@@ -256,6 +268,34 @@ namespace fc {
         return !my->done;
     }
 
+    const std::shared_ptr<detail::thread_handle> &thread::handle() const {
+        return my->handle;
+    }
+
+    namespace detail {
+        thread_handle::thread_handle(thread *t) : _thread(t) {
+        }
+
+        bool thread_handle::async_task(task_base *t, const priority &p) {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (!_thread) {
+                return false;
+            }
+            _thread->async_task(t, p);
+            return true;
+        }
+
+        bool thread_handle::is_current() const {
+            std::lock_guard<std::mutex> guard(_lock);
+            return _thread == &thread::current();
+        }
+
+        void thread_handle::invalidate() {
+            std::lock_guard<std::mutex> guard(_lock);
+            _thread = nullptr;
+        }
+    }
+
     priority thread::current_priority() const {
         BOOST_ASSERT(my);
         if (my->current) {
@@ -332,26 +372,46 @@ namespace fc {
     }
 
     void thread::poke() {
-        boost::unique_lock<boost::mutex> lock(my->task_ready_mutex);
-        my->task_ready.notify_one();
+        my->task_ready.notify();
     }
 
     void thread::async_task(task_base *t, const priority &p, const time_point &tp) {
         assert(my);
+        t->_prio = p;
         t->_when = tp;
         // slog( "when %lld", t->_when.time_since_epoch().count() );
         // slog( "delay %lld", (tp - fc::time_point::now()).count() );
+        push_tasks(t, t);
+    }
+
+    void thread::async_tasks(const std::vector<task_base *> &tasks, const priority &p) {
+        assert(my);
+        if (tasks.empty()) {
+            return;
+        }
+
+        // task_in_queue is a stack that enqueue() walks newest-first, so link the
+        // batch so that the first submitted task ends up at the tail
+        for (size_t i = tasks.size() - 1; i > 0; --i) {
+            tasks[i]->_prio = p;
+            tasks[i]->_when = time_point::min();
+            tasks[i]->_next = tasks[i - 1];
+        }
+        tasks.front()->_prio = p;
+        tasks.front()->_when = time_point::min();
+        push_tasks(tasks.back(), tasks.front());
+    }
+
+    void thread::push_tasks(task_base *head, task_base *tail) {
         task_base *stale_head = my->task_in_queue.load(boost::memory_order_relaxed);
         do {
-            t->_next = stale_head;
-        } while (!my->task_in_queue.compare_exchange_weak(stale_head, t, boost::memory_order_release));
+            tail->_next = stale_head;
+        } while (!my->task_in_queue.compare_exchange_weak(stale_head, head, boost::memory_order_release));
 
-        // Because only one thread can post the 'first task', only that thread will attempt
-        // to aquire the lock and therefore there should be no contention on this lock except
-        // when *this thread is about to block on a wait condition.
+        // Because only one thread can post the 'first task', only that thread needs to
+        // wake *this thread up; notify() is a single load unless *this thread is parked.
         if (this != &current() && !stale_head) {
-            boost::unique_lock<boost::mutex> lock(my->task_ready_mutex);
-            my->task_ready.notify_one();
+            my->task_ready.notify();
         }
     }
 
@@ -419,7 +479,7 @@ namespace fc {
         //slog( "this %p  my %p", this, my );
         BOOST_ASSERT(p->ready());
         if (!is_current()) {
-            this->async([=]() {
+            this->post([=]() {
                 notify(p);
             }, "notify", priority::max());
             return;
@@ -469,7 +529,7 @@ namespace fc {
     }
 
     void thread::notify_task_has_been_canceled() {
-        async([=]() {
+        post([=]() {
             my->notify_task_has_been_canceled();
         }, "notify_task_has_been_canceled", priority::max());
     }
@@ -3,12 +3,19 @@
 #include <fc/time.hpp>
 #include <boost/thread.hpp>
 #include "context.hpp"
+#include "event_count.hpp"
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread.hpp>
 #include <boost/atomic.hpp>
 #include <vector>
 //#include <fc/logger.hpp>
 
+#if defined(_MSC_VER)
+# include <windows.h>
+#elif defined(__i386__) || defined(__x86_64__)
+# include <immintrin.h>
+#endif
+
 namespace fc {
     struct sleep_priority_less {
         bool operator()( const context::ptr& a, const context::ptr& b ) {
@@ -22,6 +29,8 @@ namespace fc {
 
            thread_d(fc::thread& s)
             :self(s), boost_thread(0),
+             idle(idle_policy()),
+             handle(std::make_shared<detail::thread_handle>(&s)),
              task_in_queue(0),
              next_posted_num(1),
              done(false),
@@ -70,8 +79,9 @@ namespace fc {
            fc::thread&             self;
            boost::thread* boost_thread;
            stack_allocator                  stack_alloc;
-           boost::condition_variable        task_ready;
-           boost::mutex                     task_ready_mutex;
+           event_count                      task_ready;     // signalled by other threads posting to an empty task_in_queue
+           boost::atomic<idle_policy>       idle;           // how long to poll task_in_queue before parking on task_ready, set from any thread
+           std::shared_ptr<detail::thread_handle> handle; // invalidated by quit()
 
            boost::atomic<task_base*>       task_in_queue;
            std::vector<task_base*>         task_pqueue;    // heap of tasks that have never started, ordered by proirity & scheduling time
@@ -527,6 +537,39 @@ namespace fc {
              return false;
            }
 
+           static inline void cpu_relax()
+           {
+#if defined(_MSC_VER)
+             YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+             _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+             __asm__ __volatile__( "yield" );
+#endif
+           }
+
+           /**
+            *  Polls task_in_queue according to the idle policy.
+            *  @return true if a task was posted while polling
+            */
+           bool poll_for_incoming_task()
+           {
+             const idle_policy policy = idle.load( boost::memory_order_relaxed );
+             for( uint32_t i = 0; i < policy.spin_count; ++i )
+             {
+               if( task_in_queue.load( boost::memory_order_relaxed ) )
+                 return true;
+               cpu_relax();
+             }
+             for( uint32_t i = 0; i < policy.yield_count; ++i )
+             {
+               if( task_in_queue.load( boost::memory_order_relaxed ) )
+                 return true;
+               boost::this_thread::yield();
+             }
+             return false;
+           }
+
            void clear_free_list() 
            {
               for( uint32_t i = 0; i < free_list.size(); ++i ) 
@@ -578,16 +621,25 @@ namespace fc {
 
                 clear_free_list();
 
-                { // lock scope
-                  boost::unique_lock<boost::mutex> lock(task_ready_mutex);
+                if( !done && poll_for_incoming_task() )
+                  continue;
+
+                { // wait scope
+                  event_count::key wait_key = task_ready.prepare_wait();
                   if( has_next_task() ) 
+                  {
+                    task_ready.cancel_wait();
                     continue;
+                  }
                   time_point timeout_time = check_for_timeouts();
                   
                   if( done ) 
+                  {
+                    task_ready.cancel_wait();
                     return;
+                  }
                   if( timeout_time == time_point::maximum() ) 
-                    task_ready.wait( lock );
+                    task_ready.wait( wait_key );
                   else if( timeout_time != time_point::min() ) 
                   {
                      // there may be tasks that have been canceled we should filter them out now
@@ -602,17 +654,18 @@ namespace fc {
                      * plus a minute before waking back up (this happened on Linux, it seems 
                      * Windows' behavior in this case was less unexpected).
                      *
-                     * Boost Chrono's steady_clock will always increase monotonically so it will 
-                     * avoid this behavior.
+                     * The wait is relative, so it behaves like a steady_clock wait.
                      *
                      * Right now we don't really have a way to distinguish when a timeout_time is coming
                      * from a function that takes a relative time like fc::usleep() vs something
                      * that takes an absolute time like fc::promise::wait_until(), so we can't always
                      * do the right thing here.
                      */ 
-                    task_ready.wait_until( lock, boost::chrono::steady_clock::now() + 
-                                                 boost::chrono::microseconds(timeout_time.time_since_epoch().count() - time_point::now().time_since_epoch().count()) );
+                    int64_t timeout_us = timeout_time.time_since_epoch().count() - time_point::now().time_since_epoch().count();
+                    task_ready.wait( wait_key, timeout_us > 0 ? timeout_us : 0 );
                   }
+                  else
+                    task_ready.cancel_wait();
                 }
               }
            }
@@ -667,7 +720,7 @@ namespace fc {
         {
           if( fc::thread::current().my != this ) 
           {
-            self.async( [=](){ unblock(c); }, "thread_d::unblock" );
+            self.post( [=](){ unblock(c); }, "thread_d::unblock" );
             return;
           }
 
@@ -0,0 +1,107 @@
+#include <fc/thread/worker_pool.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <exception>
+
+namespace fc {
+    namespace {
+        boost::mutex default_pool_mutex;
+        uint32_t default_pool_size = 0;
+        bool default_pool_created = false;
+
+        uint32_t hardware_workers() {
+            unsigned n = boost::thread::hardware_concurrency();
+            return n > 1 ? n - 1 : 0;
+        }
+    }
+
+    worker_pool::worker_pool(uint32_t threads, const std::string &name) {
+        if (!threads) {
+            threads = hardware_workers();
+        }
+        _threads.reserve(threads);
+        for (uint32_t i = 0; i < threads; ++i) {
+            _threads.emplace_back(new fc::thread(name + "-" + std::to_string(i)));
+        }
+    }
+
+    worker_pool::~worker_pool() {
+        for (auto &t : _threads) {
+            t->quit();
+        }
+    }
+
+    uint32_t worker_pool::size() const {
+        return _threads.size();
+    }
+
+    void worker_pool::for_each_range(size_t count, const std::function<void(size_t, size_t)> &f, size_t min_chunk) {
+        if (!count) {
+            return;
+        }
+        if (!min_chunk) {
+            min_chunk = 1;
+        }
+
+        size_t parts = std::min<size_t>(_threads.size() + 1, (count + min_chunk - 1) / min_chunk);
+        if (parts <= 1) {
+            f(0, count);
+            return;
+        }
+
+        // the first `extra` parts take one item more than the rest
+        size_t base = count / parts;
+        size_t extra = count % parts;
+        auto part_begin = [&](size_t p) {
+            return p * base + std::min(p, extra);
+        };
+
+        std::vector<fc::future<void>> pending;
+        pending.reserve(parts - 1);
+        for (size_t p = 1; p < parts; ++p) {
+            size_t begin = part_begin(p);
+            size_t end = part_begin(p + 1);
+            pending.push_back(_threads[p - 1]->async([&f, begin, end]() { f(begin, end); }, "worker_pool range"));
+        }
+
+        std::vector<std::exception_ptr> errors(parts);
+        try {
+            f(0, part_begin(1));
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        // wait for every part even after a failure, `f` must outlive all of them
+        for (size_t p = 1; p < parts; ++p) {
+            try {
+                pending[p - 1].wait();
+            } catch (...) {
+                errors[p] = std::current_exception();
+            }
+        }
+        for (const auto &e : errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+
+    worker_pool &worker_pool::get_default() {
+        // never destroyed, its threads must stay usable while other statics are torn down
+        static worker_pool *pool = []() {
+            boost::unique_lock<boost::mutex> lock(default_pool_mutex);
+            default_pool_created = true;
+            return new worker_pool(default_pool_size, "fc worker");
+        }();
+        return *pool;
+    }
+
+    void worker_pool::set_default_size(uint32_t threads) {
+        boost::unique_lock<boost::mutex> lock(default_pool_mutex);
+        FC_ASSERT(!default_pool_created, "the default worker pool has already been created");
+        default_pool_size = threads;
+    }
+} // namespace fc
@@ -133,4 +133,149 @@ BOOST_AUTO_TEST_CASE(bloom_test_2)
    }
 }
 
+BOOST_AUTO_TEST_CASE(blocked_bloom_contains)
+{
+   blocked_bloom_filter filter(setup_parameters());
+   BOOST_REQUIRE( !!filter );
+   BOOST_CHECK_EQUAL( filter.size() % blocked_bloom_filter::block_bits, 0u );
+
+   std::vector<std::string> strings = { "AbC", "iJk", "XYZ" };
+   filter.insert( strings.begin(), strings.end() );
+   for( uint64_t i = 0; i < 1000; ++i )
+      filter.insert( i );
+   BOOST_CHECK_EQUAL( filter.element_count(), 1003u );
+
+   BOOST_CHECK( filter.contains_all( strings.begin(), strings.end() ) == strings.end() );
+   for( uint64_t i = 0; i < 1000; ++i )
+      BOOST_CHECK( filter.contains(i) );
+   std::vector<std::string> invalid = { "AbCX", "iJkX", "XYZX" };
+   BOOST_CHECK( filter.contains_none( invalid.begin(), invalid.end() ) == invalid.end() );
+
+   // the batch lookup answers like contains(), also across its groups of keys
+   std::vector<uint64_t> keys;
+   for( uint64_t i = 500; i < 1600; ++i )
+      keys.push_back( i );
+   std::vector<bool> found = filter.contains_many( keys.begin(), keys.end() );
+   BOOST_REQUIRE_EQUAL( found.size(), keys.size() );
+   for( size_t i = 0; i < keys.size(); ++i )
+      BOOST_CHECK_EQUAL( found[i], filter.contains( keys[i] ) );
+   BOOST_CHECK( filter.contains_many( keys.end(), keys.end() ).empty() );
+
+   filter.clear();
+   BOOST_CHECK_EQUAL( filter.element_count(), 0u );
+   BOOST_CHECK( !filter.contains( strings[0] ) );
+}
+
+BOOST_AUTO_TEST_CASE(blocked_bloom_false_positive_rate)
+{
+   const bloom_parameters parameters = setup_parameters();
+   blocked_bloom_filter filter(parameters);
+   for( uint64_t i = 0; i < parameters.projected_element_count; ++i )
+      filter.insert( i );
+   BOOST_CHECK_LE( filter.effective_fpp(), parameters.false_positive_probability );
+
+   // 1e6 lookups of keys never inserted, about 100 false positives expected
+   const uint64_t lookups = 1000000;
+   uint64_t false_positives = 0;
+   for( uint64_t i = 0; i < lookups; ++i )
+      false_positives += filter.contains( i + ( uint64_t(1) << 40 ) );
+   BOOST_CHECK_LE( false_positives, 2 * parameters.false_positive_probability * lookups );
+
+   // another seed sets other bits
+   bloom_parameters reseeded = parameters;
+   reseeded.random_seed = 0x5A5A5A5A;
+   blocked_bloom_filter other(reseeded);
+   other.insert( uint64_t(1) );
+   BOOST_CHECK( !filter.compatible( other ) );
+   BOOST_CHECK( std::vector<uint64_t>( other.table(), other.table() + other.size() / 64 ) !=
+                std::vector<uint64_t>( filter.table(), filter.table() + filter.size() / 64 ) );
+}
+
+BOOST_AUTO_TEST_CASE(blocked_bloom_serialization)
+{
+   blocked_bloom_filter a(setup_parameters()), b(setup_parameters());
+   for( uint64_t i = 0; i < 100; ++i )
+   {
+      a.insert( i );
+      b.insert( i + 100 );
+   }
+
+   const blocked_bloom_filter unpacked = fc::raw::unpack<blocked_bloom_filter>( fc::raw::pack( a ) );
+   BOOST_CHECK( unpacked == a );
+   BOOST_CHECK( unpacked.compatible( a ) );
+   for( uint64_t i = 0; i < 100; ++i )
+      BOOST_CHECK( unpacked.contains( i ) );
+
+   const blocked_bloom_filter both = a | b;
+   for( uint64_t i = 0; i < 200; ++i )
+      BOOST_CHECK( both.contains( i ) );
+   BOOST_CHECK( ( both & a ) != both );
+}
+
+BOOST_AUTO_TEST_CASE(blocked_bloom_rejects_corrupted_filters)
+{
+   blocked_bloom_filter filter(setup_parameters());
+   filter.insert( uint64_t(1) );
+   BOOST_REQUIRE( filter.valid() );
+
+   blocked_bloom_filter corrupted = filter;
+   corrupted.block_count_ = 0;
+   BOOST_CHECK_THROW( fc::raw::unpack<blocked_bloom_filter>( fc::raw::pack( corrupted ) ), fc::assert_exception );
+
+   corrupted = filter;
+   corrupted.block_count_ += 1;
+   BOOST_CHECK_THROW( fc::raw::unpack<blocked_bloom_filter>( fc::raw::pack( corrupted ) ), fc::assert_exception );
+
+   corrupted = filter;
+   corrupted.bits_.pop_back();
+   BOOST_CHECK_THROW( fc::raw::unpack<blocked_bloom_filter>( fc::raw::pack( corrupted ) ), fc::assert_exception );
+
+   corrupted = filter;
+   corrupted.hash_count_ = 0;
+   BOOST_CHECK_THROW( fc::raw::unpack<blocked_bloom_filter>( fc::raw::pack( corrupted ) ), fc::assert_exception );
+
+   corrupted = filter;
+   corrupted.hash_count_ = blocked_bloom_filter::max_hashes + 1;
+   BOOST_CHECK_THROW( fc::raw::unpack<blocked_bloom_filter>( fc::raw::pack( corrupted ) ), fc::assert_exception );
+
+   // a failed unpack leaves the target as it was
+   blocked_bloom_filter target = filter;
+   const std::vector<char> packed = fc::raw::pack( corrupted );
+   fc::datastream<const char*> ds( packed.data(), packed.size() );
+   BOOST_CHECK_THROW( fc::raw::unpack( ds, target ), fc::assert_exception );
+   BOOST_CHECK( target == filter );
+}
+
+BOOST_AUTO_TEST_CASE(blocked_bloom_rejects_corrupted_variants)
+{
+   blocked_bloom_filter filter(setup_parameters());
+   filter.insert( uint64_t(1) );
+
+   fc::variant v;
+   fc::to_variant( filter, v );
+   blocked_bloom_filter restored;
+   fc::from_variant( v, restored );
+   BOOST_CHECK( restored == filter );
+   BOOST_CHECK( fc::json::from_string( fc::json::to_string( filter ) ).as<blocked_bloom_filter>() == filter );
+
+   fc::mutable_variant_object corrupted( v.get_object() );
+   corrupted( "block_count_", 0 );
+   BOOST_CHECK_THROW( fc::variant( corrupted ).as<blocked_bloom_filter>(), fc::assert_exception );
+
+   corrupted = fc::mutable_variant_object( v.get_object() );
+   corrupted( "bits_", std::vector<uint64_t>( filter.bits_.begin(), filter.bits_.end() - 1 ) );
+   BOOST_CHECK_THROW( fc::variant( corrupted ).as<blocked_bloom_filter>(), fc::assert_exception );
+
+   corrupted = fc::mutable_variant_object( v.get_object() );
+   corrupted( "hash_count_", blocked_bloom_filter::max_hashes + 1 );
+   BOOST_CHECK_THROW( fc::variant( corrupted ).as<blocked_bloom_filter>(), fc::assert_exception );
+
+   // a filter without its fields
+   BOOST_CHECK_THROW( fc::variant( fc::mutable_variant_object() ).as<blocked_bloom_filter>(), fc::assert_exception );
+
+   blocked_bloom_filter target = filter;
+   BOOST_CHECK_THROW( fc::from_variant( fc::variant( corrupted ), target ), fc::assert_exception );
+   BOOST_CHECK( target == filter );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,9 +5,44 @@
 #include <fc/crypto/aes.hpp>
 #include <fc/crypto/city.hpp>
 #include <fc/exception/exception.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/io/sstream.hpp>
+#include <fc/thread/worker_pool.hpp>
 
 #include <fc/variant.hpp>
 
+#include <cstring>
+
+namespace {
+    std::string stream_test_data( size_t size )
+    {
+        std::string data( size, 0 );
+        for( size_t i = 0; i < size; ++i )
+            data[i] = char( i * 131 + ( i >> 8 ) );
+        return data;
+    }
+
+    std::string stream_encode( fc::aes_stream_encoder& enc, const std::string& plain, const fc::sha256& key,
+                               const fc::uint128_t& iv, const std::vector<char>& aad = std::vector<char>() )
+    {
+        fc::stringstream in( plain ), out;
+        uint64_t written = enc.encode( in, out, key, iv, aad );
+        std::string cipher = out.str();
+        BOOST_CHECK_EQUAL( written, cipher.size() );
+        return cipher;
+    }
+
+    std::string stream_decode( fc::aes_stream_decoder& dec, const std::string& cipher, const fc::sha256& key,
+                               const fc::uint128_t& iv, const std::vector<char>& aad = std::vector<char>() )
+    {
+        fc::stringstream in( cipher ), out;
+        uint64_t written = dec.decode( in, out, key, iv, aad );
+        std::string plain = out.str();
+        BOOST_CHECK_EQUAL( written, plain.size() );
+        return plain;
+    }
+}
+
 BOOST_AUTO_TEST_SUITE(fc_crypto)
 
 BOOST_AUTO_TEST_CASE(aes_test)
@@ -67,4 +102,92 @@ BOOST_AUTO_TEST_CASE(aes_test)
 //    BOOST_CHECK( !memcmp( dcrypt.data(), data.data(), len) );
 }
 
+BOOST_AUTO_TEST_CASE(aes_stream_round_trip)
+{
+    const fc::sha512 secret = fc::sha512::hash( "stream", 6 );
+    fc::sha256 key;
+    fc::uint128_t iv;
+    memcpy( (char*)&key, (const char*)&secret, sizeof(key) );
+    memcpy( (char*)&iv, (const char*)&secret + sizeof(key), sizeof(iv) );
+
+    fc::worker_pool pool( 2 );
+    const size_t buffer_size = 4096;
+    const size_t sizes[] = { 0, 1, 15, 16, 17, buffer_size - 1, buffer_size, buffer_size + 1,
+                             buffer_size + 16, 3 * buffer_size + 5, 100000 };
+    const fc::aes_stream_mode modes[] = { fc::aes_cbc, fc::aes_ctr, fc::aes_gcm };
+    for( auto mode : modes )
+    {
+        // the contexts are reused for every size
+        fc::aes_stream_encoder enc( mode, buffer_size, &pool );
+        fc::aes_stream_decoder dec( mode, buffer_size, &pool );
+        fc::aes_stream_encoder whole( mode, 1 << 20, &pool );
+        for( size_t size : sizes )
+        {
+            const std::string plain = stream_test_data( size );
+            const std::string cipher = stream_encode( enc, plain, key, iv );
+            BOOST_CHECK( cipher == stream_encode( whole, plain, key, iv ) );
+            if( mode == fc::aes_cbc )
+            {
+                // the same as the one shot encryption
+                std::vector<char> data( plain.begin(), plain.end() );
+                std::vector<char> expected = fc::aes_encrypt( secret, data );
+                BOOST_CHECK( cipher == std::string( expected.begin(), expected.end() ) );
+            }
+            else
+                BOOST_CHECK_EQUAL( cipher.size(), size + ( mode == fc::aes_gcm ? 16 : 0 ) );
+            BOOST_CHECK( stream_decode( dec, cipher, key, iv ) == plain );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(aes_stream_gcm_authentication)
+{
+    const fc::sha256 key = fc::sha256::hash( std::string( "gcm key" ) );
+    fc::uint128_t iv( 7, 11 );
+    const std::vector<char> aad = { 'h', 'e', 'a', 'd' };
+    fc::aes_stream_encoder enc( fc::aes_gcm, 1024 );
+    fc::aes_stream_decoder dec( fc::aes_gcm, 1024 );
+
+    const std::string plain = stream_test_data( 5000 );
+    const std::string cipher = stream_encode( enc, plain, key, iv, aad );
+    BOOST_CHECK( stream_decode( dec, cipher, key, iv, aad ) == plain );
+
+    // a changed byte anywhere, including the tag that straddles a buffer boundary
+    for( size_t pos : { size_t(0), size_t(1023), size_t(4999), cipher.size() - 16, cipher.size() - 1 } )
+    {
+        std::string changed = cipher;
+        changed[pos] ^= 1;
+        BOOST_CHECK_THROW( stream_decode( dec, changed, key, iv, aad ), fc::aes_exception );
+    }
+    BOOST_CHECK_THROW( stream_decode( dec, cipher.substr( 0, cipher.size() - 1 ), key, iv, aad ), fc::aes_exception );
+    BOOST_CHECK_THROW( stream_decode( dec, cipher.substr( 0, 10 ), key, iv, aad ), fc::aes_exception );
+    BOOST_CHECK_THROW( stream_decode( dec, cipher, key, iv ), fc::aes_exception );
+    BOOST_CHECK_THROW( stream_decode( dec, cipher, key, fc::uint128_t( 7, 12 ), aad ), fc::aes_exception );
+
+    // still usable after a failure
+    BOOST_CHECK( stream_decode( dec, cipher, key, iv, aad ) == plain );
+
+    fc::aes_stream_encoder cbc( fc::aes_cbc );
+    BOOST_CHECK_THROW( stream_encode( cbc, plain, key, iv, aad ), fc::assert_exception );
+}
+
+BOOST_AUTO_TEST_CASE(aes_stream_save_load)
+{
+    const fc::sha512 key = fc::sha512::hash( "backup", 6 );
+    const std::string plain = stream_test_data( 3 * 1000 * 1000 + 7 );
+    fc::temp_directory dir;
+    const fc::path file = dir.path() / "backup";
+
+    fc::stringstream in( plain );
+    fc::aes_stream_save( file, key, in );
+    BOOST_CHECK_EQUAL( fc::file_size( file ), 8 + 16 + plain.size() + 16 );
+
+    fc::stringstream out;
+    fc::aes_stream_load( file, key, out );
+    BOOST_CHECK( out.str() == plain );
+
+    fc::stringstream ignored;
+    BOOST_CHECK_THROW( fc::aes_stream_load( file, fc::sha512::hash( "wrong", 5 ), ignored ), fc::aes_exception );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/**
+ *  Compares fc::to_base58() and fc::from_base58() against the OpenSSL BIGNUM
+ *  conversion they replaced, for compressed public keys (33 bytes), keys with
+ *  checksum (37), uncompressed keys and compact signatures (65) and extended
+ *  keys (82, the generic path).
+ *
+ *  usage: base58_bench [rounds]
+ */
+#include <fc/crypto/base58.hpp>
+
+#include <boost/chrono.hpp>
+#include <openssl/bn.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start) {
+        return boost::chrono::duration_cast<boost::chrono::duration<double>>(clock_type::now() - start).count();
+    }
+
+    const char *alphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+    // the previous implementation: one BN_div per output digit and one BN_mul per input character
+    std::string bignum_encode(const char *data, size_t size) {
+        BN_CTX *ctx = BN_CTX_new();
+        BIGNUM *bn = BN_bin2bn((const unsigned char *)data, size, nullptr);
+        BIGNUM *base = BN_new(), *dv = BN_new(), *rem = BN_new();
+        BN_set_word(base, 58);
+        std::string result;
+        while (!BN_is_zero(bn)) {
+            BN_div(dv, rem, bn, base, ctx);
+            BN_copy(bn, dv);
+            result += alphabet[BN_get_word(rem)];
+        }
+        for (size_t i = 0; i < size && data[i] == 0; ++i) {
+            result += alphabet[0];
+        }
+        std::reverse(result.begin(), result.end());
+        BN_free(bn), BN_free(base), BN_free(dv), BN_free(rem);
+        BN_CTX_free(ctx);
+        return result;
+    }
+
+    std::vector<char> bignum_decode(const std::string &str) {
+        BN_CTX *ctx = BN_CTX_new();
+        BIGNUM *bn = BN_new(), *base = BN_new();
+        BN_zero(bn);
+        BN_set_word(base, 58);
+        for (char c : str) {
+            BN_mul(bn, bn, base, ctx);
+            BN_add_word(bn, strchr(alphabet, c) - alphabet);
+        }
+        size_t zeros = 0;
+        while (zeros < str.size() && str[zeros] == alphabet[0]) {
+            ++zeros;
+        }
+        std::vector<char> result(zeros + BN_num_bytes(bn));
+        BN_bn2bin(bn, (unsigned char *)result.data() + zeros);
+        BN_free(bn), BN_free(base);
+        BN_CTX_free(ctx);
+        return result;
+    }
+}
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    for (size_t size : {33u, 37u, 65u, 82u}) {
+        std::vector<std::vector<char>> inputs(64, std::vector<char>(size));
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            for (size_t j = 0; j < size; ++j) {
+                inputs[i][j] = char(i * 31 + j * 7 + 1);
+            }
+        }
+        std::vector<std::string> encoded;
+        for (const auto &in : inputs) {
+            encoded.push_back(fc::to_base58(in));
+            if (encoded.back() != bignum_encode(in.data(), in.size()) ||
+                fc::from_base58(encoded.back()) != bignum_decode(encoded.back())) {
+                std::cerr << "mismatch for " << size << " bytes\n";
+                return 1;
+            }
+        }
+
+        size_t sink = 0;
+        auto start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) {
+            const auto &in = inputs[r % inputs.size()];
+            sink += bignum_encode(in.data(), in.size()).size();
+        }
+        double old_encode = seconds_since(start);
+
+        start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) {
+            const auto &in = inputs[r % inputs.size()];
+            sink += fc::to_base58(in.data(), in.size()).size();
+        }
+        double new_encode = seconds_since(start);
+
+        start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) {
+            sink += bignum_decode(encoded[r % encoded.size()]).size();
+        }
+        double old_decode = seconds_since(start);
+
+        start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) {
+            sink += fc::from_base58(encoded[r % encoded.size()]).size();
+        }
+        double new_decode = seconds_since(start);
+
+        std::cout << size << " bytes: encode " << rounds / old_encode / 1e6 << " -> " << rounds / new_encode / 1e6
+                  << " M/s (x" << old_encode / new_encode << "), decode " << rounds / old_decode / 1e6 << " -> "
+                  << rounds / new_decode / 1e6 << " M/s (x" << old_decode / new_decode << ")"
+                  << (sink ? "" : " ") << "\n";
+    }
+    return 0;
+}
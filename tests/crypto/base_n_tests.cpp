@@ -124,6 +124,98 @@ BOOST_AUTO_TEST_CASE(base58_test)
     test_58( TEST5, "111" );
 }
 
+// schoolbook conversion, one base58 digit per pass over the whole number
+static std::string reference_58( const std::vector<char>& data )
+{
+    static const char* alphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    std::vector<unsigned char> num( data.begin(), data.end() );
+    std::string result;
+    size_t start = 0;
+    while( start < num.size() && num[start] == 0 ) { result += '1'; ++start; }
+    std::string digits;
+    while( start < num.size() )
+    {
+        unsigned rest = 0;
+        for( size_t i = start; i < num.size(); ++i )
+        {
+            unsigned cur = rest * 256 + num[i];
+            num[i] = cur / 58;
+            rest = cur % 58;
+        }
+        digits += alphabet[rest];
+        while( start < num.size() && num[start] == 0 ) ++start;
+    }
+    return result + std::string( digits.rbegin(), digits.rend() );
+}
+
+BOOST_AUTO_TEST_CASE(base58_vectors)
+{
+    static const std::pair<const char*, const char*> vectors[] = {
+        { "61", "2g" },
+        { "626262", "a3gV" },
+        { "73696d706c792061206c6f6e6720737472696e67", "2cFupjhnEsSn59qHXstmK2ffpLv2" },
+        { "00eb15231dfceb60925886b67d065299925915aeb172c06647", "1NS17iag9jJgTHD1VXjvLCEnZuQ3rJDE9L" },
+        { "bf4f89001e670274dd", "3SEo3LWLoPntC" },
+        { "ecac89cad93923c02321", "EJDM8drfXA6uyA" },
+        { "00000000000000000000", "1111111111" },
+        { "000111d38e5fc9071ffcd20b4a763cc9ae4f252bb4e48fd66a835e252ada93ff480d6dd43dc62a641155a5",
+          "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz" },
+    };
+    for( const auto& v : vectors )
+    {
+        std::vector<char> data( strlen( v.first ) / 2 );
+        fc::from_hex( v.first, data.data(), data.size() );
+        BOOST_CHECK_EQUAL( fc::to_base58( data ), v.second );
+        BOOST_CHECK( fc::from_base58( v.second ) == data );
+    }
+
+    // surrounding whitespace is ignored, anything else outside the alphabet is rejected
+    BOOST_CHECK( fc::from_base58( " \t2g\n" ) == std::vector<char>( 1, 'a' ) );
+    BOOST_CHECK_THROW( fc::from_base58( "2g0" ), fc::parse_error_exception );
+    BOOST_CHECK_THROW( fc::from_base58( "2 g" ), fc::parse_error_exception );
+    BOOST_CHECK_THROW( fc::from_base58( "2gI" ), fc::parse_error_exception );
+}
+
+BOOST_AUTO_TEST_CASE(base58_sizes)
+{
+    // every length up to the heap fallback and beyond, with and without leading zeros
+    for( size_t size = 0; size <= 300; size += ( size < 80 ? 1 : 17 ) )
+    {
+        for( size_t zeros : { size_t(0), size_t(1), size_t(3) } )
+        {
+            if( zeros > size ) continue;
+            std::vector<char> data( size );
+            for( size_t i = zeros; i < size; ++i )
+                data[i] = char( i * 151 + size * 7 + 1 );
+            if( zeros < size && data[zeros] == 0 ) data[zeros] = 1;
+
+            std::string expected = reference_58( data );
+            std::string encoded = fc::to_base58( data );
+            BOOST_REQUIRE_EQUAL( encoded, expected );
+            BOOST_CHECK( encoded.size() <= fc::base58_max_size( size ) );
+            BOOST_CHECK( fc::from_base58( encoded ) == data );
+
+            std::vector<char> chars( fc::base58_max_size( size ) );
+            size_t len = fc::to_base58( data.data(), data.size(), chars.data(), chars.size() );
+            BOOST_CHECK_EQUAL( std::string( chars.data(), len ), expected );
+
+            std::vector<char> bytes( size );
+            BOOST_CHECK_EQUAL( fc::from_base58( encoded, bytes.data(), bytes.size() ), size );
+            BOOST_CHECK( bytes == data );
+            if( size > 0 )
+            {
+                BOOST_CHECK_THROW( fc::from_base58( encoded, bytes.data(), size - 1 ), fc::exception );
+                if( len > 0 )
+                    BOOST_CHECK_THROW( fc::to_base58( data.data(), size, chars.data(), len - 1 ), fc::exception );
+            }
+        }
+    }
+
+    // all ones decode into the largest value of the size
+    std::vector<char> ff( 37, char(0xff) );
+    BOOST_CHECK( fc::from_base58( fc::to_base58( ff ) ) == ff );
+}
+
 
 static void test_64( const std::string& test, const std::string& expected )
 {
@@ -147,4 +239,71 @@ BOOST_AUTO_TEST_CASE(base64_test)
 }
 
 
+// long enough for the vectorized block loops, with tails of every length
+BOOST_AUTO_TEST_CASE(bulk_hex_base64)
+{
+    static const char* b64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for( size_t size = 0; size < 200; ++size )
+    {
+        std::string data( size, '\0' );
+        for( size_t i = 0; i < size; ++i )
+            data[i] = char( i * 97 + size );
+
+        std::string hex;
+        for( unsigned char c : data )
+            ( hex += "0123456789abcdef"[c >> 4] ) += "0123456789abcdef"[c & 15];
+        BOOST_REQUIRE_EQUAL( fc::to_hex( data.data(), size ), hex );
+
+        std::vector<char> bytes( size + 1 );
+        BOOST_CHECK_EQUAL( fc::from_hex( hex.data(), hex.size(), bytes.data(), size ), size );
+        BOOST_CHECK( !memcmp( bytes.data(), data.data(), size ) );
+        std::string upper = hex;
+        for( char& c : upper ) c = toupper( c );
+        BOOST_CHECK_EQUAL( fc::from_hex( upper, bytes.data(), size ), size );
+        BOOST_CHECK( !memcmp( bytes.data(), data.data(), size ) );
+        if( size > 20 )
+        {
+            BOOST_CHECK_EQUAL( fc::from_hex( hex, bytes.data(), 20 ), 20 );
+            std::string bad = hex;
+            bad[hex.size() - 3] = 'g';
+            BOOST_CHECK_THROW( fc::from_hex( bad, bytes.data(), size ), fc::exception );
+        }
+
+        std::string b64;
+        size_t i = 0;
+        for( ; i + 3 <= size; i += 3 )
+        {
+            uint32_t g = uint8_t( data[i] ) << 16 | uint8_t( data[i + 1] ) << 8 | uint8_t( data[i + 2] );
+            for( int s = 18; s >= 0; s -= 6 )
+                b64 += b64_chars[( g >> s ) & 63];
+        }
+        if( i < size )
+        {
+            uint32_t g = uint8_t( data[i] ) << 16 | ( i + 1 < size ? uint8_t( data[i + 1] ) << 8 : 0 );
+            b64 += b64_chars[g >> 18];
+            b64 += b64_chars[( g >> 12 ) & 63];
+            b64 += i + 1 < size ? b64_chars[( g >> 6 ) & 63] : '=';
+            b64 += '=';
+        }
+        BOOST_REQUIRE_EQUAL( fc::base64_encode( data ), b64 );
+        BOOST_CHECK_EQUAL( fc::base64_encoded_size( size ), b64.size() );
+        BOOST_CHECK_EQUAL( fc::base64_decode( b64 ), data );
+
+        std::vector<char> out( fc::base64_decoded_max_size( b64.size() ) + 1 );
+        size_t consumed = 0;
+        BOOST_CHECK_EQUAL( fc::base64_decode( b64.data(), b64.size(), out.data(), &consumed ), size );
+        BOOST_CHECK_EQUAL( consumed, b64.find( '=' ) == std::string::npos ? b64.size() : b64.find( '=' ) );
+
+        // decoding stops at a character outside the alphabet, in or after a whole block
+        if( b64.size() > 40 )
+        {
+            std::string cut = b64;
+            cut[37] = '-';
+            BOOST_CHECK_EQUAL( fc::base64_decode( cut ), data.substr( 0, 27 ) );
+            BOOST_CHECK_EQUAL( fc::base64_decode( cut.data(), cut.size(), out.data(), &consumed ), 27 );
+            BOOST_CHECK_EQUAL( consumed, 37 );
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,10 @@
 #include <fc/io/raw.hpp>
 #include <fc/variant.hpp>
 #include <fc/reflect/variant.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <string>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(fc_crypto)
 
@@ -110,4 +114,62 @@ BOOST_AUTO_TEST_CASE(blind_test)
    }
 }
 
+BOOST_AUTO_TEST_CASE(range_proof_batch_test)
+{
+   std::vector<fc::ecc::commitment_range_proof> proofs;
+   for( int i = 0; i < 12; ++i )
+   {
+      auto b = fc::sha256::hash( "batch blind " + std::to_string(i) );
+      auto c = fc::ecc::blind( b, 1000 + i );
+      proofs.emplace_back( c, fc::ecc::range_proof_sign( 0, c, b, fc::sha256::hash( "batch nonce" ), 0, 0, 1000 + i ) );
+   }
+   // a proof for another commitment, a truncated proof and a malformed commitment
+   std::swap( proofs[3].first, proofs[4].first );
+   proofs[7].second.resize( proofs[7].second.size() / 2 );
+   proofs[9].first = fc::ecc::commitment_type();
+
+   fc::worker_pool pool( 3 );
+   auto results = fc::ecc::verify_range_batch( proofs, &pool );
+   BOOST_REQUIRE_EQUAL( results.size(), proofs.size() );
+   for( size_t i = 0; i < proofs.size(); ++i )
+   {
+      if( i == 9 )
+      {
+         BOOST_CHECK( !results[i].valid );
+         continue;
+      }
+      uint64_t min_val = 0, max_val = 0;
+      bool valid = fc::ecc::verify_range( min_val, max_val, proofs[i].first, proofs[i].second );
+      BOOST_CHECK_EQUAL( results[i].valid, valid );
+      BOOST_CHECK_EQUAL( results[i].valid, i != 3 && i != 4 && i != 7 );
+      if( valid )
+      {
+         BOOST_CHECK_EQUAL( results[i].min_value, min_val );
+         BOOST_CHECK_EQUAL( results[i].max_value, max_val );
+      }
+   }
+
+   // the transfers of blind_test: two inputs into two outputs
+   auto InB1 = fc::sha256::hash("InB1");
+   auto InB2 = fc::sha256::hash("InB2");
+   auto OutB1 = fc::sha256::hash("OutB1");
+   auto InC1 = fc::ecc::blind(InB1,25);
+   auto InC2 = fc::ecc::blind(InB2,75);
+   auto OutC1 = fc::ecc::blind(OutB1,40);
+   auto OutC2 = fc::ecc::blind( fc::ecc::blind_sum( {InB1,InB2,OutB1}, 2 ), 60 );
+   std::vector<fc::ecc::commitment_sum> sums = {
+      { {InC1,InC2}, {OutC1,OutC2} },
+      { {InC1,InC2}, {OutC1} },
+      { {OutC1,OutC2}, {InC1,InC2} },
+      { {InC1}, {InC1} },
+      { {InC1,fc::ecc::commitment_type()}, {OutC1,OutC2} },
+   };
+   auto sums_valid = fc::ecc::verify_sum_batch( sums, &pool );
+   BOOST_REQUIRE_EQUAL( sums_valid.size(), sums.size() );
+   for( size_t i = 0; i + 1 < sums.size(); ++i )
+      BOOST_CHECK_EQUAL( sums_valid[i], fc::ecc::verify_sum( sums[i].first, sums[i].second ) );
+   BOOST_CHECK( sums_valid[0] && !sums_valid[1] && sums_valid[2] && sums_valid[3] );
+   BOOST_CHECK( !sums_valid.back() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
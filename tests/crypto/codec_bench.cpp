@@ -0,0 +1,87 @@
+/**
+ *  Measures the hex and base64 codecs for blob sizes seen in API calls, from
+ *  digests and signatures to raw transactions and large custom operations.
+ *  Each codec is timed through the std::string interface, through the caller
+ *  buffer interface and, as a baseline, as a byte at a time loop appending to
+ *  a std::string like the previous implementation.
+ *
+ *  usage: codec_bench [megabytes per measurement]
+ */
+#include <fc/crypto/base64.hpp>
+#include <fc/crypto/hex.hpp>
+
+#include <boost/chrono.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start) {
+        return boost::chrono::duration_cast<boost::chrono::duration<double>>(clock_type::now() - start).count();
+    }
+
+    std::string bytewise_to_hex(const char *d, size_t s) {
+        static const char *digits = "0123456789abcdef";
+        std::string r;
+        for (size_t i = 0; i < s; ++i) {
+            (r += digits[uint8_t(d[i]) >> 4]) += digits[uint8_t(d[i]) & 0x0f];
+        }
+        return r;
+    }
+
+    std::string bytewise_base64(const char *d, size_t s) {
+        static const char *chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string r;
+        size_t i = 0;
+        for (; i + 3 <= s; i += 3) {
+            uint32_t g = uint32_t(uint8_t(d[i])) << 16 | uint32_t(uint8_t(d[i + 1])) << 8 | uint8_t(d[i + 2]);
+            r += chars[g >> 18], r += chars[(g >> 12) & 63], r += chars[(g >> 6) & 63], r += chars[g & 63];
+        }
+        return r;
+    }
+
+    /// runs f() over about total_bytes of input and prints the throughput in MB/s
+    template<typename F>
+    void measure(const char *name, size_t size, size_t total_bytes, F &&f) {
+        size_t rounds = std::max<size_t>(1, total_bytes / size);
+        size_t sink = 0;
+        auto start = clock_type::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            sink += f();
+        }
+        double seconds = seconds_since(start);
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(1) << rounds * size / seconds / 1e6 << " MB/s" << (sink ? "" : " ") << "\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t total = (argc > 1 ? std::atoi(argv[1]) : 64) * size_t(1000000);
+
+    for (size_t size : {32u, 65u, 256u, 4096u, 65536u}) {
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = char(i * 131 + 7);
+        }
+        const std::string hex = fc::to_hex(data);
+        const std::string b64 = fc::base64_encode(data.data(), data.size());
+        std::vector<char> chars(2 * size + 4), bytes(size + 4);
+
+        std::cout << size << " bytes\n";
+        measure("hex bytewise", size, total, [&] { return bytewise_to_hex(data.data(), size).size(); });
+        measure("to_hex string", size, total, [&] { return fc::to_hex(data.data(), size).size(); });
+        measure("to_hex buffer", size, total, [&] { fc::to_hex(data.data(), size, chars.data()); return size_t(chars[0]); });
+        measure("from_hex buffer", size, total, [&] { return fc::from_hex(hex.data(), hex.size(), bytes.data(), size); });
+        measure("base64 bytewise", size, total, [&] { return bytewise_base64(data.data(), size).size(); });
+        measure("base64_encode string", size, total, [&] { return fc::base64_encode(data.data(), size).size(); });
+        measure("base64_encode buffer", size, total, [&] { return fc::base64_encode(data.data(), size, chars.data()); });
+        measure("base64_decode string", size, total, [&] { return fc::base64_decode(b64).size(); });
+        measure("base64_decode buffer", size, total, [&] { return fc::base64_decode(b64.data(), b64.size(), bytes.data()); });
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/array.hpp>
+#include <fc/crypto/city.hpp>
+#include <fc/crypto/crc32c.hpp>
+
+#include "../../src/crypto/_cpu_features.hpp"
+#include "../../src/crypto/_crc32c.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+   uint32_t crc32c_bitwise(const char *data, size_t len, uint32_t crc = 0) {
+      crc = ~crc;
+      while (len--) {
+         crc ^= uint8_t(*data++);
+         for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0x82f63b78 & (0u - (crc & 1)));
+         }
+      }
+      return ~crc;
+   }
+
+   std::vector<char> make_data(size_t len) {
+      std::vector<char> data(len);
+      for (size_t i = 0; i < len; ++i) {
+         data[i] = char(i * 7 + 3);
+      }
+      return data;
+   }
+
+   // values of the software CityHashCrc256 the hardware paths replaced, on make_data(5000)
+   struct city_vector {
+      size_t len;
+      uint64_t hash[4];
+   };
+   const city_vector city_vectors[] = {
+      { 0, { 0xaa1ec54247c4fe33ULL, 0x437411c15e616471ULL, 0x35e8db37b1d6b8fbULL, 0x7e33275d6e95d22fULL } },
+      { 64, { 0x772d0dcf89b3bfe0ULL, 0x08b7fd8fbc43e28cULL, 0x02108183cb1b6f5bULL, 0x01ad2e3800440659ULL } },
+      { 239, { 0x17bc9e03ff754467ULL, 0xfccf7d5ac5cdc187ULL, 0x3c1948954200b0a9ULL, 0x397f050816e5e9f7ULL } },
+      { 240, { 0x8baf0a7821252f13ULL, 0x243e211d822836e0ULL, 0x388de46fc30ec98eULL, 0x1b1c09f7469302f5ULL } },
+      { 1000, { 0xb3f5f08443387c3aULL, 0x31442182079d51cdULL, 0xed6a1bcd7605a2caULL, 0x30fec6a4954218b0ULL } },
+      { 5000, { 0x080448e05a326b75ULL, 0x01c51506742e351eULL, 0xf2272b0c69eac737ULL, 0xb40194aadb46357cULL } },
+   };
+
+   /// every engine compiled in that this CPU can run; fc::crc32c() uses only one of them
+   std::vector<fc::detail::crc32c_engine> runnable_engines() {
+      std::vector<fc::detail::crc32c_engine> engines;
+      engines.push_back({ &fc::detail::crc32c_update_portable, &fc::detail::city_hash_crc256_portable, "portable" });
+      const fc::detail::cpu_features &cpu = fc::detail::get_cpu_features();
+#if defined(__x86_64__) || defined(_M_X64)
+      if (cpu.sse42) {
+         engines.push_back({ &fc::detail::crc32c_update_sse42, &fc::detail::city_hash_crc256_sse42, "sse4.2" });
+      }
+#elif defined(__aarch64__)
+      if (cpu.arm_crc32) {
+         engines.push_back({ &fc::detail::crc32c_update_armv8, &fc::detail::city_hash_crc256_armv8, "armv8-crc" });
+      }
+#endif
+      (void)cpu;
+      return engines;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(fc_crc32c)
+
+BOOST_AUTO_TEST_CASE(known_values) {
+   BOOST_TEST_MESSAGE("crc32c implementation: " << fc::crc32c_implementation());
+   BOOST_CHECK_EQUAL(fc::crc32c("", 0), 0u);
+   BOOST_CHECK_EQUAL(fc::crc32c("123456789", 9), 0xe3069283u);
+
+   // RFC 3720 B.4: 32 bytes of zeros and of ones
+   const std::string zeros(32, '\0'), ones(32, '\xff');
+   BOOST_CHECK_EQUAL(fc::crc32c(zeros.data(), zeros.size()), 0x8a9136aau);
+   BOOST_CHECK_EQUAL(fc::crc32c(ones.data(), ones.size()), 0x62a8ab43u);
+}
+
+BOOST_AUTO_TEST_CASE(lengths_and_alignment) {
+   // crosses the three stream thresholds of 3 * 256 and 3 * 8192 bytes
+   const std::vector<char> data = make_data(3 * 8192 * 2 + 100);
+   for (size_t len : {1, 7, 8, 9, 255, 767, 768, 769, 2000, 24575, 24576, 24577, 40000, 3 * 8192 * 2 + 36}) {
+      for (size_t offset = 0; offset < 9; ++offset) {
+         BOOST_CHECK_EQUAL(fc::crc32c(data.data() + offset, len), crc32c_bitwise(data.data() + offset, len));
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(chaining) {
+   const std::vector<char> data = make_data(30000);
+   const uint32_t whole = fc::crc32c(data.data(), data.size());
+   for (size_t cut : {0, 1, 13, 800, 8192, 25000, 30000}) {
+      const uint32_t head = fc::crc32c(data.data(), cut);
+      BOOST_CHECK_EQUAL(fc::crc32c(data.data() + cut, data.size() - cut, head), whole);
+   }
+   BOOST_CHECK_EQUAL(fc::crc32c(data.data(), 1000, 0x12345678), crc32c_bitwise(data.data(), 1000, 0x12345678));
+}
+
+BOOST_AUTO_TEST_CASE(city_hash_crc) {
+   const std::vector<char> data = make_data(5000);
+   for (const auto &v : city_vectors) {
+      const fc::array<uint64_t, 4> hash = fc::city_hash_crc_256(data.data(), v.len);
+      for (int i = 0; i < 4; ++i) {
+         BOOST_CHECK_EQUAL(hash.data[i], v.hash[i]);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(every_engine) {
+   const std::vector<char> data = make_data(3 * 8192 * 2 + 100);
+   for (const fc::detail::crc32c_engine &engine : runnable_engines()) {
+      BOOST_TEST_MESSAGE("crc32c engine: " << engine.name);
+      for (size_t len : {0, 1, 7, 9, 255, 767, 768, 769, 24575, 24576, 24577, 3 * 8192 * 2 + 36}) {
+         for (size_t offset : {0, 1, 5}) {
+            const uint8_t *p = reinterpret_cast<const uint8_t *>(data.data() + offset);
+            BOOST_CHECK_EQUAL(~engine.update(~0u, p, len), crc32c_bitwise(data.data() + offset, len));
+            BOOST_CHECK_EQUAL(~engine.update(~0x12345678u, p, len), crc32c_bitwise(data.data() + offset, len, 0x12345678));
+         }
+      }
+
+      for (const auto &v : city_vectors) {
+         uint64_t hash[4];
+         engine.city_hash_crc256(data.data(), v.len, hash);
+         for (int i = 0; i < 4; ++i) {
+            BOOST_CHECK_EQUAL(hash[i], v.hash[i]);
+         }
+      }
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
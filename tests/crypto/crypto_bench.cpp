@@ -0,0 +1,425 @@
+/**
+ *  Microbenchmarks of the fc crypto primitives: the hashes, hmac, AES, the text codecs,
+ *  city hash and crc32c, ECDSA signing and recovery, blind signatures and commitments
+ *  with their range proofs.  Every case is repeated until it has run for at least the
+ *  given time and is reported in operations per second, nanoseconds per operation and,
+ *  where an operation has an input of fixed size, bytes per second.
+ *
+ *  With --json the results, the ECC_IMPL the library was built with and the
+ *  implementations picked at run time are printed as one JSON object instead of a
+ *  table, to be kept and compared across builds.  A filter only runs the cases whose
+ *  name contains it, e.g. "sha256" or "ecc.".
+ *
+ *  usage: fc_crypto_bench [--json] [--time seconds] [filter]
+ */
+#include <fc/crypto/aes.hpp>
+#include <fc/crypto/base58.hpp>
+#include <fc/crypto/base64.hpp>
+#include <fc/crypto/city.hpp>
+#include <fc/crypto/crc32c.hpp>
+#include <fc/crypto/elliptic.hpp>
+#include <fc/crypto/hex.hpp>
+#include <fc/crypto/hmac.hpp>
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/crypto/sha1.hpp>
+#include <fc/crypto/sha224.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fc/crypto/sha512.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/sstream.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/chrono.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef FC_ECC_IMPL
+#define FC_ECC_IMPL "unknown"
+#endif
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start) {
+        return boost::chrono::duration_cast<boost::chrono::duration<double>>(clock_type::now() - start).count();
+    }
+
+    struct result {
+        std::string name;
+        uint64_t ops;
+        double seconds;
+        size_t bytes_per_op; ///< 0 if the operation has no input of fixed size
+    };
+
+    struct bench {
+        double min_seconds = 0.5;
+        std::string filter;
+        std::vector<result> results;
+
+        /// folds every output in, so that no operation can be optimized away
+        volatile uint64_t sink = 0;
+
+        template<typename T>
+        void consume(const T &value) {
+            uint64_t v = 0;
+            std::memcpy(&v, &value, std::min(sizeof(v), sizeof(value)));
+            sink += v;
+        }
+
+        /**
+         *  Runs f(n), which does n operations, with n doubling until one round takes at
+         *  least a tenth of min_seconds, then keeps running rounds of that size until
+         *  min_seconds have passed.
+         */
+        template<typename F>
+        void run(const std::string &name, size_t bytes_per_op, F &&f) {
+            if (name.find(filter) == std::string::npos) {
+                return;
+            }
+            uint64_t n = 1;
+            for (;;) {
+                auto start = clock_type::now();
+                f(n);
+                if (seconds_since(start) >= min_seconds / 10 || n >= (uint64_t(1) << 40)) {
+                    break;
+                }
+                n *= 2;
+            }
+            uint64_t ops = 0;
+            auto start = clock_type::now();
+            double seconds;
+            do {
+                f(n);
+                ops += n;
+                seconds = seconds_since(start);
+            } while (seconds < min_seconds);
+            results.push_back(result{name, ops, seconds, bytes_per_op});
+        }
+    };
+
+    std::vector<char> test_data(size_t size) {
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = char(i * 131 + (i >> 8));
+        }
+        return data;
+    }
+
+    void hash_benches(bench &b) {
+        for (size_t size : {64, 16384}) {
+            const std::vector<char> data = test_data(size);
+            const std::string suffix = "." + std::to_string(size);
+            b.run("sha1" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::sha1::hash(data.data(), data.size()));
+                }
+            });
+            b.run("sha224" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::sha224::hash(data.data(), data.size()));
+                }
+            });
+            b.run("sha256" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::sha256::hash(data.data(), data.size()));
+                }
+            });
+            b.run("sha512" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::sha512::hash(data.data(), data.size()));
+                }
+            });
+            b.run("ripemd160" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::ripemd160::hash(data.data(), data.size()));
+                }
+            });
+        }
+    }
+
+    void hmac_benches(bench &b) {
+        const std::vector<char> key = test_data(32), data = test_data(64);
+        b.run("hmac_sha256.64", data.size(), [&](uint64_t n) {
+            fc::hmac_sha256 mac;
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(mac.digest(key.data(), key.size(), data.data(), data.size()));
+            }
+        });
+        b.run("hmac_sha512.64", data.size(), [&](uint64_t n) {
+            fc::hmac_sha512 mac;
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(mac.digest(key.data(), key.size(), data.data(), data.size()));
+            }
+        });
+        const fc::keyed_hmac_sha256 keyed256(key.data(), key.size());
+        b.run("keyed_hmac_sha256.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(keyed256.digest(data.data(), data.size()));
+            }
+        });
+        const fc::keyed_hmac_sha512 keyed512(key.data(), key.size());
+        b.run("keyed_hmac_sha512.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(keyed512.digest(data.data(), data.size()));
+            }
+        });
+    }
+
+    void aes_benches(bench &b) {
+        const fc::sha512 key = fc::sha512::hash(std::string("bench key"));
+        for (size_t size : {64, 16384}) {
+            std::vector<char> plain = test_data(size);
+            std::vector<unsigned char> cipher(size + 16);
+            b.run("aes_encrypt." + std::to_string(size), size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::aes_encrypt((unsigned char *) plain.data(), plain.size(), (unsigned char *) &key,
+                                              (unsigned char *) &key + 32, cipher.data()));
+                }
+            });
+            const std::vector<char> encrypted = fc::aes_encrypt(key, plain);
+            b.run("aes_decrypt." + std::to_string(size), size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::aes_decrypt(key, encrypted).size());
+                }
+            });
+        }
+
+        const size_t stream_size = 4 << 20;
+        const std::string plain(stream_size, 'x');
+        const fc::sha256 stream_key = fc::sha256::hash(std::string("bench stream key"));
+        const std::pair<fc::aes_stream_mode, const char *> modes[] = {
+                {fc::aes_cbc, "aes_stream_cbc"}, {fc::aes_ctr, "aes_stream_ctr"}, {fc::aes_gcm, "aes_stream_gcm"}};
+        for (const auto &mode : modes) {
+            fc::aes_stream_encoder enc(mode.first);
+            b.run(std::string(mode.second) + ".4M", stream_size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    fc::stringstream in(plain), out;
+                    b.consume(enc.encode(in, out, stream_key, fc::uint128_t(i)));
+                }
+            });
+        }
+    }
+
+    void codec_benches(bench &b) {
+        const std::vector<char> data = test_data(64);
+        std::vector<char> text(256), bytes(256);
+
+        b.run("base58_encode.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::to_base58(data.data(), data.size(), text.data(), text.size()));
+            }
+        });
+        const std::string base58 = fc::to_base58(data.data(), data.size());
+        b.run("base58_decode.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::from_base58(base58, bytes.data(), bytes.size()));
+            }
+        });
+
+        b.run("base64_encode.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::base64_encode(data.data(), data.size(), text.data()));
+            }
+        });
+        const std::string base64 = fc::base64_encode(data.data(), data.size());
+        b.run("base64_decode.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::base64_decode(base64.data(), base64.size(), bytes.data()));
+            }
+        });
+
+        b.run("hex_encode.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                fc::to_hex(data.data(), data.size(), text.data());
+                b.consume(text[i % 128]);
+            }
+        });
+        const std::string hex = fc::to_hex(data);
+        b.run("hex_decode.64", data.size(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::from_hex(hex.data(), hex.size(), bytes.data(), bytes.size()));
+            }
+        });
+    }
+
+    void checksum_benches(bench &b) {
+        for (size_t size : {64, 16384}) {
+            const std::vector<char> data = test_data(size);
+            const std::string suffix = "." + std::to_string(size);
+            b.run("city_hash64" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::city_hash64(data.data(), data.size()));
+                }
+            });
+            b.run("city_hash_crc_128" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::city_hash_crc_128(data.data(), data.size()));
+                }
+            });
+            b.run("city_hash_crc_256" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::city_hash_crc_256(data.data(), data.size()));
+                }
+            });
+            b.run("crc32c" + suffix, size, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    b.consume(fc::crc32c(data.data(), data.size()));
+                }
+            });
+        }
+    }
+
+    void ecc_benches(bench &b) {
+        const fc::ecc::private_key key = fc::ecc::private_key::regenerate(fc::sha256::hash(std::string("bench key")));
+        std::vector<fc::sha256> digests;
+        for (int i = 0; i < 256; ++i) {
+            digests.push_back(fc::sha256::hash("bench digest " + std::to_string(i)));
+        }
+
+        b.run("ecc.get_public_key", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(key.get_public_key().serialize());
+            }
+        });
+        b.run("ecc.sign_compact", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(key.sign_compact(digests[i % digests.size()]));
+            }
+        });
+        std::vector<fc::ecc::compact_signature> signatures;
+        for (const auto &digest : digests) {
+            signatures.push_back(key.sign_compact(digest));
+        }
+        b.run("ecc.recover", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                const size_t j = i % digests.size();
+                b.consume(fc::ecc::public_key(signatures[j], digests[j]).serialize());
+            }
+        });
+
+        // Alice has Bob blindly sign a hash, as in elliptic.hpp
+        const auto alice = fc::ecc::extended_private_key::generate_master(std::string("bench alice"));
+        const auto bob = fc::ecc::extended_private_key::generate_master(std::string("bench bob"));
+        const fc::ecc::extended_public_key bob_pub = bob.get_extended_public_key();
+        b.run("ecc.blind_hash", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(alice.blind_hash(digests[i % digests.size()], 1));
+            }
+        });
+        const fc::ecc::blinded_hash blinded = alice.blind_hash(digests[0], 1);
+        b.run("ecc.blind_sign", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(bob.blind_sign(blinded, 1));
+            }
+        });
+        const fc::ecc::blind_signature blind_signature = bob.blind_sign(blinded, 1);
+        b.run("ecc.unblind_signature", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(alice.unblind_signature(bob_pub, blind_signature, digests[0], 1));
+            }
+        });
+
+        // confidential amounts of up to 2^32, as in range_proof_bench
+        const fc::sha256 blind = fc::sha256::hash(std::string("bench blind"));
+        const fc::sha256 nonce = fc::sha256::hash(std::string("bench nonce"));
+        b.run("ecc.blind", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::ecc::blind(blind, 1000 + i));
+            }
+        });
+        const fc::ecc::commitment_type commit = fc::ecc::blind(blind, 1000);
+        b.run("ecc.range_proof_sign", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                b.consume(fc::ecc::range_proof_sign(0, commit, blind, nonce, 0, 32, 1000).size());
+            }
+        });
+        const fc::ecc::range_proof_type proof = fc::ecc::range_proof_sign(0, commit, blind, nonce, 0, 32, 1000);
+        b.run("ecc.verify_range", 0, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                uint64_t min_val, max_val;
+                FC_ASSERT(fc::ecc::verify_range(min_val, max_val, commit, proof));
+                b.consume(max_val);
+            }
+        });
+    }
+
+    fc::mutable_variant_object implementations() {
+        return fc::mutable_variant_object()
+                ("ecc", FC_ECC_IMPL)
+                ("sha1", fc::sha1::implementation())
+                ("sha224", fc::sha224::implementation())
+                ("sha256", fc::sha256::implementation())
+                ("sha256_hash_many", fc::sha256::hash_many_implementation())
+                ("sha512", fc::sha512::implementation())
+                ("ripemd160", fc::ripemd160::implementation())
+                ("crc32c", fc::crc32c_implementation());
+    }
+
+    void print_json(const bench &b) {
+        fc::variants results;
+        for (const result &r : b.results) {
+            fc::mutable_variant_object item;
+            item("name", r.name)("ops", r.ops)("seconds", r.seconds)
+                    ("ops_per_sec", r.ops / r.seconds)("ns_per_op", r.seconds * 1e9 / r.ops);
+            if (r.bytes_per_op) {
+                item("bytes_per_op", uint64_t(r.bytes_per_op))("bytes_per_sec", r.ops * r.bytes_per_op / r.seconds);
+            }
+            results.push_back(item);
+        }
+        std::cout << fc::json::to_pretty_string(fc::mutable_variant_object()
+                ("implementations", implementations())
+                ("min_seconds", b.min_seconds)
+                ("results", results), fc::json::legacy_generator) << "\n";
+    }
+
+    void print_table(const bench &b) {
+        for (const auto &entry : implementations()) {
+            std::cout << entry.key() << ": " << entry.value().as_string() << "\n";
+        }
+        std::cout << std::left << std::setw(28) << "name" << std::right << std::setw(14) << "ops/s"
+                  << std::setw(14) << "ns/op" << std::setw(12) << "MB/s" << "\n";
+        for (const result &r : b.results) {
+            std::cout << std::left << std::setw(28) << r.name << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(14) << r.ops / r.seconds << std::setprecision(1) << std::setw(14)
+                      << r.seconds * 1e9 / r.ops;
+            if (r.bytes_per_op) {
+                std::cout << std::setw(12) << r.ops * r.bytes_per_op / r.seconds / 1e6;
+            }
+            std::cout << "\n";
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    bench b;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--time" && i + 1 < argc) {
+            b.min_seconds = std::atof(argv[++i]);
+        } else {
+            b.filter = arg;
+        }
+    }
+
+    hash_benches(b);
+    hmac_benches(b);
+    aes_benches(b);
+    codec_benches(b);
+    checksum_benches(b);
+    ecc_benches(b);
+
+    if (json) {
+        print_json(b);
+    } else {
+        print_table(b);
+    }
+    return 0;
+}
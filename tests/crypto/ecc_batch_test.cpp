@@ -0,0 +1,197 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/crypto/elliptic.hpp>
+#include <fc/crypto/recovery_cache.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(fc_ecc_batch)
+
+BOOST_AUTO_TEST_CASE(recover_batch_matches_single_recovery)
+{
+   fc::worker_pool pool(3);
+   std::vector<fc::ecc::signature_digest> items;
+   std::vector<fc::ecc::public_key_data> expected;
+   for (int i = 0; i < 100; ++i) {
+      auto key = fc::ecc::private_key::regenerate(fc::sha256::hash("key" + std::to_string(i)));
+      auto digest = fc::sha256::hash("message" + std::to_string(i));
+      items.emplace_back(key.sign_compact(digest), digest);
+      expected.push_back(key.get_public_key().serialize());
+   }
+
+   // a malformed recovery id and a non-canonical signature fail on their own
+   items[10].first.data[0] = 0;
+   items[20].first.data[33] |= 0x80;
+
+   auto results = fc::ecc::recover_batch(items, true, &pool);
+   BOOST_REQUIRE_EQUAL(results.size(), items.size());
+   for (size_t i = 0; i < items.size(); ++i) {
+      if (i == 10 || i == 20) {
+         BOOST_CHECK(!results[i].valid());
+         BOOST_CHECK_THROW(fc::ecc::public_key(items[i].first, items[i].second), fc::exception);
+      } else {
+         BOOST_REQUIRE(results[i].valid());
+         BOOST_CHECK(results[i].key == expected[i]);
+      }
+   }
+
+   // canonicality checks can be disabled like for the single-signature constructor
+   results = fc::ecc::recover_batch(items, false, &pool);
+   BOOST_CHECK(!results[10].valid());
+   BOOST_CHECK(results[20].valid());
+
+   BOOST_CHECK(fc::ecc::recover_batch(std::vector<fc::ecc::signature_digest>()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(recovery_cache_hits_and_evictions)
+{
+   auto key = fc::ecc::private_key::regenerate(fc::sha256::hash(std::string("cached key")));
+   std::vector<fc::ecc::signature_digest> items;
+   for (int i = 0; i < 64; ++i) {
+      auto digest = fc::sha256::hash("cached message" + std::to_string(i));
+      items.emplace_back(key.sign_compact(digest), digest);
+   }
+
+   BOOST_CHECK(!fc::ecc::recovery_cache::enabled());
+   fc::ecc::recovery_cache::enable(1024);
+   BOOST_CHECK(fc::ecc::recovery_cache::enabled());
+
+   for (int pass = 0; pass < 3; ++pass)
+      for (const auto& item : items)
+         BOOST_CHECK(fc::ecc::public_key(item.first, item.second) == key.get_public_key());
+   auto stats = fc::ecc::recovery_cache::get_stats();
+   BOOST_CHECK_EQUAL(stats.misses, 64u);
+   BOOST_CHECK_EQUAL(stats.hits, 128u);
+   BOOST_CHECK_EQUAL(stats.size, 64u);
+
+   // a cached signature still has to pass the canonicality check
+   auto non_canonical = items[0].first;
+   non_canonical.data[33] |= 0x80;
+   BOOST_CHECK_THROW(fc::ecc::public_key(non_canonical, items[0].second), fc::exception);
+
+   // a tiny cache stays within its capacity
+   fc::ecc::recovery_cache::enable(16);
+   for (const auto& item : items)
+      fc::ecc::public_key(item.first, item.second);
+   stats = fc::ecc::recovery_cache::get_stats();
+   BOOST_CHECK_LE(stats.size, stats.capacity);
+   BOOST_CHECK_GT(stats.evictions, 0u);
+
+   fc::ecc::recovery_cache::disable();
+   BOOST_CHECK_EQUAL(fc::ecc::recovery_cache::get_stats().size, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(decompressed_keys_behave_like_compressed_ones)
+{
+   fc::worker_pool pool(2);
+   std::vector<fc::ecc::public_key_data> data;
+   for (int i = 0; i < 50; ++i)
+      data.push_back(fc::ecc::private_key::regenerate(fc::sha256::hash("key" + std::to_string(i))).get_public_key());
+
+   auto keys = fc::ecc::decompress_batch(data, &pool);
+   BOOST_REQUIRE_EQUAL(keys.size(), data.size());
+   auto offset = fc::sha256::hash(std::string("offset"));
+   for (size_t i = 0; i < data.size(); ++i) {
+      fc::ecc::public_key plain(data[i]);
+      BOOST_CHECK(keys[i].key().serialize() == data[i]);
+      BOOST_CHECK(keys[i].serialize_ecc_point() == plain.serialize_ecc_point());
+      BOOST_CHECK(keys[i].add(offset) == plain.add(offset));
+      fc::ecc::decompressed_public_key copy = keys[i];
+      BOOST_CHECK(copy.child(offset) == plain.child(offset));
+   }
+
+   fc::ecc::public_key_data bad;
+   memset(bad.begin(), 0xff, bad.size());
+   bad.data[0] = 2;
+   BOOST_CHECK_THROW(fc::ecc::decompress_batch(&bad, 1, &pool), fc::exception);
+}
+
+BOOST_AUTO_TEST_CASE(sign_batch_matches_single_signing)
+{
+   std::vector<fc::ecc::private_key> keys;
+   std::vector<fc::sha256> digests;
+   for (int i = 0; i < 60; ++i) {
+      keys.push_back(fc::ecc::private_key::regenerate(fc::sha256::hash("signer" + std::to_string(i % 7))));
+      digests.push_back(fc::sha256::hash("transaction" + std::to_string(i)));
+   }
+
+   fc::worker_pool none(0), some(3);
+   auto sequential = fc::ecc::sign_compact_batch(keys, digests, true, &none);
+   auto parallel = fc::ecc::sign_compact_batch(keys, digests, true, &some);
+   BOOST_REQUIRE_EQUAL(sequential.size(), digests.size());
+   BOOST_REQUIRE_EQUAL(parallel.size(), digests.size());
+   for (size_t i = 0; i < digests.size(); ++i) {
+      BOOST_CHECK(sequential[i] == keys[i].sign_compact(digests[i]));
+      BOOST_CHECK(parallel[i] == sequential[i]);
+      // recovery also rejects non-canonical signatures
+      BOOST_CHECK(fc::ecc::public_key(parallel[i], digests[i]) == keys[i].get_public_key());
+   }
+
+   auto same_key = fc::ecc::sign_compact_batch(keys[0], digests, true, &some);
+   BOOST_REQUIRE_EQUAL(same_key.size(), digests.size());
+   for (size_t i = 0; i < digests.size(); ++i)
+      BOOST_CHECK(same_key[i] == keys[0].sign_compact(digests[i]));
+
+   // an empty key fails the batch, mismatched inputs are rejected up front
+   keys[30] = fc::ecc::private_key();
+   BOOST_CHECK_THROW(fc::ecc::sign_compact_batch(keys, digests, true, &some), fc::exception);
+   digests.pop_back();
+   BOOST_CHECK_THROW(fc::ecc::sign_compact_batch(keys, digests, true, &some), fc::assert_exception);
+   BOOST_CHECK(fc::ecc::sign_compact_batch(nullptr, nullptr, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(derivers_match_single_derivation)
+{
+   const char seed[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+   auto master = fc::ecc::extended_private_key::generate_master(seed, sizeof(seed));
+   fc::ecc::extended_private_key_deriver priv(master);
+   auto hardened = priv.derive_child(int(0x80000000));
+   BOOST_CHECK(hardened.serialize_extended() == master.derive_child(int(0x80000000)).serialize_extended());
+   BOOST_CHECK(fc::ecc::extended_private_key_deriver(hardened).derive_child(1).serialize_extended() ==
+               hardened.derive_child(1).serialize_extended());
+
+   fc::worker_pool pool(3);
+   auto master_pub = master.get_extended_public_key();
+   fc::ecc::extended_public_key_deriver pub(master_pub);
+   auto privs = priv.derive_children(0, 40, &pool);
+   auto pubs = pub.derive_children(0, 40, &pool);
+   BOOST_REQUIRE_EQUAL(privs.size(), 40u);
+   BOOST_REQUIRE_EQUAL(pubs.size(), 40u);
+   for (int i = 0; i < 40; ++i) {
+      BOOST_CHECK(privs[i].serialize_extended() == master.derive_child(i).serialize_extended());
+      BOOST_CHECK(pubs[i].serialize_extended() == master_pub.derive_child(i).serialize_extended());
+      BOOST_CHECK(pubs[i].serialize_extended() == privs[i].get_extended_public_key().serialize_extended());
+   }
+
+   auto hardened_range = priv.derive_children(int(0x80000000), 8, &pool);
+   for (int i = 0; i < 8; ++i)
+      BOOST_CHECK(hardened_range[i].serialize_extended() ==
+                  master.derive_child(int(0x80000000u + i)).serialize_extended());
+
+   BOOST_CHECK_THROW(pub.derive_child(int(0x80000000)), fc::assert_exception);
+   BOOST_CHECK_THROW(pub.derive_children(0x7ffffffe, 4), fc::assert_exception);
+   BOOST_CHECK(pub.derive_children(5, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(extended_keys_encode_as_bip32)
+{
+   // BIP32 test vector 1: the whole 78 byte key and its checksum are encoded
+   const char seed[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+   auto master = fc::ecc::extended_private_key::generate_master(seed, sizeof(seed));
+   BOOST_CHECK_EQUAL(master.str(), "xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkVvvNKmPGJxWUtg6LnF5kejMRNNU3TGtRBeJgk33yuGBxrMPHi");
+   BOOST_CHECK_EQUAL(master.get_extended_public_key().str(), "xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gZ29ESFjqJoCu1Rupje8YtGqsefD265TMg7usUDFdp6W1EGMcet8");
+   auto hardened = master.derive_child(int(0x80000000));
+   BOOST_CHECK_EQUAL(hardened.str(), "xprv9uHRZZhk6KAJC1avXpDAp4MDc3sQKNxDiPvvkX8Br5ngLNv1TxvUxt4cV1rGL5hj6KCesnDYUhd7oWgT11eZG7XnxHrnYeSvkzY7d2bhkJ7");
+   BOOST_CHECK_EQUAL(hardened.get_extended_public_key().str(), "xpub68Gmy5EdvgibQVfPdqkBBCHxA5htiqg55crXYuXoQRKfDBFA1WEjWgP6LHhwBZeNK1VTsfTFUHCdrfp1bgwQ9xv5ski8PX9rL2dZXvgGDnw");
+   BOOST_CHECK_EQUAL(hardened.derive_child(1).str(), "xprv9wTYmMFdV23N2TdNG573QoEsfRrWKQgWeibmLntzniatZvR9BmLnvSxqu53Kw1UmYPxLgboyZQaXwTCg8MSY3H2EU4pWcQDnRnrVA1xe8fs");
+
+   BOOST_CHECK(fc::ecc::extended_private_key::from_base58(master.str()).serialize_extended() ==
+               master.serialize_extended());
+   BOOST_CHECK(fc::ecc::extended_public_key::deserialize(hardened.get_extended_public_key().serialize_extended())
+                  .serialize_extended() == hardened.get_extended_public_key().serialize_extended());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+/**
+ *  Measures fc::equihash::proof::hash() in solver runs and proofs found per second,
+ *  for the chain parameters n = 140, k = 6 unless others are given, on a single
+ *  thread and on the default worker pool.  Each run uses a new seed, as a miner
+ *  would, so the proofs per second include the runs that find none.  The
+ *  proofs found are then verified one by one with proof::is_valid() and all
+ *  together with is_valid_batch().
+ *
+ *  usage: equihash_bench [runs] [n k]
+ */
+#include <fc/crypto/equihash.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <boost/chrono.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start) {
+        return boost::chrono::duration_cast<boost::chrono::duration<double>>(clock_type::now() - start).count();
+    }
+
+    void measure(const char *name, uint32_t n, uint32_t k, size_t runs, fc::worker_pool &pool,
+                 std::vector<fc::equihash::proof> &found) {
+        size_t proofs = 0;
+        auto start = clock_type::now();
+        for (size_t i = 0; i < runs; ++i) {
+            const fc::sha256 seed = fc::sha256::hash("equihash bench " + std::to_string(i));
+            const fc::equihash::proof p = fc::equihash::proof::hash(n, k, seed, &pool);
+            if (!p.inputs.empty()) {
+                FC_ASSERT(p.is_valid(true, true));
+                found.push_back(p);
+                ++proofs;
+            }
+        }
+        double seconds = seconds_since(start);
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(8) << runs / seconds << " runs/s " << std::setw(8) << proofs / seconds << " proofs/s ("
+                  << proofs << " of " << runs << ")\n";
+    }
+
+    template<typename F>
+    void measure_verify(const char *name, size_t count, F &&f) {
+        auto start = clock_type::now();
+        size_t valid = f();
+        double seconds = seconds_since(start);
+        FC_ASSERT(valid == count);
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << count / seconds << " proofs/s\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t runs = argc > 1 ? std::atoi(argv[1]) : 20;
+    uint32_t n = argc > 3 ? std::atoi(argv[2]) : 140;
+    uint32_t k = argc > 3 ? std::atoi(argv[3]) : 6;
+
+    fc::worker_pool single(0);
+    fc::worker_pool &pool = fc::worker_pool::get_default();
+
+    std::cout << "n = " << n << ", k = " << k << "\n";
+    std::vector<fc::equihash::proof> found;
+    measure("1 thread", n, k, runs, single, found);
+    measure((std::to_string(pool.size() + 1) + " threads").c_str(), n, k, runs, pool, found);
+    if (found.empty()) {
+        return 0;
+    }
+
+    std::vector<fc::equihash::proof> proofs;
+    while (proofs.size() < 20000) {
+        proofs.insert(proofs.end(), found.begin(), found.end());
+    }
+    std::cout << "verification of " << proofs.size() << " proofs\n";
+    measure_verify("is_valid", proofs.size(), [&] {
+        return std::count_if(proofs.begin(), proofs.end(), [](const fc::equihash::proof &p) { return p.is_valid(true, true); });
+    });
+    measure_verify("is_valid_batch", proofs.size(), [&] {
+        std::vector<bool> valid = fc::equihash::is_valid_batch(proofs, true, true);
+        return std::count(valid.begin(), valid.end(), true);
+    });
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/crypto/equihash.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <equihash/pow.hpp>
+
+#include <string>
+
+namespace {
+   /// the proof the vendored single-threaded solver finds, as proof::hash() used to
+   std::vector<uint32_t> reference_inputs(uint32_t n, uint32_t k, const fc::sha256 &seed) {
+      // the seed folding of src/crypto/equihash.cpp
+      _POW::Seed s;
+      s.v[0] = uint32_t(seed._hash[0]) ^ uint32_t(seed._hash[2]);
+      s.v[1] = uint32_t(seed._hash[0] >> 32) ^ uint32_t(seed._hash[2] >> 32);
+      s.v[2] = uint32_t(seed._hash[1]) ^ uint32_t(seed._hash[3]);
+      s.v[3] = uint32_t(seed._hash[1] >> 32) ^ uint32_t(seed._hash[3] >> 32);
+      return _POW::Equihash(n, k, s).FindProof(2).inputs;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(fc_equihash)
+
+BOOST_AUTO_TEST_CASE(same_proofs_as_reference_solver) {
+   fc::worker_pool pool(3);
+   struct {
+      uint32_t n, k;
+   } const params[] = {{48, 5}, {60, 4}, {36, 3}, {30, 2}, {40, 1}};
+   size_t found = 0;
+   for (const auto &param : params) {
+      for (int i = 0; i < 8; ++i) {
+         const fc::sha256 seed = fc::sha256::hash("equihash " + std::to_string(param.n) + " " + std::to_string(i));
+         const fc::equihash::proof p = fc::equihash::proof::hash(param.n, param.k, seed, &pool);
+         BOOST_CHECK(p.inputs == reference_inputs(param.n, param.k, seed));
+         if (!p.inputs.empty()) {
+            ++found;
+            BOOST_CHECK(p.is_valid(true, true));
+         }
+      }
+   }
+   BOOST_CHECK_GT(found, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(independent_of_thread_count) {
+   fc::worker_pool none(0), some(5);
+   for (int i = 0; i < 4; ++i) {
+      const fc::sha256 seed = fc::sha256::hash("threads " + std::to_string(i));
+      const fc::equihash::proof a = fc::equihash::proof::hash(60, 4, seed, &none);
+      const fc::equihash::proof b = fc::equihash::proof::hash(60, 4, seed, &some);
+      BOOST_CHECK(a.inputs == b.inputs);
+   }
+}
+
+BOOST_AUTO_TEST_CASE(batch_verification) {
+   std::vector<fc::equihash::proof> proofs;
+   for (int i = 0; proofs.size() < 12; ++i) {
+      const fc::sha256 seed = fc::sha256::hash("batch " + std::to_string(i));
+      fc::equihash::proof p = fc::equihash::proof::hash(i % 2 ? 60 : 36, i % 2 ? 4 : 3, seed);
+      if (p.inputs.empty()) {
+         continue;
+      }
+      proofs.push_back(p);
+
+      // broken copies: another index, not canonical, a repeated index, too short, other parameters
+      fc::equihash::proof q = p;
+      q.inputs.back() ^= 1;
+      proofs.push_back(q);
+      q = p;
+      std::swap(q.inputs[0], q.inputs[1]);
+      proofs.push_back(q);
+      q = p;
+      q.inputs[2] = q.inputs[3] = q.inputs[0];
+      proofs.push_back(q);
+      q = p;
+      q.inputs.resize(q.inputs.size() / 2);
+      proofs.push_back(q);
+      q = p;
+      q.n += q.k + 1;
+      proofs.push_back(q);
+   }
+   fc::equihash::proof empty = proofs[0];
+   empty.inputs.clear();
+   proofs.push_back(empty);
+   fc::equihash::proof large_k = proofs[0];
+   large_k.k = 9;
+   proofs.push_back(large_k);
+
+   fc::worker_pool pool(3);
+   for (int flags = 0; flags < 4; ++flags) {
+      const bool canonical = flags & 1, zeros = flags & 2;
+      const std::vector<bool> valid = fc::equihash::is_valid_batch(proofs, canonical, zeros, &pool);
+      BOOST_REQUIRE_EQUAL(valid.size(), proofs.size());
+      for (size_t i = 0; i + 1 < proofs.size(); ++i) {
+         BOOST_CHECK_EQUAL(valid[i], proofs[i].is_valid(canonical, zeros));
+      }
+      BOOST_CHECK(!valid.back());
+   }
+   BOOST_CHECK(fc::equihash::is_valid_batch(nullptr, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(invalid_parameters) {
+   const fc::sha256 seed = fc::sha256::hash(std::string("params"));
+   BOOST_CHECK_THROW(fc::equihash::proof::hash(48, 0, seed), fc::assert_exception);
+   BOOST_CHECK_THROW(fc::equihash::proof::hash(200, 8, seed), fc::assert_exception);
+   BOOST_CHECK_THROW(fc::equihash::proof::hash(4, 5, seed), fc::assert_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/crypto/merkle_tree.hpp>
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+   template<typename Digest>
+   std::vector<Digest> make_leaves(size_t count, const std::string &salt = "leaf") {
+      std::vector<Digest> leaves;
+      for (size_t i = 0; i < count; ++i) {
+         leaves.push_back(Digest::hash(salt + std::to_string(i)));
+      }
+      return leaves;
+   }
+
+   // the loop used by block headers for their transaction merkle root
+   template<typename Digest>
+   Digest reference_root(std::vector<Digest> ids) {
+      if (ids.empty()) {
+         return Digest();
+      }
+      while (ids.size() > 1) {
+         for (size_t i = 0; i < ids.size(); i += 2) {
+            ids[i / 2] = i + 1 < ids.size() ? Digest::hash(std::make_pair(ids[i], ids[i + 1])) : ids[i];
+         }
+         ids.resize((ids.size() + 1) / 2);
+      }
+      return ids.front();
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(fc_merkle_tree)
+
+BOOST_AUTO_TEST_CASE(root_matches_reference)
+{
+   for (size_t n = 0; n <= 70; ++n) {
+      auto leaves = make_leaves<fc::sha256>(n);
+      fc::merkle_tree<fc::sha256> tree(leaves);
+      BOOST_CHECK_EQUAL(std::string(tree.root()), std::string(reference_root(leaves)));
+
+      auto small = make_leaves<fc::ripemd160>(n);
+      fc::merkle_tree<fc::ripemd160> small_tree(small);
+      BOOST_CHECK_EQUAL(std::string(small_tree.root()), std::string(reference_root(small)));
+   }
+}
+
+BOOST_AUTO_TEST_CASE(incremental_updates)
+{
+   auto leaves = make_leaves<fc::sha256>(37);
+   fc::merkle_tree<fc::sha256> tree;
+   for (size_t i = 0; i < leaves.size(); ++i) {
+      tree.append(leaves[i]);
+      if (i % 5 == 0) {
+         BOOST_CHECK(tree.root() == reference_root(std::vector<fc::sha256>(leaves.begin(), leaves.begin() + i + 1)));
+      }
+   }
+   BOOST_CHECK(tree.root() == reference_root(leaves));
+
+   auto more = make_leaves<fc::sha256>(12, "more");
+   tree.append(more);
+   leaves.insert(leaves.end(), more.begin(), more.end());
+   for (size_t i = 0; i < leaves.size(); i += 7) {
+      leaves[i] = fc::sha256::hash("changed" + std::to_string(i));
+      tree.update(i, leaves[i]);
+      if (i % 2) {
+         BOOST_CHECK(tree.root() == reference_root(leaves));
+      }
+   }
+   BOOST_CHECK(tree.root() == reference_root(leaves));
+   BOOST_CHECK_THROW(tree.update(leaves.size(), fc::sha256()), fc::exception);
+}
+
+BOOST_AUTO_TEST_CASE(inclusion_proofs)
+{
+   for (size_t n : {1, 2, 3, 5, 8, 13, 33}) {
+      auto leaves = make_leaves<fc::sha256>(n);
+      fc::merkle_tree<fc::sha256> tree(leaves);
+      const fc::sha256 root = tree.root();
+      for (size_t i = 0; i < n; ++i) {
+         auto proof = tree.proof(i);
+         BOOST_CHECK(fc::merkle_tree<fc::sha256>::verify(leaves[i], proof, root));
+
+         // proofs survive serialization
+         auto copy = fc::raw::unpack<fc::merkle_proof<fc::sha256>>(fc::raw::pack(proof));
+         BOOST_CHECK(fc::merkle_tree<fc::sha256>::verify(leaves[i], copy, root));
+
+         BOOST_CHECK(!fc::merkle_tree<fc::sha256>::verify(fc::sha256::hash("other"), proof, root));
+         if (!proof.siblings.empty()) {
+            auto tampered = proof;
+            tampered.siblings.back() = fc::sha256::hash("other");
+            BOOST_CHECK(!fc::merkle_tree<fc::sha256>::verify(leaves[i], tampered, root));
+            tampered = proof;
+            tampered.siblings.pop_back();
+            BOOST_CHECK(!fc::merkle_tree<fc::sha256>::verify(leaves[i], tampered, root));
+         }
+         if (n > 1) {
+            auto moved = proof;
+            moved.index = (i + 1) % n;
+            BOOST_CHECK(!fc::merkle_tree<fc::sha256>::verify(leaves[i], moved, root));
+         }
+      }
+   }
+   fc::merkle_tree<fc::sha256> empty;
+   BOOST_CHECK_THROW(empty.proof(0), fc::exception);
+}
+
+BOOST_AUTO_TEST_CASE(large_tree_on_pool)
+{
+   fc::worker_pool pool(2);
+   auto leaves = make_leaves<fc::sha256>(5000);
+   fc::merkle_tree<fc::sha256> tree(leaves, &pool);
+   BOOST_CHECK(tree.root() == reference_root(leaves));
+
+   for (size_t i = 0; i < leaves.size(); i += 3) {
+      leaves[i] = fc::sha256::hash(leaves[i]);
+      tree.update(i, leaves[i]);
+   }
+   BOOST_CHECK(tree.root() == reference_root(leaves));
+   BOOST_CHECK(fc::merkle_tree<fc::sha256>::verify(leaves[4321], tree.proof(4321), tree.root()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+/**
+ *  Measures fc::rand_bytes() against calling OpenSSL's RAND_bytes() directly,
+ *  as fc::rand_bytes() used to, for nonce and key sized requests made by one
+ *  thread and by several threads at once, where RAND_bytes() contends on the
+ *  lock of the shared OpenSSL generator.
+ *
+ *  usage: rand_bench [calls per thread] [max threads]
+ */
+#include <fc/crypto/rand.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <openssl/rand.h>
+
+#include <boost/chrono.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start) {
+        return boost::chrono::duration_cast<boost::chrono::duration<double>>(clock_type::now() - start).count();
+    }
+
+    /// calls f(buf, size) `calls` times on each of `threads` threads and prints the total calls per second
+    template<typename F>
+    void measure(const char *name, size_t threads, size_t size, size_t calls, F &&f) {
+        fc::worker_pool pool(threads - 1);
+        auto start = clock_type::now();
+        pool.for_each_range(threads, [&](size_t begin, size_t end) {
+            char buf[256];
+            for (size_t t = begin; t < end; ++t) {
+                for (size_t i = 0; i < calls; ++i) {
+                    f(buf, int(size));
+                }
+            }
+        });
+        double seconds = seconds_since(start);
+        std::cout << "  " << std::left << std::setw(12) << name << std::right << std::setw(3) << threads
+                  << " threads " << std::setw(4) << size << " bytes " << std::setw(12) << std::fixed
+                  << std::setprecision(0) << threads * calls / seconds << " calls/s\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t calls = argc > 1 ? std::atoi(argv[1]) : 200000;
+    size_t max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(4u, boost::thread::hardware_concurrency());
+
+    for (size_t size : {16, 32, 256}) {
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            measure("RAND_bytes", threads, size, calls, [](char *buf, int len) {
+                RAND_bytes((unsigned char *) buf, len);
+            });
+            measure("rand_bytes", threads, size, calls, [](char *buf, int len) {
+                fc::rand_bytes(buf, len);
+            });
+        }
+    }
+    return 0;
+}
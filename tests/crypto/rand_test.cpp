@@ -1,8 +1,18 @@
 #include <boost/test/unit_test.hpp>
 
 #include <fc/crypto/rand.hpp>
+#include <fc/thread/worker_pool.hpp>
 
 #include <cmath>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
 
 static void check_randomness( const char* buffer, size_t len ) {
     if (len == 0) { return; }
@@ -24,6 +34,22 @@ static void check_randomness( const char* buffer, size_t len ) {
     BOOST_CHECK( rc > E - sigma && rc < E + sigma);
 }
 
+/// bit and run counts within 5 sigma, for buffers too large for check_randomness()
+static void check_balance( const char* buffer, size_t len ) {
+    size_t ones = 0, runs = 0;
+    unsigned int last = 2;
+    for (size_t k = 0; k < len; k++) {
+        for (int i = 0; i < 8; i++) {
+            unsigned int bit = (buffer[k] >> i) & 1;
+            ones += bit;
+            if (bit != last) { runs++; last = bit; }
+        }
+    }
+    double n = 8.0 * len;
+    BOOST_CHECK( std::fabs( ones - n / 2 ) < 5 * sqrt( n ) / 2 );
+    BOOST_CHECK( std::fabs( runs - (n + 1) / 2 ) < 5 * sqrt( n - 1 ) / 2 );
+}
+
 BOOST_AUTO_TEST_SUITE(fc_crypto)
 
 BOOST_AUTO_TEST_CASE(rand_test)
@@ -33,4 +59,59 @@ BOOST_AUTO_TEST_CASE(rand_test)
     check_randomness( buffer, sizeof(buffer) );
 }
 
+BOOST_AUTO_TEST_CASE(rand_sizes)
+{
+    // requests across the refills of the per thread buffer
+    std::vector<char> large( 100000 );
+    fc::rand_bytes( large.data(), int(large.size()) );
+    check_balance( large.data(), large.size() );
+
+    std::set<std::string> seen;
+    for( int size = 1; size <= 2000; size += 37 )
+    {
+        std::string s( size, 0 );
+        fc::rand_bytes( &s[0], size );
+        if( size >= 8 )
+            BOOST_CHECK( seen.insert( s.substr( 0, 8 ) ).second );
+    }
+    fc::rand_bytes( nullptr, 0 );
+}
+
+BOOST_AUTO_TEST_CASE(rand_threads)
+{
+    // every thread has its own generator, none may repeat another
+    fc::worker_pool pool( 3 );
+    std::vector<std::string> out( 64, std::string( 32, 0 ) );
+    pool.for_each_range( out.size(), [&]( size_t begin, size_t end ) {
+        for( size_t i = begin; i < end; ++i )
+            fc::rand_bytes( &out[i][0], 32 );
+    } );
+    BOOST_CHECK_EQUAL( std::set<std::string>( out.begin(), out.end() ).size(), out.size() );
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(rand_fork)
+{
+    char parent[32], child[32];
+    fc::rand_bytes( parent, sizeof(parent) );
+
+    int fds[2];
+    BOOST_REQUIRE_EQUAL( pipe( fds ), 0 );
+    pid_t pid = fork();
+    BOOST_REQUIRE( pid >= 0 );
+    if( pid == 0 )
+    {
+        fc::rand_bytes( child, sizeof(child) );
+        _exit( write( fds[1], child, sizeof(child) ) == sizeof(child) ? 0 : 1 );
+    }
+    close( fds[1] );
+    fc::rand_bytes( parent, sizeof(parent) );
+    BOOST_REQUIRE_EQUAL( read( fds[0], child, sizeof(child) ), ssize_t(sizeof(child)) );
+    close( fds[0] );
+    int status = 0;
+    waitpid( pid, &status, 0 );
+    BOOST_CHECK( memcmp( parent, child, sizeof(child) ) != 0 );
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
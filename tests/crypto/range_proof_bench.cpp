@@ -0,0 +1,64 @@
+/**
+ *  Measures range proof verification throughput, one proof at a time with
+ *  fc::ecc::verify_range() on the calling thread and through
+ *  fc::ecc::verify_range_batch() with worker pools of increasing size.
+ *
+ *  usage: range_proof_bench [proofs] [max_threads]
+ */
+#include <fc/crypto/elliptic.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <boost/chrono.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    void report(const std::string &name, size_t count, clock_type::duration elapsed) {
+        double seconds = boost::chrono::duration_cast<boost::chrono::duration<double>>(elapsed).count();
+        std::cout << name << ": " << count << " proofs in " << seconds * 1000 << "ms, "
+                  << uint64_t(count / seconds) << " proofs/sec\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t count = argc > 1 ? std::atoi(argv[1]) : 500;
+    uint32_t max_threads = argc > 2 ? std::atoi(argv[2]) : boost::thread::hardware_concurrency();
+
+    // proofs as confidential transfers carry them, hiding amounts of up to 2^32
+    std::vector<fc::ecc::commitment_range_proof> items;
+    items.reserve(count);
+    const auto nonce = fc::sha256::hash(std::string("bench nonce"));
+    for (size_t i = 0; i < count; ++i) {
+        auto blind = fc::sha256::hash("bench blind " + std::to_string(i));
+        uint64_t value = 1000 + i;
+        auto commit = fc::ecc::blind(blind, value);
+        items.emplace_back(commit, fc::ecc::range_proof_sign(0, commit, blind, nonce, 0, 32, value));
+    }
+
+    auto start = clock_type::now();
+    size_t valid = 0;
+    for (const auto &item : items) {
+        uint64_t min_val, max_val;
+        valid += fc::ecc::verify_range(min_val, max_val, item.first, item.second);
+    }
+    report("serial", count, clock_type::now() - start);
+    FC_ASSERT(valid == count);
+
+    // a pool of n threads plus the calling thread keeps n + 1 cores busy
+    for (uint32_t cores = 1; cores <= std::max(max_threads, 1u); ++cores) {
+        fc::worker_pool pool(cores - 1);
+        start = clock_type::now();
+        auto results = fc::ecc::verify_range_batch(items, &pool);
+        report("verify_range_batch, " + std::to_string(cores) + " cores", results.size(), clock_type::now() - start);
+        FC_ASSERT(std::all_of(results.begin(), results.end(),
+                              [](const fc::ecc::range_proof_result &r) { return r.valid; }));
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ *  Measures public key recovery throughput from compact signatures, one at a
+ *  time on the calling thread and through fc::ecc::recover_batch() with worker
+ *  pools of increasing size.
+ *
+ *  usage: ecc_recover_bench [signatures] [max_threads]
+ */
+#include <fc/crypto/elliptic.hpp>
+#include <fc/thread/worker_pool.hpp>
+
+#include <boost/chrono.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    void report(const std::string &name, size_t count, clock_type::duration elapsed) {
+        double seconds = boost::chrono::duration_cast<boost::chrono::duration<double>>(elapsed).count();
+        std::cout << name << ": " << count << " signatures in " << seconds * 1000 << "ms, "
+                  << uint64_t(count / seconds) << " sigs/sec\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    uint32_t max_threads = argc > 2 ? std::atoi(argv[2]) : boost::thread::hardware_concurrency();
+
+    std::vector<fc::ecc::signature_digest> items;
+    items.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto key = fc::ecc::private_key::regenerate(fc::sha256::hash("bench key " + std::to_string(i % 64)));
+        auto digest = fc::sha256::hash("bench message " + std::to_string(i));
+        items.emplace_back(key.sign_compact(digest), digest);
+    }
+
+    auto start = clock_type::now();
+    for (const auto &item : items) {
+        fc::ecc::public_key(item.first, item.second);
+    }
+    report("serial", count, clock_type::now() - start);
+
+    // a pool of n threads plus the calling thread keeps n + 1 cores busy
+    for (uint32_t cores = 2; cores <= max_threads; ++cores) {
+        fc::worker_pool pool(cores - 1);
+        start = clock_type::now();
+        auto results = fc::ecc::recover_batch(items, true, &pool);
+        report("recover_batch, " + std::to_string(cores) + " cores", results.size(), clock_type::now() - start);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ *  Compares hashing many independent messages one at a time with
+ *  fc::sha256::hash() against fc::sha256::hash_many(), for message sizes
+ *  typical of transactions, operations and merkle nodes, and feeding the
+ *  encoder field by field, as fc::raw::pack does, against a single write.
+ *
+ *  usage: sha256_bench [messages] [rounds]
+ */
+#include <fc/crypto/sha256.hpp>
+
+#include <boost/chrono.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start) {
+        return boost::chrono::duration_cast<boost::chrono::duration<double>>(clock_type::now() - start).count();
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::cout << "hash_many implementation: " << fc::sha256::hash_many_implementation() << "\n";
+
+    // 64: merkle node, 120-250: transfers and votes, 500-2000: larger transactions
+    for (uint32_t size : {64u, 120u, 250u, 500u, 2000u}) {
+        std::vector<std::vector<char>> messages(count, std::vector<char>(size));
+        for (size_t i = 0; i < count; ++i) {
+            for (uint32_t j = 0; j < size; ++j) {
+                messages[i][j] = char(i * 7 + j);
+            }
+        }
+        std::vector<const char *> data;
+        std::vector<uint32_t> sizes;
+        for (const auto &m : messages) {
+            data.push_back(m.data());
+            sizes.push_back(m.size());
+        }
+        std::vector<fc::sha256> out(count);
+
+        auto start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = fc::sha256::hash(data[i], sizes[i]);
+            }
+        }
+        double one_by_one = seconds_since(start);
+
+        start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) {
+            fc::sha256::hash_many(data.data(), sizes.data(), count, out.data());
+        }
+        double many = seconds_since(start);
+
+        double total = double(count) * rounds;
+        std::cout << size << " bytes: hash " << uint64_t(total / one_by_one) << " msg/s, "
+                  << "hash_many " << uint64_t(total / many) << " msg/s ("
+                  << uint64_t(total * size / many / 1e6) << " MB/s), speedup " << one_by_one / many << "x\n";
+    }
+
+    // a transaction-like message packed as 1, 2, 4 and 8 byte fields
+    static const uint32_t field_sizes[] = {8, 4, 1, 2, 8, 1, 4, 1, 8, 2};
+    std::vector<char> message(250);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = char(i);
+    }
+    fc::sha256 single, fields;
+    auto start = clock_type::now();
+    for (size_t i = 0; i < count * rounds; ++i) {
+        fc::sha256::encoder enc;
+        enc.write(message.data(), message.size());
+        single = enc.result();
+    }
+    double single_write = seconds_since(start);
+
+    start = clock_type::now();
+    for (size_t i = 0; i < count * rounds; ++i) {
+        fc::sha256::encoder enc;
+        size_t pos = 0;
+        for (size_t f = 0; pos < message.size(); f = (f + 1) % 10) {
+            uint32_t n = std::min<uint32_t>(field_sizes[f], message.size() - pos);
+            enc.write(message.data() + pos, n);
+            pos += n;
+        }
+        fields = enc.result();
+    }
+    double field_writes = seconds_since(start);
+    if (!(single == fields)) {
+        std::cerr << "field by field digest mismatch\n";
+        return 1;
+    }
+    std::cout << "250 bytes in one write " << uint64_t(count * rounds / single_write) << " msg/s, "
+              << "field by field " << uint64_t(count * rounds / field_writes) << " msg/s\n";
+    return 0;
+}
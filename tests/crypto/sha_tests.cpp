@@ -8,7 +8,13 @@
 #include <fc/crypto/sha512.hpp>
 #include <fc/exception/exception.hpp>
 
+#include "../../src/crypto/_cpu_features.hpp"
+#include "../../src/crypto/_sha256_lanes.hpp"
+
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <utility>
 
 // SHA test vectors taken from http://www.di-mgt.com.au/sha_testvectors.html
 static const std::string TEST1("abc");
@@ -84,6 +90,25 @@ void test_stream( ) {
     BOOST_CHECK( hash == other );
 }
 
+template<typename H>
+void test_split_writes( ) {
+    // every split of messages around one and two blocks, fed in pieces of 1 to 150 bytes
+    std::vector<char> message( 300 );
+    for (size_t i = 0; i < message.size(); i++) { message[i] = char( i * 7 + 3 ); }
+    for (size_t len = 0; len < message.size(); len++) {
+        H expected = H::hash( message.data(), len );
+        for (size_t piece = 1; piece <= 150; piece += 7) {
+            typename H::encoder enc;
+            for (size_t pos = 0; pos < len; pos += piece) {
+                enc.write( message.data() + pos, std::min( piece, len - pos ) );
+            }
+            BOOST_CHECK( enc.result() == expected );
+        }
+    }
+    BOOST_CHECK( std::string( H::implementation() ).size() > 0 );
+    BOOST_TEST_MESSAGE( "implementation: " << H::implementation() );
+}
+
 template void test_big<fc::ripemd160>( const std::string& expected );
 template void test_big<fc::sha1>( const std::string& expected );
 template void test_big<fc::sha224>( const std::string& expected );
@@ -157,6 +182,103 @@ BOOST_AUTO_TEST_CASE(sha256_test)
     BOOST_CHECK_EQUAL( "d61967f63c7dd183914a4ae452c9f6ad5d462ce3d277798075b107615c1a8a30", (std::string) fc::sha256::hash(fourth) );
 }
 
+// every padding case (tail of 0..63 bytes, one or two padding blocks) in every lane position
+static std::vector<std::vector<char>> hash_many_messages()
+{
+    init_5();
+    std::vector<std::vector<char>> messages;
+    for (int len = 0; len < 300; len++) {
+        std::vector<char> m( len );
+        for (int i = 0; i < len; i++) { m[i] = char( len * 31 + i ); }
+        messages.push_back( m );
+    }
+    messages.push_back( std::vector<char>( TEST5, TEST5 + 1000000 ) );
+    messages.push_back( std::vector<char>( TEST3.begin(), TEST3.end() ) );
+    return messages;
+}
+
+BOOST_AUTO_TEST_CASE(sha256_hash_many_test)
+{
+    const std::vector<std::vector<char>> messages = hash_many_messages();
+    std::vector<fc::sha256> digests = fc::sha256::hash_many( messages );
+    BOOST_REQUIRE_EQUAL( digests.size(), messages.size() );
+    for (size_t i = 0; i < messages.size(); i++) {
+        BOOST_CHECK( digests[i] == fc::sha256::hash( messages[i].data(), messages[i].size() ) );
+    }
+    BOOST_CHECK_EQUAL( "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", (std::string) digests.back() );
+    BOOST_CHECK( fc::sha256::hash_many( std::vector<std::vector<char>>() ).empty() );
+    BOOST_TEST_MESSAGE( "sha256::hash_many implementation: " << fc::sha256::hash_many_implementation() );
+}
+
+BOOST_AUTO_TEST_CASE(sha256_lane_kernels_test)
+{
+    // hash_many() runs only the kernel picked for this CPU, so run each one the CPU supports
+    std::vector<std::pair<fc::detail::sha256_many_fn, const char*>> kernels;
+    kernels.push_back( std::make_pair( &fc::detail::sha256_many_portable, "portable" ) );
+#if defined(__x86_64__) || defined(_M_X64)
+    const fc::detail::cpu_features& cpu = fc::detail::get_cpu_features();
+    if (cpu.sse2) { kernels.push_back( std::make_pair( &fc::detail::sha256_many_sse2, "sse2" ) ); }
+    if (cpu.avx2) { kernels.push_back( std::make_pair( &fc::detail::sha256_many_avx2, "avx2" ) ); }
+    if (cpu.avx512f) { kernels.push_back( std::make_pair( &fc::detail::sha256_many_avx512, "avx512" ) ); }
+#endif
+
+    const std::vector<std::vector<char>> messages = hash_many_messages();
+    std::vector<const char*> data;
+    std::vector<uint32_t> sizes;
+    std::vector<fc::sha256> expected;
+    for (const auto& m : messages) {
+        data.push_back( m.data() );
+        sizes.push_back( uint32_t( m.size() ) );
+        expected.push_back( fc::sha256::hash( m.data(), m.size() ) );
+    }
+
+    for (const auto& kernel : kernels) {
+        BOOST_TEST_MESSAGE( "sha256 lane kernel: " << kernel.second );
+        // fewer messages than lanes, and enough to refill every lane many times
+        for (size_t count : { size_t( 0 ), size_t( 1 ), size_t( 3 ), size_t( 17 ), messages.size() }) {
+            std::vector<uint8_t> out( 32 * count + 1, 0xa5 );
+            kernel.first( data.data(), sizes.data(), count, out.data() );
+            for (size_t i = 0; i < count; i++) {
+                BOOST_CHECK_MESSAGE( memcmp( out.data() + 32 * i, expected[i].data(), 32 ) == 0,
+                                     kernel.second << ": message " << i << " of " << count );
+            }
+            BOOST_CHECK_EQUAL( int( out.back() ), 0xa5 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(digest_split_writes_test)
+{
+    test_split_writes<fc::ripemd160>();
+    test_split_writes<fc::sha1>();
+    test_split_writes<fc::sha224>();
+    test_split_writes<fc::sha256>();
+    test_split_writes<fc::sha512>();
+}
+
+BOOST_AUTO_TEST_CASE(digest_pack_test)
+{
+    // many small fields of every width, as packed into the encoder by fc::raw
+    std::map<uint32_t, std::pair<uint16_t, std::string>> value;
+    for (uint32_t i = 0; i < 200; i++) {
+        value[i * 977] = std::make_pair( uint16_t( i * 3 ), std::string( i % 70, char( 'a' + i % 26 ) ) );
+    }
+    std::vector<std::pair<uint64_t, uint8_t>> small;
+    for (uint64_t i = 0; i < 100; i++) {
+        small.push_back( std::make_pair( i << 40, uint8_t( i ) ) );
+    }
+    auto packed = fc::raw::pack( std::make_pair( value, small ) );
+    BOOST_CHECK( fc::digest( std::make_pair( value, small ) ) == fc::sha256::hash( packed.data(), packed.size() ) );
+    fc::sha512::encoder enc512;
+    fc::raw::pack( enc512, std::make_pair( value, small ) );
+    BOOST_CHECK( enc512.result() == fc::sha512::hash( packed.data(), packed.size() ) );
+    BOOST_CHECK( fc::ripemd160::hash( std::make_pair( value, small ) ) == fc::ripemd160::hash( packed.data(), packed.size() ) );
+
+    fc::sha1::encoder enc;
+    for (char c : packed) { enc.put( c ); }
+    BOOST_CHECK( enc.result() == fc::sha1::hash( packed.data(), packed.size() ) );
+}
+
 BOOST_AUTO_TEST_CASE(sha512_test)
 {
     init_5();
@@ -7,6 +7,9 @@
 #include <fc/crypto/sha256.hpp>
 #include <fc/crypto/sha512.hpp>
 
+#include <algorithm>
+#include <vector>
+
 // See http://tools.ietf.org/html/rfc4231
 
 static const std::string TEST1_KEY  = "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b";
@@ -72,6 +75,33 @@ static fc::hmac<fc::sha224> mac_224;
 static fc::hmac<fc::sha256> mac_256;
 static fc::hmac<fc::sha512> mac_512;
 
+template<typename H>
+static void check_keyed( const char* key, uint32_t key_len, const char* data, uint32_t data_len, const std::string& expect )
+{
+    const fc::keyed_hmac<H> mac( key, key_len );
+    BOOST_CHECK_EQUAL( mac.digest( data, data_len ).str(), expect );
+    BOOST_CHECK_EQUAL( mac.digest( data, data_len ).str(), expect );
+
+    // written in pieces, across the inner block boundary for the longer messages
+    typename fc::keyed_hmac<H>::encoder enc( mac );
+    for( uint32_t i = 0; i < data_len; i += 7 )
+        enc.write( data + i, std::min<uint32_t>( 7, data_len - i ) );
+    BOOST_CHECK_EQUAL( enc.result().str(), expect );
+
+    // batches with messages of other lengths in between
+    std::vector<std::vector<char>> messages;
+    for( uint32_t i = 0; i < 3; ++i )
+    {
+        messages.emplace_back( data, data + data_len );
+        messages.emplace_back( data, data + data_len / ( i + 2 ) );
+    }
+    const std::vector<H> macs = mac.digest_many( messages );
+    BOOST_REQUIRE_EQUAL( macs.size(), messages.size() );
+    for( size_t i = 0; i < messages.size(); ++i )
+        BOOST_CHECK( macs[i] == fc::hmac<H>().digest( key, key_len, messages[i].data(), messages[i].size() ) );
+    BOOST_CHECK_EQUAL( macs[0].str(), expect );
+}
+
 template<int N,int M>
 static void run_test( const std::string& key, const std::string& data, const std::string& expect_224,
                       const std::string& expect_256, const std::string& expect_512 )
@@ -85,6 +115,10 @@ static void run_test( const std::string& key, const std::string& data, const std
     BOOST_CHECK_EQUAL( mac_224.digest( key_arr.begin(), N, data_arr.begin(), M ).str(), expect_224 );
     BOOST_CHECK_EQUAL( mac_256.digest( key_arr.begin(), N, data_arr.begin(), M ).str(), expect_256 );
     BOOST_CHECK_EQUAL( mac_512.digest( key_arr.begin(), N, data_arr.begin(), M ).str(), expect_512 );
+
+    check_keyed<fc::sha224>( key_arr.begin(), N, data_arr.begin(), M, expect_224 );
+    check_keyed<fc::sha256>( key_arr.begin(), N, data_arr.begin(), M, expect_256 );
+    check_keyed<fc::sha512>( key_arr.begin(), N, data_arr.begin(), M, expect_512 );
 }
 
 BOOST_AUTO_TEST_CASE(hmac_test_1)
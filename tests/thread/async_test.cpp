@@ -0,0 +1,217 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/thread/thread.hpp>
+#include <fc/thread/worker_pool.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(fc_async)
+
+BOOST_AUTO_TEST_CASE( post_runs_on_target_thread )
+{
+  fc::thread worker("worker");
+  fc::promise<fc::thread*>::ptr ran_on(new fc::promise<fc::thread*>("ran_on"));
+
+  worker.post([ran_on]() {
+    ran_on->set_value(&fc::thread::current());
+  }, "post_test");
+
+  BOOST_CHECK(ran_on->wait(fc::seconds(5)) == &worker);
+}
+
+BOOST_AUTO_TEST_CASE( post_releases_functor )
+{
+  std::shared_ptr<int> payload(std::make_shared<int>(42));
+  std::weak_ptr<int> weak_payload(payload);
+  {
+    fc::thread worker("worker");
+    fc::promise<void>::ptr done(new fc::promise<void>("done"));
+    worker.post([payload, done]() {
+      done->set_value();
+    }, "post_test");
+    payload.reset();
+    done->wait(fc::seconds(5));
+    // let the worker release the task after it finished running
+    worker.async([](){}, "flush").wait();
+  }
+  BOOST_CHECK(weak_payload.expired());
+}
+
+BOOST_AUTO_TEST_CASE( post_survives_throwing_functor )
+{
+  fc::thread worker("worker");
+  worker.post([]() { FC_THROW("posted functor failed"); }, "post_throw");
+  worker.post([]() { throw 42; }, "post_throw_int");
+  BOOST_CHECK_EQUAL(worker.async([]() { return 7; }, "after_throw").wait(fc::seconds(5)), 7);
+}
+
+BOOST_AUTO_TEST_CASE( cross_thread_task_recycling )
+{
+  fc::thread worker("worker");
+  std::vector<fc::future<int>> results;
+  for (int i = 0; i < 1000; ++i)
+    results.push_back(worker.async([i]() { return i * 2; }, "recycle_test"));
+  for (int i = 0; i < 1000; ++i)
+    BOOST_CHECK_EQUAL(results[i].wait(), i * 2);
+}
+
+BOOST_AUTO_TEST_CASE( async_batch_preserves_order )
+{
+  fc::thread worker("worker");
+  std::vector<int> order;
+  std::vector<std::function<int()>> functors;
+  for (int i = 0; i < 64; ++i)
+    functors.push_back([i, &order]() { order.push_back(i); return i; });
+
+  auto results = worker.async_batch(functors, "batch_test");
+  BOOST_REQUIRE_EQUAL(results.size(), 64u);
+  for (int i = 0; i < 64; ++i)
+    BOOST_CHECK_EQUAL(results[i].wait(), i);
+  for (int i = 0; i < 64; ++i)
+    BOOST_CHECK_EQUAL(order[i], i);
+}
+
+BOOST_AUTO_TEST_CASE( async_batch_priority )
+{
+  fc::thread worker("worker");
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  // blocks the worker's OS thread, so everything below is queued before anything runs
+  fc::future<void> held = worker.async([released]() { released.wait(); }, "hold the worker");
+
+  std::vector<int> order;
+  fc::future<void> normal = worker.async([&order]() { order.push_back(100); }, "normal");
+  std::vector<std::function<void()>> functors;
+  for (int i = 0; i < 3; ++i)
+    functors.push_back([i, &order]() { order.push_back(i); });
+  auto urgent = worker.async_batch(functors, "urgent", fc::priority::max());
+
+  release.set_value();
+  held.wait();
+  normal.wait();
+  for (auto& f : urgent)
+    f.wait();
+  BOOST_REQUIRE_EQUAL(order.size(), 4u);
+  BOOST_CHECK_EQUAL(order[0], 0);
+  BOOST_CHECK_EQUAL(order[1], 1);
+  BOOST_CHECK_EQUAL(order[2], 2);
+  BOOST_CHECK_EQUAL(order[3], 100);
+}
+
+BOOST_AUTO_TEST_CASE( spinning_idle_policy )
+{
+  fc::thread worker("worker");
+  worker.set_idle_policy(fc::idle_policy(1000, 10));
+  BOOST_CHECK_EQUAL(worker.get_idle_policy().spin_count, 1000u);
+  BOOST_CHECK_EQUAL(worker.get_idle_policy().yield_count, 10u);
+  for (int i = 0; i < 100; ++i)
+    BOOST_CHECK_EQUAL(worker.async([i]() { return i; }, "spin_test").wait(), i);
+  // timers must still fire while the worker polls
+  BOOST_CHECK_EQUAL(worker.async([]() { fc::usleep(fc::milliseconds(10)); return 1; }, "sleep_test").wait(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( then_runs_on_chosen_thread )
+{
+  fc::thread producer("producer");
+  fc::thread consumer("consumer");
+
+  fc::future<int> source = producer.async([]() { fc::usleep(fc::milliseconds(20)); return 20; }, "source");
+  fc::future<fc::thread*> continued = source.then(consumer, [](fc::future<int> f) {
+    BOOST_CHECK(f.ready());
+    BOOST_CHECK_EQUAL(f.wait(), 20);
+    return &fc::thread::current();
+  }, "continuation");
+  BOOST_CHECK(continued.wait(fc::seconds(5)) == &consumer);
+
+  // chaining onto an already completed future still runs the continuation
+  fc::future<int> chained = source.then(consumer, [](fc::future<int> f) { return f.wait() + 1; }, "late")
+                                  .then(producer, [](fc::future<int> f) { return f.wait() * 2; }, "chained");
+  BOOST_CHECK_EQUAL(chained.wait(fc::seconds(5)), 42);
+}
+
+BOOST_AUTO_TEST_CASE( then_propagates_exceptions )
+{
+  fc::thread worker("worker");
+  fc::future<void> failing = worker.async([]() { FC_THROW("expected failure"); }, "failing");
+  fc::future<bool> observed = failing.then(worker, [](fc::future<void> f) {
+    try { f.wait(); } catch (const fc::exception&) { return true; }
+    return false;
+  }, "observer");
+  BOOST_CHECK(observed.wait(fc::seconds(5)));
+}
+
+BOOST_AUTO_TEST_CASE( then_on_quit_thread_fails )
+{
+  fc::promise<int>::ptr source(new fc::promise<int>("source"));
+  fc::future<int> continued;
+  {
+    fc::thread consumer("consumer");
+    continued = fc::future<int>(source).then(consumer, [](fc::future<int> f) { return f.wait(); }, "orphan");
+  }
+  // the consumer has quit and its fc::thread is gone by the time the source completes
+  source->set_value(1);
+  BOOST_CHECK_THROW(continued.wait(fc::seconds(5)), fc::canceled_exception);
+}
+
+BOOST_AUTO_TEST_CASE( when_all_and_when_any )
+{
+  fc::thread worker("worker");
+  std::vector<fc::promise<int>::ptr> promises;
+  std::vector<fc::future<int>> inputs;
+  for (int i = 0; i < 20; ++i) {
+    promises.push_back(fc::promise<int>::ptr(new fc::promise<int>("input")));
+    inputs.push_back(fc::future<int>(promises.back()));
+  }
+
+  fc::future<size_t> first = fc::when_any(inputs);
+  fc::future<int> sum = fc::when_all(inputs).then(worker, [inputs](fc::future<void>) {
+    int total = 0;
+    for (const auto& f : inputs) {
+      BOOST_CHECK(f.ready());
+      total += f.wait();
+    }
+    return total;
+  }, "aggregate");
+
+  promises[7]->set_value(7);
+  BOOST_CHECK_EQUAL(first.wait(fc::seconds(5)), 7u);
+  BOOST_CHECK(!sum.ready());
+
+  for (int i = 0; i < 20; ++i)
+    if (i != 7)
+      worker.post([i, promises]() { promises[i]->set_value(i); }, "complete_input");
+  BOOST_CHECK_EQUAL(sum.wait(fc::seconds(5)), 190);
+
+  std::vector<fc::future<int>> none;
+  BOOST_CHECK(fc::when_all(none).ready());
+  BOOST_CHECK_THROW(fc::when_any(none), fc::assert_exception);
+}
+
+BOOST_AUTO_TEST_CASE( worker_pool_ranges )
+{
+  fc::worker_pool pool(3);
+  BOOST_CHECK_EQUAL(pool.size(), 3u);
+
+  std::vector<int> hits(1001, 0);
+  pool.for_each_range(hits.size(), [&hits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      ++hits[i];
+  }, 10);
+  for (int h : hits)
+    BOOST_CHECK_EQUAL(h, 1);
+
+  // every range runs to completion before the first failure is rethrown
+  std::vector<int> done(8, 0);
+  BOOST_CHECK_THROW(pool.for_each_range(done.size(), [&done](size_t begin, size_t end) {
+    done[begin] = 1;
+    if (begin >= 4)
+      FC_THROW("range failure");
+  }, 2), fc::exception);
+  BOOST_CHECK_EQUAL(done[0] + done[2] + done[4] + done[6], 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
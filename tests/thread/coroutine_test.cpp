@@ -0,0 +1,84 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/thread/thread.hpp>
+#include <fc/thread/coroutine.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <future>
+
+// built as C++20 by tests/CMakeLists.txt when the compiler supports coroutines
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+BOOST_AUTO_TEST_SUITE(fc_coroutine)
+
+namespace {
+  fc::task_co<int> add_remote(fc::thread& worker) {
+    int a = co_await worker.async([]() { return 1; }, "a");
+    int b = co_await worker.async([]() { return 2; }, "b");
+    co_return a + b;
+  }
+
+  fc::task_co<fc::thread*> hop(fc::thread& target) {
+    co_await fc::resume_on(target);
+    co_return &fc::thread::current();
+  }
+
+  fc::task_co<void> nested(fc::thread& worker, int& out) {
+    out = co_await add_remote(worker) * 10;
+  }
+
+  fc::task_co<int> wait_forever(fc::promise<int>::ptr never) {
+    co_return co_await fc::future<int>(never);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( coroutine_tasks )
+{
+  fc::thread runner("runner");
+  fc::thread worker("worker");
+
+  BOOST_CHECK_EQUAL(add_remote(worker).start(runner).wait(fc::seconds(5)), 3);
+  BOOST_CHECK(hop(worker).start(runner).wait(fc::seconds(5)) == &worker);
+
+  int out = 0;
+  nested(worker, out).start(runner).wait(fc::seconds(5));
+  BOOST_CHECK_EQUAL(out, 30);
+}
+
+BOOST_AUTO_TEST_CASE( coroutine_cancellation )
+{
+  fc::thread runner("runner");
+  fc::promise<int>::ptr never(new fc::promise<int>("never"));
+  fc::promise<int>::ptr later(new fc::promise<int>("later"));
+
+  // hold the runner so the coroutine cannot begin before it is canceled
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future().share());
+  fc::future<void> held = runner.async([released]() { released.wait(); }, "hold the runner");
+  fc::future<int> canceled_early = wait_forever(never).start(runner);
+  canceled_early.cancel("test");
+  release.set_value();
+  held.wait();
+  BOOST_CHECK_THROW(canceled_early.wait(fc::seconds(5)), fc::canceled_exception);
+
+  fc::future<int> canceled_while_suspended = wait_forever(later).start(runner);
+  runner.async([](){}, "let the coroutine suspend").wait();
+  canceled_while_suspended.cancel("test");
+  later->set_value(1);
+  BOOST_CHECK_THROW(canceled_while_suspended.wait(fc::seconds(5)), fc::canceled_exception);
+}
+
+BOOST_AUTO_TEST_CASE( coroutine_thread_quits )
+{
+  fc::promise<int>::ptr later(new fc::promise<int>("later"));
+  fc::future<int> orphan;
+  {
+    fc::thread runner("runner");
+    orphan = wait_forever(later).start(runner);
+    runner.async([](){}, "let the coroutine suspend").wait();
+  }
+  later->set_value(1);
+  BOOST_CHECK_THROW(orphan.wait(fc::seconds(5)), fc::canceled_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
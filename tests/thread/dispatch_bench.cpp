@@ -0,0 +1,104 @@
+/**
+ *  Measures cross-thread task dispatch latency: the time between a producer
+ *  posting a task to an fc::thread and that task starting to run there,
+ *  for plain async(), async_batch() and the different idle policies.
+ *
+ *  usage: thread_dispatch_bench [iterations] [batch_size]
+ */
+#include <fc/thread/thread.hpp>
+
+#include <boost/chrono.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace {
+    typedef boost::chrono::steady_clock clock_type;
+
+    int64_t now_ns() {
+        return boost::chrono::duration_cast<boost::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+    }
+
+    void report(const char *name, std::vector<int64_t> &samples) {
+        std::sort(samples.begin(), samples.end());
+        auto pct = [&](double p) {
+            return samples[std::min(samples.size() - 1, size_t(p * samples.size()))];
+        };
+        std::cout << name << ": n=" << samples.size()
+                  << " p50=" << pct(0.50) << "ns"
+                  << " p90=" << pct(0.90) << "ns"
+                  << " p99=" << pct(0.99) << "ns"
+                  << " max=" << samples.back() << "ns\n";
+    }
+
+    /// one task at a time, waiting for each to finish so the worker goes idle in between
+    void bench_single(fc::thread &worker, int iterations, const char *name = "async (idle worker)") {
+        std::vector<int64_t> samples;
+        samples.reserve(iterations);
+        for (int i = 0; i < iterations; ++i) {
+            int64_t posted = now_ns();
+            int64_t started = worker.async([]() { return now_ns(); }, "bench").wait();
+            samples.push_back(started - posted);
+        }
+        report(name, samples);
+    }
+
+    /// bursts of tasks submitted back to back with async()
+    void bench_burst(fc::thread &worker, int iterations, int batch) {
+        std::vector<int64_t> samples;
+        samples.reserve(iterations);
+        for (int i = 0; i < iterations; i += batch) {
+            std::vector<fc::future<int64_t>> results;
+            std::vector<int64_t> posted;
+            for (int j = 0; j < batch; ++j) {
+                posted.push_back(now_ns());
+                results.push_back(worker.async([]() { return now_ns(); }, "bench"));
+            }
+            for (int j = 0; j < batch; ++j) {
+                samples.push_back(results[j].wait() - posted[j]);
+            }
+        }
+        report("async burst", samples);
+    }
+
+    /// the same bursts submitted through async_batch()
+    void bench_batch(fc::thread &worker, int iterations, int batch) {
+        std::vector<int64_t> samples;
+        samples.reserve(iterations);
+        std::vector<std::function<int64_t()>> functors(batch, []() { return now_ns(); });
+        for (int i = 0; i < iterations; i += batch) {
+            int64_t posted = now_ns();
+            auto results = worker.async_batch(functors, "bench");
+            for (auto &r : results) {
+                samples.push_back(r.wait() - posted);
+            }
+        }
+        report("async_batch", samples);
+    }
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int batch = argc > 2 ? std::atoi(argv[2]) : 32;
+
+    fc::thread worker("bench_worker");
+    fc::thread producer("bench_producer");
+
+    producer.async([&]() {
+        bench_single(worker, iterations);
+        bench_burst(worker, iterations, batch);
+        bench_batch(worker, iterations, batch);
+
+        worker.set_idle_policy(fc::idle_policy(2000));
+        bench_single(worker, iterations, "idle policy: spin 2000");
+        worker.set_idle_policy(fc::idle_policy(2000, 100));
+        bench_single(worker, iterations, "idle policy: spin 2000, yield 100");
+        worker.set_idle_policy(fc::idle_policy(0, 100));
+        bench_single(worker, iterations, "idle policy: yield 100");
+    }, "bench_driver").wait();
+
+    return 0;
+}